@@ -173,6 +173,7 @@ typedef enum
     FCEXP_LOCAL_DECL_SPLIT_GLOBAL_RA    = ( 0x1 << 0x9 ),
     FCEXP_QUICKTOKEN_ALLOC              = ( 0x1 << 0xa ),
     FCEXP_TOBE_DESIGNED                 = ( 0x1 << 0xb ),
+    FCEXP_TIER0                         = ( 0x1 << 0xc ),
 } FCEXP_FLAG_t;
 
 #endif // __IGC_H
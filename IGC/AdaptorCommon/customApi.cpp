@@ -83,6 +83,9 @@ static struct
 std::string g_shaderCorpusName;
 std::string g_shaderOutputFolder;
 std::string g_shaderOutputName;
+// In concurrent compile mode each build names its own dumps.
+thread_local std::string g_threadShaderOutputName;
+thread_local bool g_hasThreadShaderOutputName = false;
 
 }
 
@@ -353,6 +356,12 @@ namespace IGC
         void IGC_DEBUG_API_CALL SetShaderOutputName( OutputName name )
         {
 #if defined(IGC_DEBUG_VARIABLES)
+            if (IGC_IS_FLAG_ENABLED(EnableConcurrentCompile))
+            {
+                g_threadShaderOutputName = name;
+                g_hasThreadShaderOutputName = true;
+                return;
+            }
             g_shaderOutputName = name;
 #endif
         }
@@ -627,6 +636,10 @@ namespace IGC
         OutputName IGC_DEBUG_API_CALL GetShaderOutputName()
         {
 #if defined(IGC_DEBUG_VARIABLES)
+            if (g_hasThreadShaderOutputName)
+            {
+                return g_threadShaderOutputName.c_str();
+            }
             return g_shaderOutputName.c_str();
 #else
             return "";
@@ -637,5 +650,26 @@ namespace IGC
         {
             return g_cBuildInfo;
         }
+
+        static std::mutex g_telemetryLock;
+        static CompileTelemetryCallback g_telemetryCallback = nullptr;
+        static void* g_telemetryUserData = nullptr;
+
+        extern "C" void IGC_API_CALL SetCompileTelemetryCallback(CompileTelemetryCallback callback, void* userData)
+        {
+            std::lock_guard<std::mutex> lck(g_telemetryLock);
+            g_telemetryCallback = callback;
+            g_telemetryUserData = userData;
+        }
+
+        CompileTelemetryCallback GetCompileTelemetryCallback(void** userData)
+        {
+            std::lock_guard<std::mutex> lck(g_telemetryLock);
+            if (userData)
+            {
+                *userData = g_telemetryUserData;
+            }
+            return g_telemetryCallback;
+        }
     }
 }
@@ -35,6 +35,21 @@ SPDX-License-Identifier: MIT
 #   define IGC_DEBUG_API_CALL
 #endif
 
+// Api functions that are exported in all build configurations.
+#if defined( _WIN32 )
+#   if defined( IGC_EXPORTS )
+#       define IGC_API_CALL __declspec(dllexport)
+#   else
+#       define IGC_API_CALL __declspec(dllimport)
+#   endif
+#else
+#   if defined( IGC_EXPORTS )
+#       define IGC_API_CALL __attribute__((visibility("default")))
+#   else
+#       define IGC_API_CALL
+#   endif
+#endif
+
 namespace IGC
 {
     namespace Debug
@@ -270,5 +285,17 @@ namespace IGC
         /// Omits changelist and build number in _RELEASE builds
         inline VersionInfo GetVersionInfo() { return "CONFIGURATION: Release"; }
 #endif
+
+        /// Receives one JSON record per compile: coarse timers, per-pass
+        /// times and instruction deltas, retry and spill outcome. Called on
+        /// the compiling thread.
+        typedef void (*CompileTelemetryCallback)(const char* record, size_t size, void* userData);
+
+        /// Register (or, with nullptr, unregister) the telemetry callback.
+        /// Available in all build configurations.
+        extern "C" void IGC_API_CALL SetCompileTelemetryCallback(CompileTelemetryCallback callback, void* userData);
+
+        /// Return the registered telemetry callback and its user data
+        CompileTelemetryCallback GetCompileTelemetryCallback(void** userData);
     }
 }
@@ -73,6 +73,7 @@ THE SOFTWARE.
 
 #include <iostream>
 #include <fstream>
+#include <unordered_set>
 
 #include "Probe/Assertion.h"
 
@@ -1415,8 +1416,10 @@ private:
 
 class SPIRVToLLVM {
 public:
-  SPIRVToLLVM(Module *LLVMModule, SPIRVModule *TheSPIRVModule)
-    :M((IGCLLVM::Module*)LLVMModule), BM(TheSPIRVModule), DbgTran(BM, M, this){
+  SPIRVToLLVM(Module *LLVMModule, SPIRVModule *TheSPIRVModule,
+      bool LazyFunctions = false, IGC::ModuleMetaData *ModuleMD = nullptr)
+    :M((IGCLLVM::Module*)LLVMModule), BM(TheSPIRVModule), DbgTran(BM, M, this),
+     LazyFunctions(LazyFunctions), ModuleMD(ModuleMD) {
       if (M)
           Context = &M->getContext();
       else
@@ -1449,6 +1452,8 @@ public:
   std::vector<Value *> transValue(const std::vector<SPIRVValue *>&, Function *F,
       BasicBlock *, BoolAction Action = BoolAction::Promote);
   Function *transFunction(SPIRVFunction *F);
+  std::vector<SPIRVFunction *> collectRootFunctions();
+  std::unordered_set<SPIRVFunction *> collectReachableFunctions();
   bool transFPContractMetadata();
   bool transKernelMetadata();
   bool transNonTemporalMetadata(Instruction* I);
@@ -1519,6 +1524,11 @@ private:
   GlobalVariable *m_NamedBarrierVar;
   GlobalVariable *m_named_barrier_id;
   DICompileUnit* compileUnit = nullptr;
+  // Only translate functions reachable from the roots up front. Anything
+  // else is translated by transFunction() when it is first referenced.
+  bool LazyFunctions = false;
+  // If set, module metadata is handed back here rather than serialized.
+  IGC::ModuleMetaData *ModuleMD = nullptr;
 
   // These storages are used to prevent duplication of alias.scope/noalias
   // metadata
@@ -4434,8 +4444,19 @@ SPIRVToLLVM::translate() {
       transValue(BV, nullptr, nullptr, true, BoolAction::Noop);
   }
 
-  for (unsigned I = 0, E = BM->getNumFunctions(); I != E; ++I) {
-    transFunction(BM->getFunction(I));
+  if (LazyFunctions) {
+    // Keep module order so the output does not depend on the call graph
+    // walk.
+    auto Reachable = collectReachableFunctions();
+    for (unsigned I = 0, E = BM->getNumFunctions(); I != E; ++I) {
+      SPIRVFunction *BF = BM->getFunction(I);
+      if (Reachable.count(BF))
+        transFunction(BF);
+    }
+  } else {
+    for (unsigned I = 0, E = BM->getNumFunctions(); I != E; ++I) {
+      transFunction(BM->getFunction(I));
+    }
   }
   for(auto& funcs : FuncMap)
   {
@@ -4463,6 +4484,50 @@ SPIRVToLLVM::translate() {
   return true;
 }
 
+// Functions that must be translated even if nothing in the module calls
+// them: kernels, functions visible to other modules and functions that may
+// be called through a pointer.
+std::vector<SPIRVFunction *>
+SPIRVToLLVM::collectRootFunctions() {
+  std::vector<SPIRVFunction *> Roots;
+  for (unsigned I = 0, E = BM->getNumFunctions(); I != E; ++I) {
+    SPIRVFunction *BF = BM->getFunction(I);
+    if (BM->isEntryPoint(ExecutionModelKernel, BF->getId()) ||
+        BF->hasDecorate(DecorationReferencedIndirectlyINTEL) ||
+        (BF->getNumBasicBlock() != 0 &&
+         BF->getLinkageType() == LinkageTypeExport))
+      Roots.push_back(BF);
+  }
+  return Roots;
+}
+
+// Walk the SPIR-V call graph from the root functions. Functions only
+// referenced through function pointer constants are not followed; they are
+// translated on demand when the constant is translated.
+std::unordered_set<SPIRVFunction *>
+SPIRVToLLVM::collectReachableFunctions() {
+  std::vector<SPIRVFunction *> Worklist = collectRootFunctions();
+  std::unordered_set<SPIRVFunction *> Reachable(Worklist.begin(),
+                                                Worklist.end());
+  while (!Worklist.empty()) {
+    SPIRVFunction *BF = Worklist.back();
+    Worklist.pop_back();
+    for (size_t I = 0, E = BF->getNumBasicBlock(); I != E; ++I) {
+      SPIRVBasicBlock *BBB = BF->getBasicBlock(I);
+      for (size_t BI = 0, BE = BBB->getNumInst(); BI != BE; ++BI) {
+        SPIRVInstruction *BInst = BBB->getInst(BI);
+        if (BInst->getOpCode() != OpFunctionCall)
+          continue;
+        SPIRVFunction *Callee =
+            static_cast<SPIRVFunctionCall *>(BInst)->getFunction();
+        if (Reachable.insert(Callee).second)
+          Worklist.push_back(Callee);
+      }
+    }
+  }
+  return Reachable;
+}
+
 bool
 SPIRVToLLVM::transAddressingModel() {
   switch (BM->getAddressingModel()) {
@@ -4636,6 +4701,8 @@ SPIRVToLLVM::transKernelMetadata()
     {
         SPIRVFunction *BF = BM->getFunction(I);
         Function *F = static_cast<Function *>(getTranslatedValue(BF));
+        if (!F && LazyFunctions)
+            continue;
         IGC_ASSERT_MESSAGE(F, "Invalid translated function");
 
         // __attribute__((annotate("some_user_annotation"))) are passed via
@@ -4817,7 +4884,12 @@ SPIRVToLLVM::transKernelMetadata()
         KernelMDs->addOperand(Node);
     }
 
-    IGC::serialize(MD, M);
+    // Going through MDNodes is only needed when the module itself is the
+    // only channel to the consumer.
+    if (ModuleMD)
+        *ModuleMD = std::move(MD);
+    else
+        IGC::serialize(MD, M);
 
     return true;
 }
@@ -5042,7 +5114,9 @@ __attr_unused static void dumpSPIRVBC(const char* fname, const char* data, unsig
 
 bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
     std::string &ErrMsg,
-    std::unordered_map<uint32_t, uint64_t> *specConstants) {
+    std::unordered_map<uint32_t, uint64_t> *specConstants,
+    bool LazyFunctions,
+    IGC::ModuleMetaData *ModuleMD) {
   std::unique_ptr<SPIRVModule> BM( SPIRVModule::createSPIRVModule() );
   BM->setSpecConstantMap(specConstants);
   IS >> *BM;
@@ -5050,7 +5124,7 @@ bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
   if (Succeed) {
     BM->resolveUnknownStructFields();
     M = new Module("", C);
-    SPIRVToLLVM BTL(M, BM.get());
+    SPIRVToLLVM BTL(M, BM.get(), LazyFunctions, ModuleMD);
 
     if (!BTL.translate()) {
       BM->getError(ErrMsg);
@@ -22,12 +22,22 @@ See LICENSE.TXT for details.
 
 #include <unordered_map>
 
+namespace IGC {
+struct ModuleMetaData;
+}
+
 namespace igc_spv{
 // Loads SPIRV from istream and translate to LLVM module.
+// If LazyFunctions is set, only functions reachable from kernels, exported
+// functions and indirectly referenced functions are translated.
+// If ModuleMD is given, IGC module metadata is returned there instead of
+// being serialized into the module's IGCMetadata node.
 // Returns true if succeeds.
 bool ReadSPIRV(llvm::LLVMContext &C, std::istream &IS, llvm::Module *&M,
     std::string &ErrMsg,
-    std::unordered_map<uint32_t, uint64_t> *specConstants);
+    std::unordered_map<uint32_t, uint64_t> *specConstants,
+    bool LazyFunctions = false,
+    IGC::ModuleMetaData *ModuleMD = nullptr);
 
 }
 #endif
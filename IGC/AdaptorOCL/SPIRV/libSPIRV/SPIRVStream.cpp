@@ -55,11 +55,21 @@ namespace igc_spv{
 
 SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVFunction &F)
   :IS(InputStream), M(*F.getModule()), WordCount(0), OpCode(OpNop),
-   Scope(&F){}
+   Scope(&F), Span(getSpan(InputStream)){}
 
 SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVBasicBlock &BB)
   :IS(InputStream), M(*BB.getModule()), WordCount(0), OpCode(OpNop),
-   Scope(&BB){}
+   Scope(&BB), Span(getSpan(InputStream)){}
+
+void
+SPIRVDecoder::readWords(void *Dst, size_t NumWords) const {
+  if (!Span) {
+    IS.read(reinterpret_cast<char*>(Dst), NumWords * sizeof(SPIRVWord));
+    return;
+  }
+  if (!Span->readWords(Dst, NumWords))
+    IS.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+}
 
 void
 SPIRVDecoder::setScope(SPIRVEntry *TheScope) {
@@ -71,7 +81,7 @@ SPIRVDecoder::setScope(SPIRVEntry *TheScope) {
 template<>
 const SPIRVDecoder& DecodeBinary(const SPIRVDecoder& I, bool &V) {
    SPIRVWord W;
-   I.IS.read(reinterpret_cast<char*>(&W), sizeof(W));
+   I.readWords(&W, 1);
    V = (W == 0) ? false : true;
    return I;
 }
@@ -79,7 +89,7 @@ const SPIRVDecoder& DecodeBinary(const SPIRVDecoder& I, bool &V) {
 template<>
 const SPIRVDecoder&
 DecodeBinary(const SPIRVDecoder& I, SPIRVWord &V) {
-   I.IS.read(reinterpret_cast<char*>(&V), sizeof(V));
+   I.readWords(&V, 1);
    return I;
 }
 
@@ -130,10 +140,37 @@ SPIRV_DEF_DEC(OCLExtOpKind)
 SPIRV_DEF_DEC(OCLExtOpDbgKind)
 #undef SPIRV_DEF_DEC
 
+const SPIRVDecoder&
+operator>>(const SPIRVDecoder& I, std::vector<SPIRVWord> &V) {
+  if (!V.empty())
+    I.readWords(V.data(), V.size());
+  return I;
+}
+
 // Read a string with padded 0's at the end so that they form a stream of
 // words.
 const SPIRVDecoder&
 operator>>(const SPIRVDecoder&I, std::string& Str) {
+  if (I.Span) {
+    const char *Begin = I.Span->current();
+    size_t Avail = I.Span->available();
+    const char *End = static_cast<const char*>(std::memchr(Begin, '\0', Avail));
+    if (!End) {
+      Str.append(Begin, Avail);
+      I.Span->advance(Avail);
+      I.IS.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+      return I;
+    }
+    size_t Len = End - Begin;
+    Str.append(Begin, Len);
+    // The terminator and the padding up to the next word boundary.
+    size_t Padded = std::min((Len + 4) & ~size_t(3), Avail);
+    for (size_t Idx = Len; Idx < Padded; ++Idx)
+      IGC_ASSERT(Begin[Idx] == '\0' && "Invalid string in SPIRV");
+    I.Span->advance(Padded);
+    return I;
+  }
+
   uint64_t Count = 0;
   char Ch;
   while ((!I.IS.eof() && I.IS.get(Ch)) && Ch != '\0') {
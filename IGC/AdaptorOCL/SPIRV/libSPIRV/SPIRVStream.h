@@ -52,6 +52,7 @@ THE SOFTWARE.
 #include "SPIRVExtInst.h"
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <vector>
@@ -62,11 +63,84 @@ namespace igc_spv{
 class SPIRVFunction;
 class SPIRVBasicBlock;
 
+// Read-only stream buffer over a SPIR-V binary owned by the caller.
+// Reading the input through this buffer avoids copying it, and lets
+// SPIRVDecoder read words straight from memory instead of going through
+// std::istream::read for every word.
+class SPIRVSpanStreamBuf : public std::streambuf {
+public:
+  SPIRVSpanStreamBuf(const char *Data, size_t Size) {
+    char *Begin = const_cast<char *>(Data);
+    setg(Begin, Begin, Begin + Size);
+  }
+
+  size_t available() const { return egptr() - gptr(); }
+  const char *current() const { return gptr(); }
+
+  void advance(size_t Bytes) {
+    setg(eback(), gptr() + std::min(Bytes, available()), egptr());
+  }
+
+  // Copy NumWords words to Dst. Returns false, consuming the rest of the
+  // buffer, if not enough data is left.
+  bool readWords(void *Dst, size_t NumWords) {
+    size_t Bytes = NumWords * sizeof(SPIRVWord);
+    if (Bytes > available()) {
+      advance(available());
+      return false;
+    }
+    std::memcpy(Dst, gptr(), Bytes);
+    advance(Bytes);
+    return true;
+  }
+
+protected:
+  pos_type seekoff(off_type Off, std::ios_base::seekdir Dir,
+                   std::ios_base::openmode Which) override {
+    if (!(Which & std::ios_base::in))
+      return pos_type(off_type(-1));
+    off_type Base = 0;
+    if (Dir == std::ios_base::cur)
+      Base = gptr() - eback();
+    else if (Dir == std::ios_base::end)
+      Base = egptr() - eback();
+    off_type Pos = Base + Off;
+    if (Pos < 0 || Pos > egptr() - eback())
+      return pos_type(off_type(-1));
+    setg(eback(), eback() + Pos, egptr());
+    return pos_type(Pos);
+  }
+
+  pos_type seekpos(pos_type Pos, std::ios_base::openmode Which) override {
+    return seekoff(off_type(Pos), std::ios_base::beg, Which);
+  }
+};
+
+// std::istream reading from a SPIRVSpanStreamBuf. IGC is built without
+// RTTI, so the decoder finds the buffer through pword() instead of a
+// dynamic_cast on rdbuf().
+class SPIRVSpanStream : public std::istream {
+public:
+  SPIRVSpanStream(const char *Data, size_t Size)
+    : std::istream(nullptr), Buf(Data, Size) {
+    rdbuf(&Buf);
+    pword(getSpanIndex()) = &Buf;
+  }
+
+  static int getSpanIndex() {
+    static const int Index = std::ios_base::xalloc();
+    return Index;
+  }
+
+private:
+  SPIRVSpanStreamBuf Buf;
+};
+
 class SPIRVDecoder {
 public:
   SPIRVDecoder(std::istream& InputStream, SPIRVModule& Module)
     :IS(InputStream), M(Module), WordCount(0), OpCode(OpNop),
-     Scope(NULL){}
+     Scope(NULL), Span(getSpan(InputStream)){}
   SPIRVDecoder(std::istream& InputStream, SPIRVFunction& F);
   SPIRVDecoder(std::istream& InputStream, SPIRVBasicBlock &BB);
 
@@ -80,6 +154,18 @@ public:
   SPIRVWord WordCount;
   Op OpCode;
   SPIRVEntry *Scope; // A function or basic block
+  // Set if IS reads from memory through SPIRVSpanStreamBuf.
+  SPIRVSpanStreamBuf *Span;
+
+  // Read NumWords words into Dst, setting the stream state on failure like
+  // std::istream::read does.
+  void readWords(void *Dst, size_t NumWords) const;
+
+  static SPIRVSpanStreamBuf *getSpan(std::istream &InputStream) {
+    auto *Buf = static_cast<SPIRVSpanStreamBuf *>(
+        InputStream.pword(SPIRVSpanStream::getSpanIndex()));
+    return (Buf && Buf == InputStream.rdbuf()) ? Buf : nullptr;
+  }
 
   std::vector<SPIRVEntry*>
       getContinuedInstructions(const Op ContinuedOpCode);
@@ -120,6 +206,9 @@ operator>>(const SPIRVDecoder& I, std::vector<T> &V) {
   return I;
 }
 
+// Operand lists of ids and literals are decoded in one go.
+const SPIRVDecoder& operator>>(const SPIRVDecoder& I, std::vector<SPIRVWord> &V);
+
 template <typename T>
 const SPIRVDecoder&
 operator>>(const SPIRVDecoder& I, llvm::Optional<T>& V) {
@@ -87,6 +87,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/Optimizer/OpenCLPasses/KernelFunctionCloning.h"
 #include "Compiler/Legalizer/TypeLegalizerPass.h"
 #include "Compiler/Optimizer/OpenCLPasses/ClampLoopUnroll/ClampLoopUnroll.hpp"
+#include "Compiler/Optimizer/OpenCLPasses/ProfileFeedback/ProfileFeedback.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/Image3dToImage2darray/Image3dToImage2darray.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/RewriteLocalSize/RewriteLocalSize.hpp"
 #include "Compiler/MetaDataApi/PurgeMetaDataUtils.hpp"
@@ -408,6 +409,18 @@ static void CommonOCLBasedPasses(
         mpm.add(new PurgeMetaDataUtils());
     }
 
+    // Block indices in profile feedback refer to the kernels as they are at
+    // this point of the pipeline, so counters are inserted here as well.
+    if (!pContext->m_InternalOptions.ProfileFeedbackFile.empty())
+    {
+        mpm.add(new ProfileFeedbackAnnotation(pContext->m_InternalOptions.ProfileFeedbackFile));
+    }
+    if (!pContext->m_InternalOptions.ProfileInstrumentMapFile.empty())
+    {
+        mpm.add(new ProfileInstrumentation(pContext->m_InternalOptions.ProfileInstrumentMapFile,
+            pContext->hash.getAsmHash()));
+    }
+
     // OpenCL WI + image function resolution
 
     // OCLTODO : do another DCE that will get rid of unused WI func calls before this?
@@ -29,6 +29,7 @@ SPDX-License-Identifier: MIT
 
 #include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
 #include "common/debug/Dump.hpp"
+#include "common/debug/AsyncDumpWriter.hpp"
 #include "common/debug/Debug.hpp"
 #include "common/igc_regkeys.hpp"
 #include "common/secure_mem.h"
@@ -39,6 +40,7 @@ SPDX-License-Identifier: MIT
 
 #if defined(IGC_VC_ENABLED)
 #include "common/LLVMWarningsPush.hpp"
+#include "vc/Driver/Driver.h"
 #include "vc/igcdeps/TranslationInterface.h"
 #include "vc/Support/StatusCode.h"
 #include "common/LLVMWarningsPop.hpp"
@@ -53,6 +55,7 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPop.hpp"
 #include "AdaptorOCL/SPIRV/libSPIRV/SPIRVModule.h"
 #include "AdaptorOCL/SPIRV/libSPIRV/SPIRVValue.h"
+#include "AdaptorOCL/SPIRV/libSPIRV/SPIRVStream.h"
 #if defined(IGC_SCALAR_USE_KHRONOS_SPIRV_TRANSLATOR)
 #include "LLVMSPIRVLib.h"
 #endif
@@ -354,13 +357,8 @@ void DumpShaderFile(
             << std::setfill(' ')
             << ext;
 
-        FILE* pFile = NULL;
-        fopen_s(&pFile, fullPath.str().c_str(), "wb");
-        if (pFile)
-        {
-            fwrite(pBuffer, 1, bufferSize, pFile);
-            fclose(pFile);
-        }
+        IGC::Debug::WriteDumpFile(
+            fullPath.str(), pBuffer, bufferSize, false, true);
 
         if (fileName != nullptr)
         {
@@ -406,15 +404,20 @@ spv_result_t DisassembleSPIRV(const char* pBuffer, UINT bufferSize, spv_text* ou
 
 #if defined(IGC_SPIRV_ENABLED)
 // Translate SPIR-V binary to LLVM Module
+// If pModuleMD is given, IGC module metadata is returned there instead of
+// being attached to the module.
 bool TranslateSPIRVToLLVM(
     const STB_TranslateInputArgs& InputArgs,
     llvm::LLVMContext& Context,
     llvm::StringRef SPIRVBinary,
     llvm::Module*& LLVMModule,
-    std::string& stringErrMsg)
+    std::string& stringErrMsg,
+    IGC::ModuleMetaData* pModuleMD = nullptr)
 {
     bool success = true;
-    std::istringstream IS(SPIRVBinary.str());
+    // Decode straight from the caller's buffer; SPIR-V modules can be
+    // several megabytes and copying them into a string is not free.
+    igc_spv::SPIRVSpanStream IS(SPIRVBinary.data(), SPIRVBinary.size());
     std::unordered_map<uint32_t, uint64_t> specIDToSpecValueMap = UnpackSpecConstants(
         InputArgs.pSpecConstantsIds,
         InputArgs.pSpecConstantsValues,
@@ -438,8 +441,13 @@ bool TranslateSPIRVToLLVM(
 
     // Actual translation from SPIR-V to LLLVM
     success = llvm::readSpirv(Context, Opts, IS, LLVMModule, stringErrMsg);
+    if (success && pModuleMD)
+    {
+        deserialize(*pModuleMD, LLVMModule);
+    }
 #else // IGC Legacy SPIRV Translator
-    success = igc_spv::ReadSPIRV(Context, IS, LLVMModule, stringErrMsg, &specIDToSpecValueMap);
+    success = igc_spv::ReadSPIRV(Context, IS, LLVMModule, stringErrMsg, &specIDToSpecValueMap,
+        IGC_IS_FLAG_ENABLED(EnableSPIRVLazyTranslation), pModuleMD);
 #endif
 
     // Handle OpenCL Compiler Options
@@ -750,12 +758,15 @@ bool ProcessElfInput(
   return success;
 }
 
+// For SPIR-V input, module metadata produced by the reader is returned in
+// pModuleMD if given, saving a round trip through the IGCMetadata node.
 bool ParseInput(
     llvm::Module*& pKernelModule,
     const STB_TranslateInputArgs* pInputArgs,
     STB_TranslateOutputArgs* pOutputArgs,
     llvm::LLVMContext &oclContext,
-    TB_DATA_FORMAT inputDataFormatTemp)
+    TB_DATA_FORMAT inputDataFormatTemp,
+    IGC::ModuleMetaData* pModuleMD = nullptr)
 {
     pKernelModule = nullptr;
 
@@ -816,7 +827,7 @@ bool ParseInput(
 #if defined(IGC_SPIRV_ENABLED)
         //convert SPIR-V binary to LLVM module
         std::string stringErrMsg;
-        bool success = TranslateSPIRVToLLVM(*pInputArgs, oclContext, strInput, pKernelModule, stringErrMsg);
+        bool success = TranslateSPIRVToLLVM(*pInputArgs, oclContext, strInput, pKernelModule, stringErrMsg, pModuleMD);
 #else
         std::string stringErrMsg{"SPIRV consumption not enabled for the TARGET."};
         bool success = false;
@@ -967,6 +978,10 @@ bool TranslateBuildSPMD(const STB_TranslateInputArgs *pInputArgs,
     // Setting mutex to ensure that single thread will enter and setup this flag.
     {
         const std::lock_guard<std::mutex> lock(llvm_mutex);
+#if defined(IGC_VC_ENABLED)
+        // vc::Compile reads LLVM options concurrently under the shared lock.
+        const std::unique_lock<std::shared_mutex> vcLock(vc::getLLVMGlobalStateMutex());
+#endif // defined(IGC_VC_ENABLED)
         // Disable code sinking in instruction combining.
         // This is a workaround for a performance issue caused by code sinking
         // that is being done in LLVM's instcombine pass.
@@ -1063,7 +1078,10 @@ bool TranslateBuildSPMD(const STB_TranslateInputArgs *pInputArgs,
         DumpShaderFile(pOutputFolder, outputstr.str().c_str(), outputstr.str().size(), hash, "_cmd.txt");
     }
 
-    if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *llvmContext, inputDataFormatTemp))
+    // Metadata of SPIR-V input is handed over directly rather than encoded
+    // into MDNodes and decoded again; it only goes into the IR for dumps.
+    IGC::ModuleMetaData spirvModuleMD;
+    if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *llvmContext, inputDataFormatTemp, &spirvModuleMD))
     {
         return false;
     }
@@ -1101,7 +1119,7 @@ bool TranslateBuildSPMD(const STB_TranslateInputArgs *pInputArgs,
     oclContext.setModule(pKernelModule);
     if (oclContext.isSPIRV())
     {
-        deserialize(*oclContext.getModuleMetaData(), pKernelModule);
+        *oclContext.getModuleMetaData() = std::move(spirvModuleMD);
     }
 
     oclContext.hash = inputShHash;
@@ -1397,6 +1415,8 @@ bool TranslateBuildSPMD(const STB_TranslateInputArgs *pInputArgs,
 
     COMPILER_TIME_PRINT(&oclContext, ShaderType::OPENCL_SHADER, oclContext.hash);
 
+    COMPILER_TIME_TELEMETRY(&oclContext, ShaderType::OPENCL_SHADER, oclContext.hash);
+
     COMPILER_TIME_DEL(&oclContext, m_compilerTimeStats);
 
     oclContext.metrics.FinalizeStats();
@@ -1419,13 +1439,8 @@ bool TranslateBuildVC(
              (strstr(pInputArgs->pOptions, "-vc-codegen") ||
               strstr(pInputArgs->pOptions, "-cmc")));
 
-  // Currently, VC compiler effectively uses global variables to store
-  // some configuration information. This may lead to problems
-  // during multi-threaded compilations. The mutex below serializes
-  // the whole compilation process.
-  // This is a temporary measure till a proper re-design is done.
-  const std::lock_guard<std::mutex> lock(llvm_mutex);
-
+  // VC builds run concurrently: vc::Compile guards the global LLVM state
+  // (options, timers, statistics) itself, see vc::getLLVMGlobalStateMutex.
   std::error_code Status =
       vc::translateBuild(pInputArgs, pOutputArgs, inputDataFormatTemp,
                          IGCPlatform, profilingTimerResolution);
@@ -1442,6 +1457,11 @@ bool TranslateBuild(
     const IGC::CPlatform& IGCPlatform,
     float profilingTimerResolution)
 {
+    // In concurrent compile mode flags written during this build (e.g. the
+    // RA heuristics picked per kernel) must not be seen by other builds.
+    // The debug hash used for hash-ranged flags is already per thread.
+    RegKeySnapshotScope flagSnapshot(IGC_IS_FLAG_ENABLED(EnableConcurrentCompile));
+
     ShaderHash inputShHash = ShaderHashOCL(reinterpret_cast<const UINT *>(pInputArgs->pInput),
                                            pInputArgs->InputSize / 4);
 
@@ -0,0 +1,93 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+// Client side of igc-server. Instead of loading the IGC library and paying
+// for its setup on every build, a tool connects once to a running server
+// and sends its builds there; the server answers from warm worker
+// processes. A Client owns one connection and is not thread-safe, use one
+// per thread.
+//
+//   IGC::Server::Client client;
+//   if (client.Connect("/tmp/igc-server.sock")) {
+//     IGC::Server::BuildRequest req;  // device, input, options
+//     IGC::Server::BuildResponse res;
+//     if (client.Build(req, res) && res.Successful) { ... res.Output ... }
+//   }
+
+#include "ocl_igc_interface/igc_server_protocol.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace IGC {
+namespace Server {
+
+class Client {
+public:
+  Client() = default;
+  Client(const Client &) = delete;
+  Client &operator=(const Client &) = delete;
+  ~Client() { Disconnect(); }
+
+  bool Connect(const std::string &SocketPath) {
+    Disconnect();
+    sockaddr_un Addr = {};
+    if (SocketPath.size() >= sizeof(Addr.sun_path)) {
+      return false;
+    }
+    Addr.sun_family = AF_UNIX;
+    memcpy(Addr.sun_path, SocketPath.c_str(), SocketPath.size() + 1);
+
+    Fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (Fd < 0) {
+      return false;
+    }
+    if (connect(Fd, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)) != 0) {
+      Disconnect();
+      return false;
+    }
+    return true;
+  }
+
+  // Adopts an already connected socket.
+  void Attach(int ConnectedFd) {
+    Disconnect();
+    Fd = ConnectedFd;
+  }
+
+  void Disconnect() {
+    if (Fd >= 0) {
+      close(Fd);
+      Fd = -1;
+    }
+  }
+
+  bool IsConnected() const { return Fd >= 0; }
+
+  // Sends one build and waits for its result. Returns false, and drops the
+  // connection, when the server cannot be reached or answers garbage; a
+  // failed compile is a successful call with !Res.Successful.
+  bool Build(const BuildRequest &Req, BuildResponse &Res) {
+    std::string Payload;
+    if (Fd < 0 || !SendMessage(Fd, Encode(Req)) ||
+        !ReceiveMessage(Fd, Payload) || !Decode(Payload, Res)) {
+      Disconnect();
+      return false;
+    }
+    return true;
+  }
+
+private:
+  int Fd = -1;
+};
+
+} // namespace Server
+} // namespace IGC
@@ -0,0 +1,208 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+// Wire format between igc-server and its clients (see igc_server_client.h).
+// Both ends run on the same host and talk over a local stream socket, so
+// values are sent in native byte order. Every message is a MessageHeader
+// followed by HeaderPayloadSize bytes of payload; a connection carries any
+// number of request/response pairs.
+
+#include "ocl_igc_interface/code_type.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace IGC {
+namespace Server {
+
+constexpr uint32_t ProtocolMagic = 0x53434749; // "IGCS"
+constexpr uint32_t ProtocolVersion = 1;
+// Larger payloads are treated as a corrupt stream.
+constexpr uint64_t MaxPayloadSize = uint64_t(1) << 30;
+
+struct MessageHeader {
+  uint32_t Magic;
+  uint32_t Version;
+  uint64_t PayloadSize;
+};
+
+// The subset of PLATFORM and GT_SYSTEM_INFO the runtime hands to
+// IgcOclDeviceCtx for an OpenCL device.
+struct DeviceDesc {
+  uint32_t ProductFamily = 0;
+  uint32_t RenderCoreFamily = 0;
+  uint32_t DisplayCoreFamily = 0;
+  uint16_t DeviceID = 0;
+  uint16_t RevId = 0;
+  uint32_t EUCount = 0;
+  uint32_t ThreadCount = 0;
+  uint32_t SliceCount = 0;
+  uint32_t SubSliceCount = 0;
+  uint32_t MaxEuPerSubSlice = 0;
+  uint32_t MaxSlicesSupported = 0;
+  uint32_t MaxSubSlicesSupported = 0;
+  uint32_t MaxDualSubSlicesSupported = 0;
+  uint32_t DualSubSliceCount = 0;
+};
+
+struct BuildRequest {
+  DeviceDesc Device;
+  CodeType::CodeType_t InType = CodeType::llvmBc;
+  CodeType::CodeType_t OutType = CodeType::oclGenBin;
+  std::string Src;
+  std::string Options;
+  std::string InternalOptions;
+};
+
+struct BuildResponse {
+  bool Successful = false;
+  // Served from the worker's kernel cache rather than compiled.
+  bool FromCache = false;
+  std::string Output;
+  std::string BuildLog;
+};
+
+namespace Detail {
+class Writer {
+public:
+  template <typename T> void Put(const T &V) {
+    Data.append(reinterpret_cast<const char *>(&V), sizeof(V));
+  }
+  void PutString(const std::string &S) {
+    Put<uint64_t>(S.size());
+    Data.append(S);
+  }
+  std::string Data;
+};
+
+class Reader {
+public:
+  explicit Reader(const std::string &Data) : Data(Data) {}
+  template <typename T> bool Get(T &V) {
+    if (Data.size() - Pos < sizeof(V)) {
+      return false;
+    }
+    memcpy(&V, Data.data() + Pos, sizeof(V));
+    Pos += sizeof(V);
+    return true;
+  }
+  bool GetString(std::string &S) {
+    uint64_t Size = 0;
+    if (!Get(Size) || Data.size() - Pos < Size) {
+      return false;
+    }
+    S.assign(Data, Pos, Size);
+    Pos += Size;
+    return true;
+  }
+  bool AtEnd() const { return Pos == Data.size(); }
+
+private:
+  const std::string &Data;
+  size_t Pos = 0;
+};
+} // namespace Detail
+
+inline std::string Encode(const BuildRequest &Req) {
+  Detail::Writer W;
+  W.Put(Req.Device);
+  W.Put(Req.InType);
+  W.Put(Req.OutType);
+  W.PutString(Req.Src);
+  W.PutString(Req.Options);
+  W.PutString(Req.InternalOptions);
+  return std::move(W.Data);
+}
+
+inline bool Decode(const std::string &Payload, BuildRequest &Req) {
+  Detail::Reader R(Payload);
+  return R.Get(Req.Device) && R.Get(Req.InType) && R.Get(Req.OutType) &&
+         R.GetString(Req.Src) && R.GetString(Req.Options) &&
+         R.GetString(Req.InternalOptions) && R.AtEnd();
+}
+
+inline std::string Encode(const BuildResponse &Res) {
+  Detail::Writer W;
+  W.Put<uint8_t>(Res.Successful);
+  W.Put<uint8_t>(Res.FromCache);
+  W.PutString(Res.Output);
+  W.PutString(Res.BuildLog);
+  return std::move(W.Data);
+}
+
+inline bool Decode(const std::string &Payload, BuildResponse &Res) {
+  Detail::Reader R(Payload);
+  uint8_t Successful = 0, FromCache = 0;
+  if (!(R.Get(Successful) && R.Get(FromCache) && R.GetString(Res.Output) &&
+        R.GetString(Res.BuildLog) && R.AtEnd())) {
+    return false;
+  }
+  Res.Successful = Successful != 0;
+  Res.FromCache = FromCache != 0;
+  return true;
+}
+
+// Blocking I/O on a connected socket; false once the peer is gone.
+inline bool WriteAll(int Fd, const void *Data, size_t Size) {
+  const char *P = static_cast<const char *>(Data);
+  while (Size > 0) {
+    ssize_t N = send(Fd, P, Size, MSG_NOSIGNAL);
+    if (N < 0 && errno == EINTR) {
+      continue;
+    }
+    if (N <= 0) {
+      return false;
+    }
+    P += N;
+    Size -= static_cast<size_t>(N);
+  }
+  return true;
+}
+
+inline bool ReadAll(int Fd, void *Data, size_t Size) {
+  char *P = static_cast<char *>(Data);
+  while (Size > 0) {
+    ssize_t N = recv(Fd, P, Size, 0);
+    if (N < 0 && errno == EINTR) {
+      continue;
+    }
+    if (N <= 0) {
+      return false;
+    }
+    P += N;
+    Size -= static_cast<size_t>(N);
+  }
+  return true;
+}
+
+inline bool SendMessage(int Fd, const std::string &Payload) {
+  MessageHeader Header = {ProtocolMagic, ProtocolVersion, Payload.size()};
+  return WriteAll(Fd, &Header, sizeof(Header)) &&
+         WriteAll(Fd, Payload.data(), Payload.size());
+}
+
+inline bool ReceiveMessage(int Fd, std::string &Payload) {
+  MessageHeader Header;
+  if (!ReadAll(Fd, &Header, sizeof(Header)) || Header.Magic != ProtocolMagic ||
+      Header.Version != ProtocolVersion || Header.PayloadSize > MaxPayloadSize) {
+    return false;
+  }
+  Payload.resize(Header.PayloadSize);
+  return ReadAll(Fd, &Payload[0], Payload.size());
+}
+
+} // namespace Server
+} // namespace IGC
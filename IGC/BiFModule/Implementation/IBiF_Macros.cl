@@ -20,6 +20,15 @@ SPDX-License-Identifier: MIT
         _additionalElems,                                                   \
         sizeof(_type));
 
+// Same as GET_MEMPOOL_PTR, but sized for one element per subgroup instead of
+// one per work item. Use this for data exchanged between subgroups.
+#define GET_SUBGROUP_MEMPOOL_PTR(_ptr, _type, _additionalElems)             \
+  __local _type* _ptr =                                                     \
+    (__local _type*)__builtin_IB_AllocLocalMemPool(                         \
+        2,                                                                  \
+        _additionalElems,                                                   \
+        sizeof(_type));
+
 // Macro for async work copy implementation.
 #define ASYNC_WORK_GROUP_COPY(dst, src, num_elements, evt, __num_elements_type)                  \
     {                                                                       \
@@ -99,7 +99,9 @@ void     __builtin_IB_write_2darr_f(int, int4, float4, int);
 void     __builtin_IB_write_2d_f(int, int2, float4, int);
 
 // Workgroup functions
-local uchar* __builtin_IB_AllocLocalMemPool(bool allocAllWorkgroups, uint numAdditionalElements, uint elementSize);
+// allocAllWorkgroups: 0 - numAdditionalElements only, 1 - plus one element per work item,
+// 2 - plus one element per subgroup
+local uchar* __builtin_IB_AllocLocalMemPool(uint allocAllWorkgroups, uint numAdditionalElements, uint elementSize);
 
 // Memory fences
 // See GenISAIntrinsics.td for documentation
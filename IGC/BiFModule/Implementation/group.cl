@@ -956,21 +956,15 @@ void SPIRV_OVERLOADABLE SPIRV_BUILTIN(GroupWaitEvents, _i32_i32_p4i64, )(int Exe
 }
 #endif __OPENCL_C_VERSION__ >= CL_VERSION_2_0
 
+uint __builtin_IB_WorkGroupReduce_UMin_i32(uint X);
+uint __builtin_IB_WorkGroupReduce_UMax_i32(uint X);
+
 bool SPIRV_OVERLOADABLE SPIRV_BUILTIN(GroupAll, _i32_i1, )(int Execution, bool Predicate)
 {
     if (Execution == Workgroup)
     {
-        // if wg-size is equal to sg-size, don't bother SLM, just do it using subgroups
-        if(SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )() == 1)
-            return SPIRV_BUILTIN(GroupUMin, _i32_i32_i32, )(Subgroup, GroupOperationReduce, (uint)(Predicate) );
-
-        GET_MEMPOOL_PTR(tmp, int, false, 1)
-        *tmp = 1;
-        SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Execution, 0, AcquireRelease | WorkgroupMemory); // Wait for tmp to be initialized
-        if(Predicate == 0)
-            *tmp = 0; // intentional data race here, as we do not care for the value itself, rather than the fact it was overriden
-        SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Execution, 0, AcquireRelease | WorkgroupMemory); // Wait for threads
-        return *tmp; // Return true if none of them failed the test
+        // vote within each subgroup first, so only one value per subgroup goes through SLM
+        return __builtin_IB_WorkGroupReduce_UMin_i32((uint)Predicate);
     }
     else
     {
@@ -982,17 +976,8 @@ bool SPIRV_OVERLOADABLE SPIRV_BUILTIN(GroupAny, _i32_i1, )(int Execution, bool P
 {
     if (Execution == Workgroup)
     {
-        // if wg-size is equal to sg-size, don't bother SLM, just do it using subgroups
-        if(SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )() == 1)
-            return SPIRV_BUILTIN(GroupUMax, _i32_i32_i32, )(Subgroup, GroupOperationReduce, (uint)Predicate );
-
-        GET_MEMPOOL_PTR(tmp, int, false, 1)
-        *tmp = 0;
-        SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Execution, 0, AcquireRelease | WorkgroupMemory); // Wait for tmp to be initialized
-        if(Predicate == 1)
-            *tmp = 1; // intentional data race here, as we do not care for the value itself, rather than the fact it was overriden
-        SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Execution, 0, AcquireRelease | WorkgroupMemory);
-        return *tmp; // Return true if any of them passed the test
+        // vote within each subgroup first, so only one value per subgroup goes through SLM
+        return __builtin_IB_WorkGroupReduce_UMax_i32((uint)Predicate);
     }
     else
     {
@@ -2243,9 +2228,13 @@ DEFN_ARITH_OPERATIONS(half)
 type __builtin_IB_WorkGroupReduce_##func##_##type_abbr(type X)                                             \
 {                                                                                                          \
     type sg_x = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, X);     \
-    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                \
-    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                             \
     uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                          \
+    if (num_sg == 1) {                                                                                     \
+        return sg_x;                                                                                       \
+    }                                                                                                      \
+                                                                                                           \
+    GET_SUBGROUP_MEMPOOL_PTR(scratch, type, 0)                                                             \
+    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                             \
     uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                             \
     uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                         \
                                                                                                            \
@@ -2268,10 +2257,13 @@ type __builtin_IB_WorkGroupReduce_##func##_##type_abbr(type X)
 type __builtin_IB_WorkGroupScanInclusive_##func##_##type_abbr(type X)                                           \
 {                                                                                                               \
     type sg_x = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationInclusiveScan, X);   \
+    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                               \
+    if (num_sg == 1) {                                                                                          \
+        return sg_x;                                                                                            \
+    }                                                                                                           \
                                                                                                                 \
-    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                     \
+    GET_SUBGROUP_MEMPOOL_PTR(scratch, type, 0)                                                                  \
     uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                  \
-    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                               \
     uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                                  \
     uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                              \
                                                                                                                 \
@@ -2306,17 +2298,21 @@ type __builtin_IB_WorkGroupScanExclusive_##func##_##type_abbr(type X)
 {                                                                                                               \
     type carry = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationInclusiveScan, X);  \
                                                                                                                 \
-    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                     \
-    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                  \
-    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                               \
     uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                                  \
-    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                              \
-                                                                                                                \
     type sg_x = intel_sub_group_shuffle_up((type)identity, carry, 1);                                           \
     if (sg_lid == 0) {                                                                                          \
         sg_x = identity;                                                                                        \
     }                                                                                                           \
                                                                                                                 \
+    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                               \
+    if (num_sg == 1) {                                                                                          \
+        return sg_x;                                                                                            \
+    }                                                                                                           \
+                                                                                                                \
+    GET_SUBGROUP_MEMPOOL_PTR(scratch, type, 0)                                                                  \
+    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                  \
+    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                              \
+                                                                                                                \
     if (sg_lid == sg_size - 1) {                                                                                \
         scratch[sg_id] = carry;                                                                                 \
     }                                                                                                           \
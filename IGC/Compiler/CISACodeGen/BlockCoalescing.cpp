@@ -7,6 +7,8 @@ SPDX-License-Identifier: MIT
 ============================= end_copyright_notice ===========================*/
 
 #include "Compiler/CISACodeGen/BlockCoalescing.hpp"
+#include "Compiler/CodeGenContextWrapper.hpp"
+#include "Compiler/CodeGenPublic.h"
 #include "Compiler/MetaDataApi/MetaDataApi.h"
 #include "common/igc_regkeys.hpp"
 #include "Compiler/IGCPassSupport.h"
@@ -25,6 +27,7 @@ IGC_INITIALIZE_PASS_BEGIN(BlockCoalescing, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG
 IGC_INITIALIZE_PASS_DEPENDENCY(DeSSA)
 IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenPatternMatch)
 IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
 IGC_INITIALIZE_PASS_END(BlockCoalescing, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 namespace IGC
@@ -37,6 +40,7 @@ namespace IGC
 
     bool BlockCoalescing::runOnFunction(Function& F)
     {
+        COMPILER_TIME_SCOPE(getAnalysis<CodeGenContextWrapper>().getCodeGenContext(), TIME_CG_BlockCoalescing);
 
         MetaDataUtils* pMdUtils = nullptr;
         pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
@@ -3852,6 +3852,11 @@ namespace IGC
             SaveOption(vISA_EnableCompilerStats, true);
         }
 
+        if (isPerPassTimeStatsEnabled())
+        {
+            SaveOption(vISA_PerPassStats, true);
+        }
+
         if (IGC_IS_FLAG_ENABLED(EnableSamplerSplit))
         {
             SaveOption(vISA_enableCloneSampleInst, true);
@@ -4356,6 +4361,13 @@ namespace IGC
         {
             SaveOption(vISA_HybridRAWithSpill, true);
         }
+        if (IGC_IS_FLAG_ENABLED(FastCompileTier0) ||
+            context->getModuleMetaData()->compOpt.FastCompileTier0 ||
+            (context->type == ShaderType::OPENCL_SHADER &&
+             static_cast<OpenCLProgramContext*>(context)->m_InternalOptions.IntelFastCompileTier0))
+        {
+            SaveOption(vISA_FastCompileTier0, true);
+        }
         if (IGC_IS_FLAG_ENABLED(DumpPayloadToScratch))
         {
             SaveOption(vISA_dumpPayload, true);
@@ -4635,7 +4647,12 @@ namespace IGC
                 if (IGC_IS_FLAG_DISABLED(FastestWALinearScanForCS) ||
                     context->type != ShaderType::COMPUTE_SHADER)
                 {
-                    SaveOption(vISA_LinearScan, true);
+                    // Stage 2 replaces this code later, so go with the
+                    // tier-0 pipeline: linear scan RA and minimal vISA
+                    // passes. Unlike plain linear scan, tier0 hands kernels
+                    // linear scan cannot allocate to graph coloring instead
+                    // of failing the compile.
+                    SaveOption(vISA_FastCompileTier0, true);
                 }
             }
             else
@@ -4669,6 +4686,9 @@ namespace IGC
 
                 if (IGC_GET_FLAG_VALUE(FastestS1Experiments) & FCEXP_1PASSRA)
                     SaveOption(vISA_FastCompileRA, true); // use 1 iteration RA
+
+                if (IGC_GET_FLAG_VALUE(FastestS1Experiments) & FCEXP_TIER0)
+                    SaveOption(vISA_FastCompileTier0, true); // linearScan + minimal passes
             }
         }
 
@@ -112,6 +112,7 @@ namespace IGC
 
     /// \brief Entry point.
     bool CoalescingEngine::runOnFunction(Function& MF) {
+        COMPILER_TIME_SCOPE(getAnalysis<CodeGenContextWrapper>().getCodeGenContext(), TIME_CG_CoalescingEngine);
         if (IGC_IS_FLAG_ENABLED(DisablePayloadCoalescing))
         {
             return false;
@@ -311,6 +311,7 @@ void DeSSA::dump() const {
 
 bool DeSSA::runOnFunction(Function& MF)
 {
+    COMPILER_TIME_SCOPE(getAnalysis<CodeGenContextWrapper>().getCodeGenContext(), TIME_CG_DeSSA);
     m_F = &MF;
     CurrColor = 0;
     MetaDataUtils* pMdUtils = nullptr;
@@ -940,6 +940,7 @@ bool EmitPass::runOnFunction(llvm::Function& F)
 
         // remove cached per lane offset variables if any.
         PerLaneOffsetVars.clear();
+        UniformBroadcasts.clear();
 
         // Variable reuse per-block states.
         VariableReuseAnalysis::EnterBlockRAII EnterBlock(m_VRA, block.bb);
@@ -995,6 +996,8 @@ bool EmitPass::runOnFunction(llvm::Function& F)
                 if (isa<BranchInst>(llvmInst))
                 {
                     m_encoder->SetSecondHalf(false);
+                    // the de-ssa movs write the phi variables
+                    UniformBroadcasts.clear();
                     // insert constant initializations.
                     InitConstant(block.bb);
                     // Insert lifetime start if there are any
@@ -1033,6 +1036,7 @@ bool EmitPass::runOnFunction(llvm::Function& F)
                     I->m_pattern->Emit(this, init);
                     ++I;
                 }
+                invalidateUniformBroadcasts(llvmInst);
                 m_pDebugEmitter->EndInstruction(llvmInst);
             }
         }
@@ -1244,6 +1248,7 @@ EmitPass::emitInSlice(SBasicBlock& block, SBasicBlock::reverse_iterator I)
         emitLifetimeStart(m_destination, block.bb, (*sliceIter).m_root, false);
 
         (*sliceIter).m_pattern->Emit(this, init);
+        invalidateUniformBroadcasts((*sliceIter).m_root);
         ++sliceIter;
         slicing = false;
         if (sliceIter != E)
@@ -1266,6 +1271,7 @@ EmitPass::emitInSlice(SBasicBlock& block, SBasicBlock::reverse_iterator I)
             emitLifetimeStart(m_destination, block.bb, (*sliceIter).m_root, false);
 
             (*sliceIter).m_pattern->Emit(this, init);
+            invalidateUniformBroadcasts((*sliceIter).m_root);
         }
     }
 
@@ -9625,6 +9631,7 @@ void EmitPass::EmitGenIntrinsicMessage(llvm::GenIntrinsicInst* inst)
     case GenISAIntrinsic::GenISA_LSCAtomicFP32:
     case GenISAIntrinsic::GenISA_LSCAtomicInts:
     case GenISAIntrinsic::GenISA_LSC2DBlockRead:
+    case GenISAIntrinsic::GenISA_LSC2DBlockWrite:
         emitLSCIntrinsic(inst);
         break;
     case GenISAIntrinsic::GenISA_dummyInst:
@@ -9853,6 +9860,8 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
         if (opVar && opVar->IsUniform() && constraint.equals("rw"))
         {
             opnds[i] = BroadcastIfUniform(opVar);
+            // the asm writes the copy, so it cannot be reused
+            UniformBroadcasts.eraseCopy(opnds[i]);
         }
         // Special handling if LLVM replaces a variable with an immediate, we need to insert an extra move
         else if (opVar && opVar->IsImmediate() && !constraint.equals("i"))
@@ -11551,6 +11560,8 @@ void EmitPass::emitStackCall(llvm::CallInst* inst)
             uint label = m_encoder->GetNewLabelID("non_unif_call_body");
             m_encoder->Label(label);
             m_encoder->Push();
+            // copies made before the loop don't reach the back edge
+            UniformBroadcasts.clear();
 
             // Get the first active lane's function address
             CVariable* offset = nullptr;
@@ -11581,6 +11592,7 @@ void EmitPass::emitStackCall(llvm::CallInst* inst)
             // Label for lanes that skipped the call
             m_encoder->Label(callLabel);
             m_encoder->Push();
+            UniformBroadcasts.clear();
 
             // Unset the bits in execution mask for lanes that were called
             CVariable* callMask = m_currShader->GetNewVariable(1, eMask->GetType(), eMask->GetAlign(), true, CName::NONE);
@@ -11595,6 +11607,8 @@ void EmitPass::emitStackCall(llvm::CallInst* inst)
             // Loop while there are bits still left in the mask
             m_encoder->Jump(loopPred, label);
             m_encoder->Push();
+            // copies made in the loop only cover the lanes of one iteration
+            UniformBroadcasts.clear();
         }
     }
 
@@ -12454,6 +12468,30 @@ CVariable* EmitPass::BroadcastIfUniform(CVariable* pVar, bool nomask)
     {
         uint32_t width = numLanes(m_currShader->m_SIMDSize);
         uint elts = IsImm ? 1 : pVar->GetNumberElement();
+
+        // Reuse a copy made earlier in this block under the same encoder
+        // state, instead of keeping several full-width copies of one value.
+        // A predicated copy only writes some of the lanes, so it is neither
+        // reused nor cached.
+        SEncoderState State = m_encoder->CopyEncoderState();
+        bool Reuse = IGC_IS_FLAG_ENABLED(EnableUniformBroadcastReuse) && !IsImm &&
+            State.m_flag.var == nullptr &&
+            !m_encoder->IsSubSpanDestination() && !m_encoder->IsCodePatchCandidate();
+        UniformBroadcastState Key{ State.m_simdSize, State.m_mask,
+            State.m_secondHalf, State.m_secondNibble, nomask || State.m_noMask };
+        if (Reuse)
+        {
+            if (CVariable* Copy = UniformBroadcasts.lookup(pVar, Key))
+            {
+                return Copy;
+            }
+        }
+        // Each cached copy stays live until the last use in the block, so
+        // cap the GRFs the cache holds on to.
+        unsigned Bytes = elts * width * pVar->GetElemSize();
+        Reuse = Reuse && UniformBroadcasts.hasRoom(Bytes,
+            UniformBroadcastMaxGRFs * m_currShader->getGRFSize());
+
         CVariable* pBroadcast =
             m_currShader->GetNewVariable(elts * width, pVar->GetType(),
                 EALIGN_GRF, CName(pVar->getName(), "Broadcast"));
@@ -12494,12 +12532,44 @@ CVariable* EmitPass::BroadcastIfUniform(CVariable* pVar, bool nomask)
             }
         }
 
+        if (Reuse)
+        {
+            UniformBroadcasts.insert(pVar, Key, pBroadcast, Bytes);
+        }
         pVar = pBroadcast;
     }
 
     return pVar;
 }
 
+void EmitPass::invalidateUniformBroadcasts(const llvm::Instruction* root)
+{
+    if (UniformBroadcasts.empty())
+    {
+        return;
+    }
+    // Calls with side effects may write variables other than m_destination,
+    // e.g. the message phase intrinsics write their operand.
+    if (auto* CI = dyn_cast<CallInst>(root))
+    {
+        if (!CI->onlyReadsMemory())
+        {
+            UniformBroadcasts.clear();
+            return;
+        }
+    }
+    // Struct results are written through variables other than m_destination.
+    if (!m_destination)
+    {
+        if (!root->getType()->isVoidTy())
+        {
+            UniformBroadcasts.clear();
+        }
+        return;
+    }
+    UniformBroadcasts.invalidate(m_destination);
+}
+
 // Get either the 1st/2nd of the execution mask based on whether IsSecondHalf() is set
 // Note that for SIMD32 kernels we always return UD with one half zeroed-out
 CVariable* EmitPass::GetHalfExecutionMask()
@@ -16714,6 +16784,7 @@ void EmitPass::A64LSLoopHead(
     label = m_encoder->GetNewLabelID("a64_loop");
     m_encoder->Label(label);
     m_encoder->Push();
+    UniformBroadcasts.clear();
 
     // Get the first active lane's address-hi
     CVariable* ufoffset = nullptr;
@@ -16742,6 +16813,7 @@ void EmitPass::A64LSLoopTail(CVariable* curMask, CVariable* lsPred, uint label)
     m_encoder->Push();
     m_encoder->Jump(lsPred, label);
     m_encoder->Push();
+    UniformBroadcasts.clear();
 
     m_encoder->SetSecondHalf(tmpSh);
 }
@@ -19178,6 +19250,8 @@ void EmitPass::ResetVMask(bool createJmpForDiscard)
         {
             m_encoder->Label(m_labelForDMaskJmp);
             m_encoder->Push();
+            // the discard jump skips the copies made since ForceDMask
+            UniformBroadcasts.clear();
         }
     }
 }
@@ -19435,6 +19509,7 @@ bool EmitPass::ResourceLoopHeader(
     label = m_encoder->GetNewLabelID("resource_loop");
     m_encoder->Label(label);
     m_encoder->Push();
+    UniformBroadcasts.clear();
     if (!uniformResource)
     {
         ResourceDescriptor uniformResource;
@@ -19486,6 +19561,7 @@ void EmitPass::ResourceLoopBackEdge(bool needLoop, CVariable* flag, uint label)
         m_encoder->SetInversePredicate(true);
         m_encoder->Jump(flag, label);
         m_encoder->Push();
+        UniformBroadcasts.clear();
 
         m_currShader->GetContext()->Stats().IncreaseI64("ResourceLoopCount", 1, numLanes(m_currShader->m_dispatchSize));
     }
@@ -21016,6 +21092,49 @@ void EmitPass::emitLSC2DBlockRead(llvm::GenIntrinsicInst* inst)
     }
 }
 
+void EmitPass::emitLSC2DBlockWrite(llvm::GenIntrinsicInst* inst)
+{
+    CVariable* pFlatImageBaseoffset = GetSymbol(inst->getOperand(0));
+    CVariable* pFlatImageWidth = GetSymbol(inst->getOperand(1));
+    CVariable* pFlatImageHeight = GetSymbol(inst->getOperand(2));
+    CVariable* pFlatImagePitch = GetSymbol(inst->getOperand(3));
+    CVariable* pXOffset = GetSymbol(inst->getOperand(4));
+    CVariable* pYOffset = GetSymbol(inst->getOperand(5));
+
+    // element size, width and height must be supplied as compile time constants.
+    uint elemSizeInBits = (uint)cast<ConstantInt>(inst->getOperand(6))->getZExtValue();
+    uint blockWidth = (uint)cast<ConstantInt>(inst->getOperand(7))->getZExtValue();
+    uint blockHeight = (uint)cast<ConstantInt>(inst->getOperand(8))->getZExtValue();
+    uint numBlocksV = (uint)cast<ConstantInt>(inst->getOperand(9))->getZExtValue();
+    bool isTranspose = (uint)cast<ConstantInt>(inst->getOperand(10))->getZExtValue();
+    bool isVnni = (uint)cast<ConstantInt>(inst->getOperand(11))->getZExtValue();
+    IGC_ASSERT_MESSAGE(numBlocksV == 1 && !isTranspose && !isVnni,
+        "2d block write supports a single non-transformed block only");
+
+    // the payload holds one row per vector element, so a uniform value has
+    // to be expanded to the full SIMD width first
+    CVariable* pData = BroadcastIfUniform(GetSymbol(inst->getOperand(12)), true);
+
+    m_encoder->LSC_2DBlockMessage(
+        LSC_STORE_BLOCK2D,
+        nullptr,
+        pData,
+        nullptr, //pImgBTI - not needed for write
+        pXOffset,
+        pYOffset,
+        (unsigned char)blockWidth,  //elements based
+        (unsigned char)blockHeight,
+        elemSizeInBits,
+        numBlocksV,
+        isTranspose,
+        isVnni,
+        pFlatImageBaseoffset,
+        pFlatImageWidth,
+        pFlatImageHeight,
+        pFlatImagePitch);
+    m_encoder->Push();
+}
+
 void EmitPass::emitLSCFence(llvm::GenIntrinsicInst* inst)
 {
     // Intrinsic format:
@@ -21175,6 +21294,9 @@ void EmitPass::emitLSCIntrinsic(llvm::GenIntrinsicInst* GII)
     case GenISAIntrinsic::GenISA_LSC2DBlockRead:
         emitLSC2DBlockRead(GII);
         break;
+    case GenISAIntrinsic::GenISA_LSC2DBlockWrite:
+        emitLSC2DBlockWrite(GII);
+        break;
     default:
         if (isLSCAtomic(iid)) { ////// GenISA_LSCAtomic*
             emitLSCAtomic(GII);
@@ -15,6 +15,7 @@ SPDX-License-Identifier: MIT
 #include "Simd32Profitability.hpp"
 #include "GenCodeGenModule.h"
 #include "VariableReuseAnalysis.hpp"
+#include "UniformBroadcastCache.hpp"
 #include "Compiler/MetaDataUtilsWrapper.h"
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/DataLayout.h>
@@ -491,6 +492,7 @@ public:
 
     void emitLSCFence(llvm::GenIntrinsicInst* inst);
     void emitLSC2DBlockRead(llvm::GenIntrinsicInst* inst);
+    void emitLSC2DBlockWrite(llvm::GenIntrinsicInst* inst);
     void emitLSCAtomic(llvm::GenIntrinsicInst* inst);
     void emitLSCIntrinsic(llvm::GenIntrinsicInst* GII);
     void emitLSCLoad(
@@ -796,6 +798,33 @@ private:
     // bytes, the second item is the corresponding symbol.
     llvm::SmallVector<std::pair<unsigned, CVariable*>, 4> PerLaneOffsetVars;
 
+    // Cached full-width copies of uniform variables made by
+    // BroadcastIfUniform. This is a per basic block data structure, also
+    // cleared at the labels emitted inside a block and before the de-ssa
+    // moves. A copy is only reused under the same encoder state, is never
+    // made under a predicate, and is dropped once its source variable is
+    // written. The cache holds at most UniformBroadcastMaxGRFs GRFs.
+    struct UniformBroadcastState
+    {
+        SIMDMode simdSize;
+        e_mask mask;
+        bool secondHalf;
+        bool secondNibble;
+        bool noMask;
+
+        bool operator==(const UniformBroadcastState& Other) const
+        {
+            return simdSize == Other.simdSize && mask == Other.mask &&
+                secondHalf == Other.secondHalf &&
+                secondNibble == Other.secondNibble && noMask == Other.noMask;
+        }
+    };
+    static const unsigned UniformBroadcastMaxGRFs = 4;
+    UniformBroadcastCache<CVariable, UniformBroadcastState> UniformBroadcasts;
+
+    // Drop the cached broadcasts whose source is written by root.
+    void invalidateUniformBroadcasts(const llvm::Instruction* root);
+
     // Helper function to reduce common code for emitting indirect address
     // computation.
     CVariable* getOrCreatePerLaneOffsetVariable(unsigned TypeSizeInBytes)
@@ -14,15 +14,21 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/IGCPassSupport.h"
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "common/debug/Debug.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include "llvmWrapper/IR/DerivedTypes.h"
 #include "llvmWrapper/IR/IRBuilder.h"
+#include "llvmWrapper/Support/Alignment.h"
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/ADT/SmallVector.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Support/CommandLine.h>
 #include <llvm/Transforms/Utils/Local.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "Probe/Assertion.h"
+#include <fstream>
+#include <sstream>
 
 #define MAX_ALLOCA_PROMOTE_GRF_NUM      48
 #define MAX_PRESSURE_GRF_NUM            90
@@ -31,6 +37,10 @@ using namespace llvm;
 using namespace IGC;
 using namespace IGC::IGCMD;
 
+static cl::opt<bool> PartialPrivateArrayPromotion(
+    "igc-priv-mem-partial-promotion", cl::init(false), cl::Hidden,
+    cl::desc("Promote rows of oversized private arrays, as with EnablePartialPrivateArrayPromotion"));
+
 namespace IGC {
     /// @brief  LowerGEPForPrivMem pass is used for lowering the allocas identified while visiting the alloca instructions
     ///         and then inserting insert/extract elements instead of load stores. This allows us
@@ -53,6 +63,7 @@ namespace IGC {
             AU.addRequired<MetaDataUtilsWrapper>();
             AU.addRequired<CodeGenContextWrapper>();
             AU.addRequired<DominatorTreeWrapperPass>();
+            AU.addRequired<LoopInfoWrapperPass>();
             AU.setPreservesCFG();
         }
 
@@ -65,14 +76,57 @@ namespace IGC {
         static bool IsVariableSizeAlloca(llvm::AllocaInst& pAlloca);
 
     private:
+        /// What was considered when deciding where an alloca lives, kept
+        /// for the opt report.
+        struct AllocaDecision
+        {
+            const char* reason = "";
+            unsigned int allocaSize = 0;
+            unsigned int pressure = 0;
+            unsigned int maxPressure = 0;
+            // rejected only because of its size or the register pressure
+            bool tooLarge = false;
+        };
+
         llvm::AllocaInst* createVectorForAlloca(
             llvm::AllocaInst* pAlloca,
             llvm::Type* pBaseType);
         void handleAllocaInst(llvm::AllocaInst* pAlloca);
 
-        bool CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca);
+        bool CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca, AllocaDecision& decision);
         bool IsNativeType(Type* type);
 
+        /// One constant-indexed row of an alloca that is split by rows.
+        struct AllocaRow
+        {
+            unsigned int index = 0;
+            llvm::SmallVector<llvm::GetElementPtrInst*, 4> GEPs;
+            unsigned int weight = 0;
+            unsigned int lowId = 0xFFFFFFFF;
+            unsigned int highId = 0;
+            bool promote = false;
+            llvm::AllocaInst* pRowAlloca = nullptr;
+        };
+
+        bool CheckAllocaSizeAndPressure(
+            unsigned int allocaSize, bool isUniformAlloca, bool useAssumeUniform,
+            unsigned int lowestAssignedNumber, unsigned int highestAssignedNumber,
+            AllocaDecision& decision);
+        bool CheckIfRowPromotable(
+            llvm::AllocaInst* pAlloca, const AllocaRow& row, AllocaDecision& decision);
+        bool collectAllocaRows(
+            llvm::AllocaInst* pAlloca,
+            llvm::SmallVectorImpl<AllocaRow>& rows,
+            llvm::SmallVectorImpl<llvm::Instruction*>& lifetimeMarks);
+        void splitAllocaRows(
+            llvm::AllocaInst* pAlloca,
+            llvm::SmallVectorImpl<AllocaRow>& rows,
+            llvm::SmallVectorImpl<llvm::Instruction*>& lifetimeMarks);
+        bool promoteAllocaRows(llvm::AllocaInst* pAlloca);
+        unsigned int getAccessWeight(llvm::Instruction* I);
+        void reportDecision(
+            llvm::AllocaInst* pAlloca, const char* where, const AllocaDecision& decision);
+
     public:
         static char ID;
 
@@ -80,7 +134,11 @@ namespace IGC {
         const llvm::DataLayout* m_pDL = nullptr;
         CodeGenContext* m_ctx = nullptr;
         DominatorTree* m_DT = nullptr;
+        llvm::LoopInfo* m_LI = nullptr;
         std::vector<llvm::AllocaInst*> m_allocasToPrivMem;
+        /// Allocas that are too large to be promoted as a whole
+        std::vector<llvm::AllocaInst*> m_allocasToSplit;
+        std::stringstream m_optReport;
         RegisterPressureEstimate* m_pRegisterPressureEstimate = nullptr;
         llvm::Function* m_pFunc = nullptr;
         MetaDataUtils* pMdUtils = nullptr;
@@ -113,6 +171,7 @@ IGC_INITIALIZE_PASS_BEGIN(LowerGEPForPrivMem, PASS_FLAG, PASS_DESCRIPTION, PASS_
 IGC_INITIALIZE_PASS_DEPENDENCY(RegisterPressureEstimate)
 IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 IGC_INITIALIZE_PASS_END(LowerGEPForPrivMem, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 char LowerGEPForPrivMem::ID = 0;
@@ -150,6 +209,7 @@ bool LowerGEPForPrivMem::runOnFunction(llvm::Function& F)
     IGC_ASSERT(nullptr != pCtxWrapper);
     m_ctx = pCtxWrapper->getCodeGenContext();
     m_DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+    m_LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
 
     pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
     IGC_ASSERT(nullptr != pMdUtils);
@@ -169,8 +229,28 @@ bool LowerGEPForPrivMem::runOnFunction(llvm::Function& F)
     m_pRegisterPressureEstimate->buildRPMapPerInstruction();
 
     m_allocasToPrivMem.clear();
+    m_allocasToSplit.clear();
     visit(F);
 
+    // Allocas that fit as a whole are promoted first; what is left of the
+    // budget goes to the hottest rows of the others.
+    bool splitAny = false;
+    for (auto pAlloca : m_allocasToSplit)
+    {
+        splitAny |= promoteAllocaRows(pAlloca);
+    }
+
+    if (m_optReport.tellp() > 0)
+    {
+        std::stringstream optReportFile;
+        optReportFile << IGC::Debug::GetShaderOutputFolder() << "LowerGEPForPrivMem.opt";
+
+        std::ofstream optReportStream;
+        optReportStream.open(optReportFile.str(), std::ios::app);
+        optReportStream << m_optReport.str();
+        m_optReport.str("");
+    }
+
     std::vector<llvm::AllocaInst*>& allocaToHande = m_allocasToPrivMem;
     for (auto pAlloca : allocaToHande)
     {
@@ -188,8 +268,8 @@ bool LowerGEPForPrivMem::runOnFunction(llvm::Function& F)
 
     if (!allocaToHande.empty())
         DumpLLVMIR(m_ctx, "AfterLowerGEP");
-    // IR changed only if we had alloca instruction to optimize
-    return !allocaToHande.empty();
+    // IR changed only if we had alloca instruction to optimize or split
+    return !allocaToHande.empty() || splitAny;
 }
 
 void TransposeHelper::EraseDeadCode()
@@ -261,16 +341,51 @@ bool LowerGEPForPrivMem::IsNativeType(Type* type)
     return true;
 }
 
-bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
+bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca, AllocaDecision& decision)
 {
     // vla is not promotable
     IGC_ASSERT(pAlloca != nullptr);
     if (IsVariableSizeAlloca(*pAlloca))
+    {
+        decision.reason = "variable size";
         return false;
+    }
 
     bool isUniformAlloca = pAlloca->getMetadata("uniform") != nullptr;
     bool useAssumeUniform = pAlloca->getMetadata("UseAssumeUniform") != nullptr;
     unsigned int allocaSize = extractConstAllocaSize(pAlloca);
+    decision.allocaSize = allocaSize;
+    Type* baseType = nullptr;
+    if (!CanUseSOALayout(pAlloca, baseType))
+    {
+        decision.reason = "unsupported type or uses";
+        return false;
+    }
+    if (!IsNativeType(baseType))
+    {
+        decision.reason = "element type not native";
+        return false;
+    }
+
+    // get all the basic blocks that contain the uses of the alloca
+    // then estimate how much changing this alloca to register adds to the pressure at that block.
+    unsigned int lowestAssignedNumber = 0xFFFFFFFF;
+    unsigned int highestAssignedNumber = 0;
+
+    GetAllocaLiverange(pAlloca, lowestAssignedNumber, highestAssignedNumber, m_pRegisterPressureEstimate);
+
+    return CheckAllocaSizeAndPressure(allocaSize, isUniformAlloca, useAssumeUniform,
+        lowestAssignedNumber, highestAssignedNumber, decision);
+}
+
+// Size and register pressure part of the promotion heuristic, for a
+// variable of allocaSize bytes live from lowestAssignedNumber to
+// highestAssignedNumber. Records the live range if it is promoted.
+bool LowerGEPForPrivMem::CheckAllocaSizeAndPressure(
+    unsigned int allocaSize, bool isUniformAlloca, bool useAssumeUniform,
+    unsigned int lowestAssignedNumber, unsigned int highestAssignedNumber,
+    AllocaDecision& decision)
+{
     unsigned int allowedAllocaSizeInBytes = MAX_ALLOCA_PROMOTE_GRF_NUM * 4;
 
     // scale alloc size based on the number of GRFs we have
@@ -295,15 +410,6 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
             allowedAllocaSizeInBytes = (allowedAllocaSizeInBytes * 8) / simdSize;
         }
     }
-    Type* baseType = nullptr;
-    if (!CanUseSOALayout(pAlloca, baseType))
-    {
-        return false;
-    }
-    if (!IsNativeType(baseType))
-    {
-        return false;
-    }
     if (isUniformAlloca)
     {
         // Heuristic: for uniform alloca we divide the size by 8 to adjust the pressure
@@ -313,22 +419,18 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
 
     if (useAssumeUniform || allocaSize <= IGC_GET_FLAG_VALUE(ByPassAllocaSizeHeuristic))
     {
+        decision.reason = "size below bypass threshold or assumed uniform";
         return true;
     }
 
     // if alloca size exceeds alloc size threshold, return false
     if (allocaSize > allowedAllocaSizeInBytes)
     {
+        decision.reason = "larger than allowed size";
+        decision.tooLarge = true;
         return false;
     }
 
-    // get all the basic blocks that contain the uses of the alloca
-    // then estimate how much changing this alloca to register adds to the pressure at that block.
-    unsigned int lowestAssignedNumber = 0xFFFFFFFF;
-    unsigned int highestAssignedNumber = 0;
-
-    GetAllocaLiverange(pAlloca, lowestAssignedNumber, highestAssignedNumber, m_pRegisterPressureEstimate);
-
     uint32_t maxGRFPressure = (uint32_t)(grfRatio * MAX_PRESSURE_GRF_NUM * 4);
 
     unsigned int pressure = 0;
@@ -348,10 +450,15 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
         }
     }
 
+    decision.pressure = pressure;
+    decision.maxPressure = maxGRFPressure;
     if (allocaSize + pressure > maxGRFPressure)
     {
+        decision.reason = "register pressure too high";
+        decision.tooLarge = true;
         return false;
     }
+    decision.reason = "fits register budget";
     PromotedLiverange liverange;
     liverange.lowId = lowestAssignedNumber;
     liverange.highId = highestAssignedNumber;
@@ -468,14 +575,302 @@ void LowerGEPForPrivMem::visitAllocaInst(AllocaInst& I)
     // Alloca should always be private memory
     IGC_ASSERT(nullptr != I.getType());
     IGC_ASSERT(I.getType()->getAddressSpace() == ADDRESS_SPACE_PRIVATE);
-    if (!CheckIfAllocaPromotable(&I))
+    AllocaDecision decision;
+    if (!CheckIfAllocaPromotable(&I, decision))
     {
         // alloca size extends remain per-lane-reg space
+        if (decision.tooLarge &&
+            (IGC_IS_FLAG_ENABLED(EnablePartialPrivateArrayPromotion) || PartialPrivateArrayPromotion))
+        {
+            m_allocasToSplit.push_back(&I);
+            return;
+        }
+        reportDecision(&I, "scratch", decision);
         return;
     }
+    reportDecision(&I, "GRF", decision);
     m_allocasToPrivMem.push_back(&I);
 }
 
+void LowerGEPForPrivMem::reportDecision(
+    AllocaInst* pAlloca, const char* where, const AllocaDecision& decision)
+{
+    if (IGC_IS_FLAG_DISABLED(EnableOptReportPromotePrivateArray))
+    {
+        return;
+    }
+    m_optReport << m_pFunc->getName().str() << ": alloca " << pAlloca->getName().str()
+        << " (" << decision.allocaSize << " bytes";
+    if (decision.maxPressure != 0)
+    {
+        m_optReport << ", pressure " << decision.pressure << "/" << decision.maxPressure;
+    }
+    m_optReport << ") -> " << where << ": " << decision.reason << std::endl;
+}
+
+// Sum of the access counts of the loads and stores reached from I, each
+// scaled by its loop depth.
+unsigned int LowerGEPForPrivMem::getAccessWeight(Instruction* I)
+{
+    unsigned int weight = 0;
+    for (User* U : I->users())
+    {
+        Instruction* UI = cast<Instruction>(U);
+        if (isa<GetElementPtrInst>(UI) || isa<BitCastInst>(UI))
+        {
+            weight += getAccessWeight(UI);
+        }
+        else if (isa<LoadInst>(UI) || isa<StoreInst>(UI))
+        {
+            unsigned int depth = m_LI->getLoopDepth(UI->getParent());
+            weight += 1u << std::min(3u * depth, 24u);
+        }
+    }
+    return weight;
+}
+
+// Returns true if every access through the row pointer I stays inside the
+// row: it is only indexed further with a zero first index, and only loaded
+// from or stored to. Anything else (indexing into the next row, a bitcast
+// feeding a memcpy, passing the pointer to a call, ptrtoint, ...) may reach
+// the other rows.
+static bool IsRowLocalPointer(Instruction* I)
+{
+    for (Use& U : I->uses())
+    {
+        Instruction* UI = cast<Instruction>(U.getUser());
+        if (GetElementPtrInst* GEP = dyn_cast<GetElementPtrInst>(UI))
+        {
+            ConstantInt* idx0 = GEP->getNumIndices() >= 1 ? dyn_cast<ConstantInt>(GEP->getOperand(1)) : nullptr;
+            if (U.getOperandNo() == GEP->getPointerOperandIndex() &&
+                idx0 && idx0->isZero() && IsRowLocalPointer(GEP))
+            {
+                continue;
+            }
+        }
+        else if (LoadInst* pLoad = dyn_cast<LoadInst>(UI))
+        {
+            if (U.getOperandNo() == pLoad->getPointerOperandIndex())
+            {
+                continue;
+            }
+        }
+        else if (StoreInst* pStore = dyn_cast<StoreInst>(UI))
+        {
+            if (U.getOperandNo() == pStore->getPointerOperandIndex())
+            {
+                continue;
+            }
+        }
+        return false;
+    }
+    return true;
+}
+
+// Collect the rows of an array alloca whose uses all select a constant row,
+//   %p = getelementptr [N x T], [N x T]* %a, i32 0, i32 <const>, ...
+// and only access memory inside that row. Rows are returned with their
+// access weights and live ranges. The IR is not changed.
+bool LowerGEPForPrivMem::collectAllocaRows(
+    AllocaInst* pAlloca,
+    SmallVectorImpl<AllocaRow>& rows,
+    SmallVectorImpl<Instruction*>& lifetimeMarks)
+{
+    Type* pType = pAlloca->getAllocatedType();
+    if (IsVariableSizeAlloca(*pAlloca) || pAlloca->isArrayAllocation() || !pType->isArrayTy())
+    {
+        return false;
+    }
+    Type* rowType = pType->getArrayElementType();
+    uint64_t numRows = pType->getArrayNumElements();
+    if ((!rowType->isArrayTy() && !rowType->isVectorTy()) || numRows < 2)
+    {
+        return false;
+    }
+
+    SmallVector<int, 16> rowIndex(numRows, -1);
+    for (User* U : pAlloca->users())
+    {
+        if (GetElementPtrInst* GEP = dyn_cast<GetElementPtrInst>(U))
+        {
+            ConstantInt* idx0 = GEP->getNumIndices() >= 2 ? dyn_cast<ConstantInt>(GEP->getOperand(1)) : nullptr;
+            ConstantInt* row = GEP->getNumIndices() >= 2 ? dyn_cast<ConstantInt>(GEP->getOperand(2)) : nullptr;
+            if (idx0 && idx0->isZero() && row && row->getZExtValue() < numRows &&
+                IsRowLocalPointer(GEP))
+            {
+                unsigned int r = int_cast<unsigned int>(row->getZExtValue());
+                if (rowIndex[r] < 0)
+                {
+                    rowIndex[r] = int_cast<int>(rows.size());
+                    rows.emplace_back();
+                    rows.back().index = r;
+                }
+                AllocaRow& info = rows[rowIndex[r]];
+                info.GEPs.push_back(GEP);
+                info.weight += getAccessWeight(GEP);
+                GetAllocaLiverange(GEP, info.lowId, info.highId, m_pRegisterPressureEstimate);
+                continue;
+            }
+        }
+        else if (IsBitCastForLifetimeMark(U))
+        {
+            lifetimeMarks.push_back(cast<Instruction>(U));
+            continue;
+        }
+        else if (IntrinsicInst* intr = dyn_cast<IntrinsicInst>(U))
+        {
+            if (intr->getIntrinsicID() == Intrinsic::lifetime_start ||
+                intr->getIntrinsicID() == Intrinsic::lifetime_end)
+            {
+                lifetimeMarks.push_back(intr);
+                continue;
+            }
+        }
+        return false;
+    }
+    return !rows.empty();
+}
+
+// Same heuristic as CheckIfAllocaPromotable, for a row that has not been
+// split off its alloca yet.
+bool LowerGEPForPrivMem::CheckIfRowPromotable(
+    AllocaInst* pAlloca, const AllocaRow& row, AllocaDecision& decision)
+{
+    Type* rowType = pAlloca->getAllocatedType()->getArrayElementType();
+    unsigned int rowSize = int_cast<unsigned int>(m_pDL->getTypeAllocSize(rowType));
+    decision.allocaSize = rowSize;
+
+    Type* baseType = GetBaseType(rowType);
+    bool vectorSOA = true;
+    bool useSOA = baseType != nullptr &&
+        (baseType->getScalarType()->isFloatingPointTy() || baseType->getScalarType()->isIntegerTy());
+    for (auto GEP : row.GEPs)
+    {
+        useSOA = useSOA && CheckUsesForSOAAlyout(GEP, vectorSOA);
+    }
+    if (!useSOA)
+    {
+        decision.reason = "unsupported type or uses";
+        return false;
+    }
+    if (!vectorSOA)
+    {
+        baseType = baseType->getScalarType();
+    }
+    if (!IsNativeType(baseType))
+    {
+        decision.reason = "element type not native";
+        return false;
+    }
+
+    return CheckAllocaSizeAndPressure(rowSize,
+        pAlloca->getMetadata("uniform") != nullptr,
+        pAlloca->getMetadata("UseAssumeUniform") != nullptr,
+        row.lowId, row.highId, decision);
+}
+
+// Split pAlloca into one alloca per collected row and rewrite the row GEPs
+// to use them. pAlloca is left without uses.
+void LowerGEPForPrivMem::splitAllocaRows(
+    AllocaInst* pAlloca,
+    SmallVectorImpl<AllocaRow>& rows,
+    SmallVectorImpl<Instruction*>& lifetimeMarks)
+{
+    // The rows get no lifetime markers of their own.
+    for (auto I : lifetimeMarks)
+    {
+        if (isa<BitCastInst>(I))
+        {
+            SmallVector<User*, 4> markUsers(I->user_begin(), I->user_end());
+            for (auto MU : markUsers)
+            {
+                cast<Instruction>(MU)->eraseFromParent();
+            }
+        }
+        I->eraseFromParent();
+    }
+
+    Type* rowType = pAlloca->getAllocatedType()->getArrayElementType();
+    IRBuilder<> IRB(pAlloca);
+    for (auto& row : rows)
+    {
+        IRB.SetInsertPoint(pAlloca);
+        row.pRowAlloca = IRB.CreateAlloca(rowType, pAlloca->getType()->getAddressSpace(),
+            nullptr, pAlloca->getName() + ".row" + Twine(row.index));
+        row.pRowAlloca->setAlignment(IGCLLVM::getAlign(*pAlloca));
+        row.pRowAlloca->copyMetadata(*pAlloca);
+
+        for (auto GEP : row.GEPs)
+        {
+            Value* newPtr = row.pRowAlloca;
+            if (GEP->getNumIndices() > 2)
+            {
+                SmallVector<Value*, 4> indices;
+                indices.push_back(GEP->getOperand(1));
+                indices.append(GEP->idx_begin() + 2, GEP->idx_end());
+                IRB.SetInsertPoint(GEP);
+                newPtr = GEP->isInBounds() ?
+                    IRB.CreateInBoundsGEP(rowType, row.pRowAlloca, indices, GEP->getName()) :
+                    IRB.CreateGEP(rowType, row.pRowAlloca, indices, GEP->getName());
+            }
+            GEP->replaceAllUsesWith(newPtr);
+            GEP->eraseFromParent();
+        }
+    }
+    IGC_ASSERT(pAlloca->use_empty());
+}
+
+// Promote the rows of an alloca that does not fit in registers as a whole,
+// hottest first, while they fit. The other rows stay in scratch. The alloca
+// is only split if at least one row is promoted.
+bool LowerGEPForPrivMem::promoteAllocaRows(AllocaInst* pAlloca)
+{
+    AllocaDecision decision;
+    decision.allocaSize = extractConstAllocaSize(pAlloca);
+    SmallVector<AllocaRow, 16> rows;
+    SmallVector<Instruction*, 4> lifetimeMarks;
+    if (!collectAllocaRows(pAlloca, rows, lifetimeMarks))
+    {
+        decision.reason = "too large, and not all accesses stay within a constant row";
+        reportDecision(pAlloca, "scratch", decision);
+        return false;
+    }
+
+    std::stable_sort(rows.begin(), rows.end(),
+        [](const AllocaRow& a, const AllocaRow& b)
+        {
+            return a.weight > b.weight;
+        });
+    SmallVector<AllocaDecision, 16> rowDecisions(rows.size());
+    bool promoteAny = false;
+    for (unsigned int i = 0; i < rows.size(); ++i)
+    {
+        rows[i].promote = CheckIfRowPromotable(pAlloca, rows[i], rowDecisions[i]);
+        promoteAny |= rows[i].promote;
+    }
+    if (!promoteAny)
+    {
+        decision.reason = "too large, and no row fits";
+        reportDecision(pAlloca, "scratch", decision);
+        return false;
+    }
+
+    decision.reason = "too large, promoting rows";
+    reportDecision(pAlloca, "split", decision);
+    splitAllocaRows(pAlloca, rows, lifetimeMarks);
+    pAlloca->eraseFromParent();
+
+    for (unsigned int i = 0; i < rows.size(); ++i)
+    {
+        reportDecision(rows[i].pRowAlloca, rows[i].promote ? "GRF" : "scratch", rowDecisions[i]);
+        if (rows[i].promote)
+        {
+            m_allocasToPrivMem.push_back(rows[i].pRowAlloca);
+        }
+    }
+    return true;
+}
+
 void TransposeHelper::HandleAllocaSources(Instruction* v, Value* idx)
 {
     SmallVector<Value*, 10> instructions;
@@ -23,6 +23,7 @@ SPDX-License-Identifier: MIT
 #include <llvm/Pass.h>
 #include <llvmWrapper/Support/Alignment.h>
 #include <llvmWrapper/IR/DerivedTypes.h>
+#include <llvm/Support/CommandLine.h>
 #include <llvm/Support/Debug.h>
 #include <llvm/Support/DebugCounter.h>
 #include <llvm/Support/raw_ostream.h>
@@ -45,8 +46,13 @@ DEBUG_COUNTER(MergeLoadCounter, "memopt-merge-load",
 DEBUG_COUNTER(MergeStoreCounter, "memopt-merge-store",
     "Controls count of merged stores");
 
+static cl::opt<bool> MemOptAcrossBlocks(
+    "igc-memopt-across-blocks", cl::init(false), cl::Hidden,
+    cl::desc("Merge loads/stores across fall-through block chains, as with EnableMemOptAcrossBlocks"));
+
 namespace {
-    // This pass merge consecutive loads/stores within a BB when it's safe:
+    // This pass merge consecutive loads/stores within a BB, or a chain of BBs
+    // falling through to each other, when it's safe:
     // - Two loads (one of them is denoted as the leading load if it happens
     //   before the other one in the program order) are safe to be merged, i.e.
     //   the non-leading load is merged into the leading load, iff there's no
@@ -74,7 +80,8 @@ namespace {
         typedef DenseMap<unsigned int, SmallVector<unsigned, 4> > ProfitVectorLengthsMap;
         ProfitVectorLengthsMap ProfitVectorLengths;
 
-        // A list of memory references (within a BB) with the distance to the begining of the BB.
+        // A list of memory references (within a BB, or a chain of fall-through
+        // BBs) with the distance to the begining of the first BB.
         typedef std::vector<std::pair<Instruction*, unsigned> > MemRefListTy;
         typedef std::vector<Instruction*> TrivialMemRefListTy;
 
@@ -411,6 +418,20 @@ void MemOpt::buildProfitVectorLengths(Function& F) {
     ProfitVectorLengths[8].push_back(2);
 }
 
+/// Returns the block BB falls through to, i.e. its successor when BB ends in
+/// an unconditional branch and is that successor's only predecessor. Such
+/// blocks always execute together (and could be merged), so memory accesses
+/// can be merged across them as if they were one block.
+static BasicBlock* getFallThroughSuccessor(BasicBlock* BB) {
+    BranchInst* Br = dyn_cast<BranchInst>(BB->getTerminator());
+    if (!Br || Br->isConditional())
+        return nullptr;
+    BasicBlock* Succ = Br->getSuccessor(0);
+    if (Succ == BB || Succ->getSinglePredecessor() != BB)
+        return nullptr;
+    return Succ;
+}
+
 bool MemOpt::runOnFunction(Function& F) {
     // Skip non-kernel function.
     MetaDataUtils* MDU = nullptr;
@@ -432,18 +453,29 @@ bool MemOpt::runOnFunction(Function& F) {
 
     bool Changed = false;
 
+    const bool AcrossBlocks =
+        IGC_IS_FLAG_ENABLED(EnableMemOptAcrossBlocks) || MemOptAcrossBlocks;
     for (Function::iterator BB = F.begin(), BBE = F.end(); BB != BBE; ++BB) {
+        // Blocks split by the structurizer or by unrolling are scanned as
+        // part of the chain starting at their fall-through predecessor.
+        BasicBlock* Pred = BB->getSinglePredecessor();
+        if (AcrossBlocks && Pred && getFallThroughSuccessor(Pred) == &*BB)
+            continue;
+
         // Find all instructions with memory reference. Remember the distance one
         // by one.
         MemRefListTy MemRefs;
         TrivialMemRefListTy MemRefsToOptimize;
         unsigned Distance = 0;
-        for (auto BI = BB->begin(), BE = BB->end(); BI != BE; ++BI, ++Distance) {
-            Instruction* I = &(*BI);
-            // Skip irrelevant instructions.
-            if (shouldSkip(I))
-                continue;
-            MemRefs.push_back(std::make_pair(I, Distance));
+        for (BasicBlock* CurBB = &*BB; CurBB;
+             CurBB = AcrossBlocks ? getFallThroughSuccessor(CurBB) : nullptr) {
+            for (auto BI = CurBB->begin(), BE = CurBB->end(); BI != BE; ++BI, ++Distance) {
+                Instruction* I = &(*BI);
+                // Skip irrelevant instructions.
+                if (shouldSkip(I))
+                    continue;
+                MemRefs.push_back(std::make_pair(I, Distance));
+            }
         }
 
         // Skip BB with no more than 2 loads/stores.
@@ -85,6 +85,9 @@ namespace IGC
 
     bool CodeGenPatternMatch::runOnFunction(llvm::Function& F)
     {
+        // Computed once per function and shared by all SIMD variants of
+        // EmitPass; the hit count of this timer shows it.
+        COMPILER_TIME_SCOPE(getAnalysis<CodeGenContextWrapper>().getCodeGenContext(), TIME_CG_PatternMatch);
         m_blockMap.clear();
         ConstantPlacement.clear();
         PairOutputMap.clear();
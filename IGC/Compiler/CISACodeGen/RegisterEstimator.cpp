@@ -140,8 +140,14 @@ RegUse RegisterEstimator::estimateNumOfRegs(Value* V) const
         regs.rClass = (RegClass)REGISTER_CLASS_GRF;
         if (m_LVA->isUniform(V))
         {
-            // round up to DW
-            uint16_t sz = (nBytes + DWORD_SIZE_IN_BYTE - 1) / DWORD_SIZE_IN_BYTE;
+            // Uniform values are packed densely, each rounded up to DW.
+            // Uniform loads are the exception: their result takes a GRF of
+            // its own (see GetPreferredAlignment).
+            uint16_t sz = (nBytes + DWORD_SIZE_IN_BYTE - 1) / DWORD_SIZE_IN_BYTE * DWORD_SIZE_IN_BYTE;
+            if (isa<LoadInst>(V) && sz < GRF_SIZE_IN_BYTE)
+            {
+                sz = GRF_SIZE_IN_BYTE;
+            }
             regs.uniformInBytes += sz;
         }
         else
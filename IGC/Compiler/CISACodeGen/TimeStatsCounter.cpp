@@ -74,7 +74,7 @@ namespace IGC {
         IGC_INITIALIZE_PASS_END(TimeStatsCounter, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
 }
 
-bool TimeStatsCounter::runOnModule(Module& F) {
+bool TimeStatsCounter::runOnModule(Module& M) {
     if (type == STATS_COUNTER_ENUM_TYPE)
     {
         if (mode == STATS_COUNTER_START)
@@ -88,13 +88,16 @@ bool TimeStatsCounter::runOnModule(Module& F) {
     }
     else
     {
+        // Instruction counts walk the whole module, so they are only taken
+        // for the telemetry record.
+        int64_t instCount = isCompileTelemetryEnabled() ? (int64_t)M.getInstructionCount() : 0;
         if (mode == STATS_COUNTER_START)
         {
-            COMPILER_TIME_PASS_START(ctx, igcPass);
+            COMPILER_TIME_PASS_START(ctx, igcPass, instCount);
         }
         else
         {
-            COMPILER_TIME_PASS_END(ctx, igcPass);
+            COMPILER_TIME_PASS_END(ctx, igcPass, instCount);
         }
     }
     return false;
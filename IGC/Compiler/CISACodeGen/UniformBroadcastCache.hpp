@@ -0,0 +1,111 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallVector.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC
+{
+    // Full-width copies of uniform variables made by
+    // EmitPass::BroadcastIfUniform in the block being emitted. A copy is
+    // found by its source variable and the encoder state it was made under,
+    // and is dropped once anything sharing the source's storage is written.
+    // Each copy stays live until its last use in the block, so the bytes the
+    // cache holds are bounded by the caller.
+    //
+    // Var is CVariable in the compiler; it only needs GetAlias(). State is
+    // compared with operator==.
+    template <typename Var, typename State>
+    class UniformBroadcastCache
+    {
+    public:
+        // The copy of Src made under S, or nullptr.
+        Var* lookup(const Var* Src, const State& S) const
+        {
+            for (auto& E : m_entries)
+            {
+                if (E.src == Src && E.state == S)
+                {
+                    return E.copy;
+                }
+            }
+            return nullptr;
+        }
+
+        // Whether a copy of Bytes more keeps the cache within MaxBytes.
+        bool hasRoom(unsigned Bytes, unsigned MaxBytes) const
+        {
+            return m_bytes + Bytes <= MaxBytes;
+        }
+
+        void insert(const Var* Src, const State& S, Var* Copy, unsigned Bytes)
+        {
+            m_entries.push_back({ Src, S, Copy, Bytes });
+            m_bytes += Bytes;
+        }
+
+        // Drops the copies whose source shares storage with Written.
+        void invalidate(const Var* Written)
+        {
+            const Var* Root = getRootVar(Written);
+            eraseIf([&](const Entry& E) { return getRootVar(E.src) == Root; });
+        }
+
+        // Drops Copy itself, e.g. when it is handed out to be written.
+        void eraseCopy(const Var* Copy)
+        {
+            eraseIf([&](const Entry& E) { return E.copy == Copy; });
+        }
+
+        void clear()
+        {
+            m_entries.clear();
+            m_bytes = 0;
+        }
+
+        bool empty() const { return m_entries.empty(); }
+
+    private:
+        struct Entry
+        {
+            const Var* src;
+            State state;
+            Var* copy;
+            unsigned bytes;
+        };
+
+        static const Var* getRootVar(const Var* V)
+        {
+            while (V->GetAlias())
+            {
+                V = V->GetAlias();
+            }
+            return V;
+        }
+
+        template <typename Pred>
+        void eraseIf(Pred P)
+        {
+            for (auto& E : m_entries)
+            {
+                if (P(E))
+                {
+                    m_bytes -= E.bytes;
+                }
+            }
+            llvm::erase_if(m_entries, P);
+        }
+
+        llvm::SmallVector<Entry, 8> m_entries;
+        unsigned m_bytes = 0;
+    };
+}
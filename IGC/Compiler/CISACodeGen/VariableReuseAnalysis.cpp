@@ -67,6 +67,7 @@ VariableReuseAnalysis::VariableReuseAnalysis()
 
 bool VariableReuseAnalysis::runOnFunction(Function& F)
 {
+    COMPILER_TIME_SCOPE(getAnalysis<CodeGenContextWrapper>().getCodeGenContext(), TIME_CG_VariableReuse);
     m_F = &F;
 
     m_WIA = &(getAnalysis<WIAnalysis>());
@@ -598,11 +598,11 @@ uint32_t VectorPreProcess::getSplitByteSize(Instruction* I, WIAnalysisRunner& WI
     {
         bytes = (uint32_t)VPConst::SPLIT_SIZE;
     }
-    if ((isa<LoadInst>(I) || isa<StoreInst>(I)) && WI.isUniform(I))
+    if (isa<LoadInst>(I) || isa<StoreInst>(I))
     {
         auto Alignment = isa<LoadInst>(I) ? cast<LoadInst>(I)->getAlignment()
                                           : cast<StoreInst>(I)->getAlignment();
-        if (Alignment >= 16) {
+        if (Alignment >= 16 && WI.isUniform(I)) {
             Type* ETy = (isa<LoadInst>(I)) ?
                 cast<VectorType>(I->getType())->getElementType() :
                 cast<VectorType>(cast<StoreInst>(I)->getValueOperand()->getType())->getElementType();
@@ -655,10 +655,10 @@ bool VectorPreProcess::splitStore(
             }
         }
         bool needsDWordSplit =
+            ASI.getAlignment() < 4 &&
             (!isStoreInst ||
                 m_CGCtx->m_DriverInfo.splitUnalignedVectors() ||
-                !WI.isUniform(ASI.getInst()))
-            && ASI.getAlignment() < 4;
+                !WI.isUniform(ASI.getInst()));
         if (needsDWordSplit)
         {
             splitSize = 4;
@@ -831,7 +831,7 @@ bool VectorPreProcess::splitLoad(
             }
         }
 
-        if ((isLdRaw || !WI.isUniform(ALI.getInst())) && ALI.getAlignment() < 4)
+        if (ALI.getAlignment() < 4 && (isLdRaw || !WI.isUniform(ALI.getInst())))
             splitSize = 4;
     }
     createSplitVectorTypes(ETy, nelts, splitSize, splitInfo);
@@ -1617,10 +1617,40 @@ bool VectorPreProcess::runOnFunction(Function& F)
             auto* ModMD =
                 getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
 
+            // Uniformity is only queried for loads/stores that are 16 byte
+            // aligned or less than dword aligned, see getSplitByteSize,
+            // splitLoad and splitStore. Skip the analysis if there are none.
+            bool needWI = false;
+            for (Value* V : m_WorkList)
+            {
+                Instruction* I = dyn_cast_or_null<Instruction>(V);
+                if (!I)
+                {
+                    continue;
+                }
+                Optional<AbstractLoadInst> ALI = AbstractLoadInst::get(I);
+                Optional<AbstractStoreInst> ASI = AbstractStoreInst::get(I);
+                if (!ALI && !ASI)
+                {
+                    continue;
+                }
+                uint64_t Alignment = ALI ? ALI.getValue().getAlignment()
+                                         : ASI.getValue().getAlignment();
+                if (Alignment < 4 ||
+                    (Alignment >= 16 && (isa<LoadInst>(I) || isa<StoreInst>(I))))
+                {
+                    needWI = true;
+                    break;
+                }
+            }
+
             TranslationTable TT;
-            TT.run(F);
             WIAnalysisRunner WI(&F, DT, PDT, MDUtils, m_CGCtx, ModMD, &TT);
-            WI.run();
+            if (needWI)
+            {
+                TT.run(F);
+                WI.run();
+            }
 
             for (uint32_t i = 0; i < m_WorkList.size(); ++i)
             {
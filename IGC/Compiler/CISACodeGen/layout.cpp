@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #include "Compiler/CISACodeGen/layout.hpp"
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/Optimizer/OpenCLPasses/ProfileFeedback/ProfileFeedback.hpp"
 #include "Compiler/IGCPassSupport.h"
 #include "common/debug/Debug.hpp"
 #include "common/debug/Dump.hpp"
@@ -450,6 +451,53 @@ BasicBlock* Layout::selectSucc(
     return S0;
 }
 
+static bool isColdBlock(const BasicBlock* BB)
+{
+    return isa<UnreachableInst>(BB->getTerminator()) || getProfileBlockCount(BB) == 0;
+}
+
+//
+// selectColdSucc: for a two-way branch whose successors are both unvisited,
+// non-empty and in the same loop, return the successor that is less likely
+// to execute, according to the branch weights or to profile feedback, or
+// because it ends in unreachable (e.g. a failed assert).
+//
+// Blocks are placed backward, so visiting the cold successor first makes
+// the likely one the fall-through of CurrBlk and moves the cold path
+// behind it.
+//
+BasicBlock* Layout::selectColdSucc(
+    BasicBlock* CurrBlk,
+    const LoopInfo& LI,
+    const std::set<BasicBlock*>& VisitSet)
+{
+    Instruction* Term = CurrBlk->getTerminator();
+    if (!isa<BranchInst>(Term) || Term->getNumSuccessors() != 2)
+    {
+        return nullptr;
+    }
+    BasicBlock* S0 = Term->getSuccessor(0), * S1 = Term->getSuccessor(1);
+    if (S0 == S1 || VisitSet.count(S0) || VisitSet.count(S1) ||
+        S0->size() <= 1 || S1->size() <= 1 ||
+        LI.getLoopFor(S0) != LI.getLoopFor(CurrBlk) ||
+        LI.getLoopFor(S1) != LI.getLoopFor(CurrBlk))
+    {
+        return nullptr;
+    }
+
+    uint64_t W0 = 0, W1 = 0;
+    if (Term->extractProfMetadata(W0, W1) && W0 != W1)
+    {
+        return W0 < W1 ? S0 : S1;
+    }
+    bool Cold0 = isColdBlock(S0), Cold1 = isColdBlock(S1);
+    if (Cold0 != Cold1)
+    {
+        return Cold0 ? S0 : S1;
+    }
+    return nullptr;
+}
+
 void Layout::LayoutBlocks(Function& func, LoopInfo& LI)
 {
     std::vector<llvm::BasicBlock*> visitVec;
@@ -497,6 +545,15 @@ void Layout::LayoutBlocks(Function& func, LoopInfo& LI)
         else
         {
             // push: time for DFS visit
+            if (IGC_IS_FLAG_DISABLED(DisableProfileGuidedLayout))
+            {
+                if (BasicBlock * coldBlk = selectColdSucc(blk, LI, visitSet))
+                {
+                    visitVec.push_back(coldBlk);
+                    visitSet.insert(coldBlk);
+                    continue;
+                }
+            }
             PUSHSUCC(blk, SUCCANYLOOP, SUCCHASINST);
             if (blk != visitVec.back())
                 continue;
@@ -634,6 +691,7 @@ void Layout::LayoutBlocks(Function& func)
 {
     std::vector<llvm::BasicBlock*> visitVec;
     std::set<llvm::BasicBlock*> visitSet;
+    const LoopInfo& LI = getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
     // Reorder basic block to allow more fall-through
     llvm::BasicBlock* entry = &(func.getEntryBlock());
     visitVec.push_back(entry);
@@ -655,6 +713,16 @@ void Layout::LayoutBlocks(Function& func)
         PUSHSUCC(blk, SUCCANYLOOP, SUCCNOINST);
         if (blk != visitVec.back())
             continue;
+        // push in the unlikely successor so that the likely one falls through
+        if (IGC_IS_FLAG_DISABLED(DisableProfileGuidedLayout))
+        {
+            if (BasicBlock * coldBlk = selectColdSucc(blk, LI, visitSet))
+            {
+                visitVec.push_back(coldBlk);
+                visitSet.insert(coldBlk);
+                continue;
+            }
+        }
         // push in all the same-loop successors
         PUSHSUCC(blk, SUCCANYLOOP, SUCCSZANY);
         // pop
@@ -48,6 +48,10 @@ namespace IGC
             bool SelectNoInstBlk,
             const llvm::LoopInfo& LI,
             const std::set<llvm::BasicBlock*>& VisitSet);
+        llvm::BasicBlock* selectColdSucc(
+            llvm::BasicBlock* CurrBlk,
+            const llvm::LoopInfo& LI,
+            const std::set<llvm::BasicBlock*>& VisitSet);
 
         bool isAtomicWrite(llvm::Instruction* inst, bool onlyLocalMem);
         bool isAtomicRead(llvm::Instruction* inst, bool onlyLocalMem);
@@ -0,0 +1,152 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Tests of the cache EmitPass::BroadcastIfUniform keeps its uniform copies
+// in: a second broadcast of the same value under the same state reuses the
+// first copy, and redefinitions and control flow drop the copies they
+// make stale.
+
+#include "Compiler/CISACodeGen/UniformBroadcastCache.hpp"
+
+#include <iostream>
+#include <string>
+
+using namespace IGC;
+
+static unsigned g_numErrors = 0;
+
+static void check(bool cond, const std::string& what)
+{
+    if (!cond)
+    {
+        std::cerr << "FAIL: " << what << "\n";
+        ++g_numErrors;
+    }
+}
+
+// Stands in for CVariable: an alias shares the storage of its root.
+struct Var
+{
+    Var* alias = nullptr;
+    Var* GetAlias() const { return alias; }
+};
+
+// Stands in for the encoder state of a copy.
+struct State
+{
+    unsigned simdSize;
+    bool noMask;
+
+    bool operator==(const State& Other) const
+    {
+        return simdSize == Other.simdSize && noMask == Other.noMask;
+    }
+};
+
+typedef UniformBroadcastCache<Var, State> Cache;
+
+static const unsigned GRFSize = 32;
+static const unsigned MaxBytes = 4 * GRFSize;
+
+static void testReuse()
+{
+    Cache cache;
+    Var x, copy;
+    State simd16{ 16, false };
+    check(cache.lookup(&x, simd16) == nullptr, "reuse: empty cache misses");
+    cache.insert(&x, simd16, &copy, 2 * GRFSize);
+    check(cache.lookup(&x, simd16) == &copy, "reuse: the second broadcast gets the first copy");
+
+    Var y;
+    check(cache.lookup(&y, simd16) == nullptr, "reuse: other source misses");
+    check(cache.lookup(&x, State{ 8, false }) == nullptr, "reuse: other SIMD size misses");
+    check(cache.lookup(&x, State{ 16, true }) == nullptr, "reuse: other noMask misses");
+}
+
+static void testRedefinition()
+{
+    Cache cache;
+    Var x, y, copyX, copyY;
+    State simd16{ 16, false };
+    cache.insert(&x, simd16, &copyX, GRFSize);
+    cache.insert(&y, simd16, &copyY, GRFSize);
+
+    Var z;
+    cache.invalidate(&z);
+    check(cache.lookup(&x, simd16) == &copyX, "redefinition: unrelated write keeps x");
+
+    cache.invalidate(&x);
+    check(cache.lookup(&x, simd16) == nullptr, "redefinition: write to x drops its copy");
+    check(cache.lookup(&y, simd16) == &copyY, "redefinition: write to x keeps y");
+
+    // A write through another alias of the same storage, or to the root
+    // variable itself, is a write to the source.
+    Var root, aliasOfRoot;
+    aliasOfRoot.alias = &root;
+    cache.clear();
+    cache.insert(&aliasOfRoot, simd16, &copyX, GRFSize);
+    Var otherAlias;
+    otherAlias.alias = &root;
+    cache.invalidate(&otherAlias);
+    check(cache.lookup(&aliasOfRoot, simd16) == nullptr,
+        "redefinition: write through another alias drops the copy");
+    cache.insert(&aliasOfRoot, simd16, &copyX, GRFSize);
+    cache.invalidate(&root);
+    check(cache.lookup(&aliasOfRoot, simd16) == nullptr,
+        "redefinition: write to the alias root drops the copy");
+
+    // A copy handed out to be written is no longer a copy.
+    cache.insert(&x, simd16, &copyX, GRFSize);
+    cache.eraseCopy(&copyX);
+    check(cache.lookup(&x, simd16) == nullptr, "redefinition: written copy is dropped");
+}
+
+static void testControlFlow()
+{
+    // EmitPass clears the cache at every label, so a copy made before a
+    // loop or a jump target is not reused after it.
+    Cache cache;
+    Var x, copy;
+    State simd16{ 16, false };
+    cache.insert(&x, simd16, &copy, GRFSize);
+    cache.clear();
+    check(cache.empty(), "control flow: clear empties the cache");
+    check(cache.lookup(&x, simd16) == nullptr, "control flow: copy is not reused past a label");
+    check(cache.hasRoom(MaxBytes, MaxBytes), "control flow: clear releases the bytes");
+}
+
+static void testCap()
+{
+    Cache cache;
+    Var x, y, copyX, copyY;
+    State simd32{ 32, false };
+    check(cache.hasRoom(MaxBytes, MaxBytes), "cap: empty cache holds the limit");
+    check(!cache.hasRoom(MaxBytes + 1, MaxBytes), "cap: nothing above the limit");
+    cache.insert(&x, simd32, &copyX, 2 * GRFSize);
+    cache.insert(&y, simd32, &copyY, 2 * GRFSize);
+    check(!cache.hasRoom(GRFSize, MaxBytes), "cap: a full cache takes no more");
+    cache.invalidate(&x);
+    check(cache.hasRoom(2 * GRFSize, MaxBytes), "cap: invalidation releases the bytes");
+    check(!cache.hasRoom(3 * GRFSize, MaxBytes), "cap: the remaining copy still counts");
+}
+
+int main()
+{
+    testReuse();
+    testRedefinition();
+    testControlFlow();
+    testCap();
+
+    if (g_numErrors)
+    {
+        std::cerr << g_numErrors << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "PASSED\n";
+    return 0;
+}
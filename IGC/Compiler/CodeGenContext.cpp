@@ -749,6 +749,11 @@ namespace IGC
             {
                 IntelEnablePreRAScheduling = false;
             }
+            // -cl-intel-fast-compile-tier0, -ze-intel-fast-compile-tier0
+            else if (suffix.equals("-fast-compile-tier0"))
+            {
+                IntelFastCompileTier0 = true;
+            }
             // -cl-intel-no-local-to-generic
             else if (suffix.equals("-no-local-to-generic"))
             {
@@ -891,6 +896,24 @@ namespace IGC
             {
                 AllowRelocAdd = false;
             }
+            // -cl-intel-profile-feedback-file <path>, -ze-opt-profile-feedback-file <path>
+            else if (suffix.equals("-profile-feedback-file"))
+            {
+                size_t valStart = opts.find_first_not_of(' ', ePos + 1);
+                size_t valEnd = opts.find_first_of(' ', valStart);
+                ProfileFeedbackFile = opts.substr(valStart, valEnd - valStart).str();
+                Pos = valEnd;
+                continue;
+            }
+            // -cl-intel-profile-instrument <map path>, -ze-opt-profile-instrument <map path>
+            else if (suffix.equals("-profile-instrument"))
+            {
+                size_t valStart = opts.find_first_not_of(' ', ePos + 1);
+                size_t valEnd = opts.find_first_of(' ', valStart);
+                ProfileInstrumentMapFile = opts.substr(valStart, valEnd - valStart).str();
+                Pos = valEnd;
+                continue;
+            }
 
             // advance to the next flag
             Pos = opts.find_first_of(' ', Pos);
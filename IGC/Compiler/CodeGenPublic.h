@@ -1451,6 +1451,7 @@ namespace IGC
 
             bool replaceGlobalOffsetsByZero = false;
             bool IntelEnablePreRAScheduling = true;
+            bool IntelFastCompileTier0 = false;
             bool PromoteStatelessToBindless = false;
             bool PreferBindlessImages = false;
             bool UseBindlessMode = false;
@@ -1483,6 +1484,12 @@ namespace IGC
 
             bool AllowRelocAdd = true;
 
+            // Execution counts from a previous run, see ProfileFeedback.hpp
+            std::string ProfileFeedbackFile;
+            // Count block executions and describe the counters in this file,
+            // one per build, named after the shader hash
+            std::string ProfileInstrumentMapFile;
+
             private:
                 void parseOptions(const char* IntOptStr);
         };
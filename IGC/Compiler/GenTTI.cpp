@@ -12,6 +12,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/IGCPassSupport.h"
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/Optimizer/OpenCLPasses/ProfileFeedback/ProfileFeedback.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/Config/llvm-config.h"
@@ -150,6 +151,18 @@ namespace llvm {
                 UP.Threshold = 200;
         }
 
+        // The loop did not run at all in the profiled execution, so unrolling
+        // it only costs code size.
+        if (getProfileBlockCount(L->getHeader()) == 0)
+        {
+            UP.Threshold = 0;
+            UP.Count = 1;
+            UP.MaxCount = UP.Count;
+            UP.Partial = false;
+            UP.Runtime = false;
+            return;
+        }
+
         unsigned MaxTripCount = SE.getSmallConstantMaxTripCount(L);
         const unsigned MaxTripCountToUseUpperBound = 4;
         if (MaxTripCount && MaxTripCount <= MaxTripCountToUseUpperBound)
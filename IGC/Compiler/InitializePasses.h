@@ -70,6 +70,7 @@ void initializeImageFuncsAnalysisPass(llvm::PassRegistry&);
 void initializeImplicitGlobalIdPass(llvm::PassRegistry&);
 void initializeCleanImplicitIdsPass(llvm::PassRegistry&);
 void initializeInlineLocalsResolutionPass(llvm::PassRegistry&);
+void initializeJointMatrixFuncsResolutionPassPass(llvm::PassRegistry&);
 void initializeLegalizationPass(llvm::PassRegistry&);
 void initializeLegalizeResourcePointerPass(llvm::PassRegistry&);
 void initializeLegalizeFunctionSignaturesPass(llvm::PassRegistry&);
@@ -88,6 +89,8 @@ void initializePrivateMemoryToSLMPass(llvm::PassRegistry&);
 void initializePrivateMemoryUsageAnalysisPass(llvm::PassRegistry&);
 void initializeProcessFuncAttributesPass(llvm::PassRegistry&);
 void initializeProcessBuiltinMetaDataPass(llvm::PassRegistry&);
+void initializeProfileFeedbackAnnotationPass(llvm::PassRegistry&);
+void initializeProfileInstrumentationPass(llvm::PassRegistry&);
 void initializeInsertDummyKernelForSymbolTablePass(llvm::PassRegistry&);
 void initializeProgramScopeConstantAnalysisPass(llvm::PassRegistry&);
 void initializeProgramScopeConstantResolutionPass(llvm::PassRegistry&);
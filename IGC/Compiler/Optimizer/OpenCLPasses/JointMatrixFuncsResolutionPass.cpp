@@ -18,6 +18,10 @@ SPDX-License-Identifier: MIT
 #include <llvm/IR/InstVisitor.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/KnownBits.h>
 
 #include "llvmWrapper/IR/DerivedTypes.h"
 #include "llvmWrapper/IR/Module.h"
@@ -28,15 +32,35 @@ SPDX-License-Identifier: MIT
 using namespace llvm;
 using namespace IGC;
 
+static cl::opt<bool> JointMatrix2DBlock(
+    "igc-joint-matrix-2d-block", cl::init(false), cl::Hidden,
+    cl::desc("Resolve JointMatrix loads/stores to LSC 2d block messages, as with EnableJointMatrix2DBlock"));
+
+// Register pass to igc-opt
+#define PASS_FLAG "igc-joint-matrix-resolution"
+#define PASS_DESCRIPTION "Resolves JointMatrix builtins"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(JointMatrixFuncsResolutionPass, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_END(JointMatrixFuncsResolutionPass, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
 char JointMatrixFuncsResolutionPass::ID = 0;
 
 JointMatrixFuncsResolutionPass::JointMatrixFuncsResolutionPass(OpenCLProgramContext *Context) : FunctionPass(ID)
 {
     this->Context = Context;
+    initializeJointMatrixFuncsResolutionPassPass(*PassRegistry::getPassRegistry());
 }
 
 bool JointMatrixFuncsResolutionPass::runOnFunction(Function& F)
 {
+    /* Created by igc_opt without a context. */
+    if (Context == nullptr) {
+        Context = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    }
+    DL = &F.getParent()->getDataLayout();
     ResolvedValues.clear();
     InstsToErase.clear();
     Changed = false;
@@ -86,6 +110,17 @@ struct JointMatrixTypeDescription {
     unsigned bitWidth = 0;
     bool isFloating = false;
 };
+
+/* Shape of an LSC 2d block message doing the same memory access as a matrix
+ * load/store BiF. Width and height describe the block in memory. */
+struct JointMatrixBlock2DShape {
+    unsigned elemSize = 0; /* in bits */
+    unsigned width = 0;    /* in elements */
+    unsigned height = 0;   /* in rows */
+    unsigned pitch = 0;    /* in bytes */
+    bool transpose = false;
+    bool vnni = false;
+};
 }
 
 static bool isOperandUnsigned(unsigned OperationType, unsigned OperandId) {
@@ -267,6 +302,143 @@ static Type *getIntegerEquivalent(Type *matTy) {
     }
 }
 
+bool JointMatrixFuncsResolutionPass::GetBlock2DShape
+        (bool isLoad, unsigned operationLayout, const JointMatrixTypeDescription *desc,
+         Type *matTy, Value *ptrVal, Value *strideVal, JointMatrixBlock2DShape *outShape)
+{
+    if ((IGC_IS_FLAG_DISABLED(EnableJointMatrix2DBlock) && !JointMatrix2DBlock) ||
+        !Context->platform.isProductChildOf(IGFX_PVC)) {
+        return false;
+    }
+
+    /* Surface pitch restrictions are checked at compile time, so only
+     * constant strides are handled. 2d block messages only access global
+     * memory. */
+    ConstantInt *strideConst = dyn_cast<ConstantInt>(strideVal);
+    if (!strideConst || strideConst->getZExtValue() > (1u << 24) ||
+        ptrVal->getType()->getPointerAddressSpace() != ADDRESS_SPACE_GLOBAL) {
+        return false;
+    }
+    const unsigned stride = (unsigned) strideConst->getZExtValue();
+
+    const unsigned sgSize = Context->platform.hasExecSize16DPAS() ? 16 : 8;
+    IGCLLVM::FixedVectorType *vecTy = cast<IGCLLVM::FixedVectorType>(matTy);
+    const unsigned sliceSize = (unsigned) vecTy->getNumElements();
+    const unsigned contribBits = vecTy->getScalarSizeInBits();
+
+    /* Same as in GetLoadStoreMatrixFuncName. */
+    unsigned matrixLayout = desc->layout;
+    if (isLoad && matrixLayout == LayoutRowMajor && desc->bitWidth <= 16) {
+        matrixLayout = LayoutPackedA;
+    }
+
+    JointMatrixBlock2DShape shape;
+    if ((isLoad && matrixLayout == LayoutPackedA && operationLayout == LayoutRowMajor) ||
+        (isLoad && matrixLayout == LayoutPackedB && operationLayout == LayoutPackedB) ||
+        (matrixLayout == LayoutRowMajor && operationLayout == LayoutRowMajor)) {
+        /* Every slice element is one row in memory, work items access
+         * consecutive elements of it. The stride is scaled the same way
+         * the BiFs do it. */
+        shape.elemSize = contribBits;
+        shape.width = sgSize;
+        shape.height = sliceSize;
+        shape.pitch = (stride / (32 / desc->bitWidth)) * (contribBits / 8);
+    } else if (isLoad && matrixLayout == LayoutPackedB && operationLayout == LayoutColumnMajor) {
+        /* Every work item reads one row in memory. */
+        shape.elemSize = 32;
+        shape.width = sliceSize;
+        shape.height = sgSize;
+        shape.pitch = stride * 4;
+        shape.transpose = true;
+    } else if (isLoad && matrixLayout == LayoutPackedB && operationLayout == LayoutRowMajor) {
+        /* B stored row major, packed into VNNI layout while loading. */
+        if (desc->bitWidth >= 32 || desc->columns != sgSize ||
+            desc->rows * desc->bitWidth != sliceSize * 32) {
+            return false;
+        }
+        shape.elemSize = desc->bitWidth;
+        shape.width = desc->columns;
+        shape.height = desc->rows;
+        shape.pitch = stride * (desc->bitWidth / 8);
+        shape.vnni = true;
+    } else {
+        return false;
+    }
+
+    const unsigned rowBytes = shape.width * shape.elemSize / 8;
+    if (shape.height > (isLoad ? 32u : 8u) || rowBytes > 64 || (shape.transpose && shape.width > 8)) {
+        return false;
+    }
+    if (shape.pitch < 64 || shape.pitch % 16 != 0) {
+        return false;
+    }
+
+    /* The surface base has to be 64 byte aligned, so the pointer is split
+     * into an aligned base and an x offset. The offset has to be dword
+     * aligned and the row must still fit into the surface width, which is
+     * set to the pitch. */
+    KnownBits known = computeKnownBits(ptrVal, *DL);
+    const unsigned knownAlign = 1u << std::min(known.countMinTrailingZeros(), 6u);
+    const unsigned maxOffset = knownAlign >= 64 ? 0 : 64 - knownAlign;
+    if (knownAlign < 4 || maxOffset + rowBytes > shape.pitch) {
+        return false;
+    }
+
+    *outShape = shape;
+    return true;
+}
+
+static void getBlock2DArgs(IRBuilder<> &builder, Value *ptrVal, const JointMatrixBlock2DShape *shape,
+                           SmallVectorImpl<Value *> &args)
+{
+    Type *i32Ty = builder.getInt32Ty();
+    Value *addr = builder.CreatePtrToInt(ptrVal, builder.getInt64Ty(), "matrix.addr");
+    Value *base = builder.CreateAnd(addr, ~(uint64_t)63, "matrix.base");
+    Value *offset = builder.CreateTrunc(builder.CreateAnd(addr, 63), i32Ty);
+    Value *x = builder.CreateLShr(offset, Log2_32(shape->elemSize / 8), "matrix.x");
+
+    /* Width, height and pitch are passed minus one. */
+    args.push_back(base);
+    args.push_back(builder.getInt32(shape->pitch - 1));
+    args.push_back(builder.getInt32(shape->height - 1));
+    args.push_back(builder.getInt32(shape->pitch - 1));
+    args.push_back(x);
+    args.push_back(builder.getInt32(0));
+    args.push_back(builder.getInt32(shape->elemSize));
+    args.push_back(builder.getInt32(shape->width));
+    args.push_back(builder.getInt32(shape->height));
+    args.push_back(builder.getInt32(1));
+    args.push_back(builder.getInt1(shape->transpose));
+    args.push_back(builder.getInt1(shape->vnni));
+}
+
+Instruction *JointMatrixFuncsResolutionPass::CreateBlock2DLoad
+        (CallInst *CI, Type *retTy, const JointMatrixBlock2DShape *shape)
+{
+    Module *M = CI->getParent()->getModule();
+    IRBuilder<> builder(CI);
+
+    SmallVector<Value *, 12> args;
+    getBlock2DArgs(builder, CI->getArgOperand(0), shape, args);
+
+    Function *func = GenISAIntrinsic::getDeclaration(M, GenISAIntrinsic::GenISA_LSC2DBlockRead, retTy);
+    return builder.CreateCall(func, args, "matrix");
+}
+
+Instruction *JointMatrixFuncsResolutionPass::CreateBlock2DStore
+        (CallInst *CI, Value *matVal, const JointMatrixBlock2DShape *shape)
+{
+    Module *M = CI->getParent()->getModule();
+    IRBuilder<> builder(CI);
+
+    SmallVector<Value *, 13> args;
+    getBlock2DArgs(builder, CI->getArgOperand(0), shape, args);
+    args.push_back(matVal);
+
+    Function *func = GenISAIntrinsic::getDeclaration(M, GenISAIntrinsic::GenISA_LSC2DBlockWrite, matVal->getType());
+    return builder.CreateCall(func, args);
+}
+
 Instruction *JointMatrixFuncsResolutionPass::ResolveLoad(CallInst *CI)
 {
     Value *ptrVal        = CI->getArgOperand(0);
@@ -281,13 +453,19 @@ Instruction *JointMatrixFuncsResolutionPass::ResolveLoad(CallInst *CI)
 
     Module *M = CI->getParent()->getModule();
 
-    std::string funcName = GetLoadStoreMatrixFuncName(true, loadLayout, &desc);
-    FunctionType *funcType = FunctionType::get(retTy, { ptrVal->getType(), strideVal->getType() }, false);
-    std::vector<Value *> Args = { ptrVal, strideVal };
-
     InstsToErase.insert(CI);
 
-    Instruction *newCall = CallInst::Create(M->getOrInsertFunction(funcName, funcType), Args, "matrix", CI);
+    Instruction *newCall = nullptr;
+    JointMatrixBlock2DShape shape;
+    if (GetBlock2DShape(true, loadLayout, &desc, retTy, ptrVal, strideVal, &shape)) {
+        newCall = CreateBlock2DLoad(CI, retTy, &shape);
+    } else {
+        std::string funcName = GetLoadStoreMatrixFuncName(true, loadLayout, &desc);
+        FunctionType *funcType = FunctionType::get(retTy, { ptrVal->getType(), strideVal->getType() }, false);
+        std::vector<Value *> Args = { ptrVal, strideVal };
+
+        newCall = CallInst::Create(M->getOrInsertFunction(funcName, funcType), Args, "matrix", CI);
+    }
     if (retTy != matTy) {
         newCall = BitCastInst::Create(Instruction::BitCast, newCall, matTy,"matrix.load.cast", CI);
     }
@@ -314,14 +492,19 @@ Instruction *JointMatrixFuncsResolutionPass::ResolveStore(CallInst *CI)
         matVal = BitCastInst::Create(Instruction::BitCast, matVal, matTy, "matrix.store.cast", CI);
     }
 
+    InstsToErase.insert(CI);
+
+    JointMatrixBlock2DShape shape;
+    if (GetBlock2DShape(false, storeLayout, &desc, matTy, ptrVal, strideVal, &shape)) {
+        return CreateBlock2DStore(CI, matVal, &shape);
+    }
+
     std::string funcName = GetLoadStoreMatrixFuncName(false, storeLayout, &desc);
     FunctionType *funcType =
         FunctionType::get(Type::getVoidTy(M->getContext()),
             { ptrVal->getType(), matTy, strideVal->getType() }, false);
     std::vector<Value *> Args = { ptrVal, matVal, strideVal };
 
-    InstsToErase.insert(CI);
-
     return CallInst::Create(M->getOrInsertFunction(funcName, funcType), Args, "", CI);
 }
 
@@ -19,6 +19,7 @@ SPDX-License-Identifier: MIT
 namespace IGC
 {
     struct JointMatrixTypeDescription;
+    struct JointMatrixBlock2DShape;
 
     class JointMatrixFuncsResolutionPass final
         : public llvm::FunctionPass
@@ -27,7 +28,7 @@ namespace IGC
     public:
         static char ID;
 
-        JointMatrixFuncsResolutionPass(OpenCLProgramContext *Context);
+        JointMatrixFuncsResolutionPass(OpenCLProgramContext *Context = nullptr);
         ~JointMatrixFuncsResolutionPass() {}
 
         virtual llvm::StringRef getPassName() const override
@@ -62,11 +63,19 @@ namespace IGC
         std::string GetLoadStoreMatrixFuncName
             (bool isLoad, unsigned operationLayout, const JointMatrixTypeDescription *desc);
 
+        bool GetBlock2DShape(bool isLoad, unsigned operationLayout, const JointMatrixTypeDescription *desc,
+            llvm::Type *matTy, llvm::Value *ptrVal, llvm::Value *strideVal, JointMatrixBlock2DShape *outShape);
+        llvm::Instruction *CreateBlock2DLoad
+            (llvm::CallInst *CI, llvm::Type *retTy, const JointMatrixBlock2DShape *shape);
+        llvm::Instruction *CreateBlock2DStore
+            (llvm::CallInst *CI, llvm::Value *matVal, const JointMatrixBlock2DShape *shape);
+
         llvm::ValueMap<llvm::Value *, llvm::Value *> ResolvedValues;
         llvm::SmallPtrSet<llvm::Instruction *, 8> InstsToErase;
 
         ModuleMetaData* MMD = nullptr;
-        OpenCLProgramContext* Context = nullptr;
+        CodeGenContext* Context = nullptr;
+        const llvm::DataLayout* DL = nullptr;
         bool Changed = false;
     };
 };
@@ -325,6 +325,8 @@ void InlineLocalsResolution::collectInfoOnSharedLocalMem(Module& M)
             maxWorkGroupSize = std::min(maxWS, 1024u);
         }
 
+        MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+
         // scan inst to collect all call instructions
 
         for (Function& F : M)
@@ -334,6 +336,26 @@ void InlineLocalsResolution::collectInfoOnSharedLocalMem(Module& M)
                 continue;
             }
 
+            // A required work-group size bounds the pool better than the
+            // platform maximum, and a required subgroup size tells how many
+            // subgroups the work-group splits into.
+            unsigned int workGroupSize = maxWorkGroupSize;
+            unsigned int minSubGroupSize = 8;
+            if (isEntryFunc(pMdUtils, &F))
+            {
+                const unsigned int requiredWorkGroupSize = IGCMetaDataHelper::getThreadGroupSize(*pMdUtils, &F);
+                if (requiredWorkGroupSize != 0)
+                {
+                    workGroupSize = std::min(workGroupSize, requiredWorkGroupSize);
+                }
+                const int requiredSubGroupSize =
+                    pMdUtils->getFunctionsInfoItem(&F)->getSubGroupSize()->getSIMD_size();
+                if (requiredSubGroupSize > 0)
+                {
+                    minSubGroupSize = unsigned(requiredSubGroupSize);
+                }
+            }
+
             unsigned maxBytesOnFunc = 0;
             for (auto I = inst_begin(&F), IE = inst_end(&F); I != IE; ++I)
             {
@@ -352,10 +374,15 @@ void InlineLocalsResolution::collectInfoOnSharedLocalMem(Module& M)
                         const unsigned int numAdditionalElements = unsigned(cast<ConstantInt>(CI->getArgOperand(1))->getZExtValue());
                         const unsigned int elementSize = unsigned(cast<ConstantInt>(CI->getArgOperand(2))->getZExtValue());
 
+                        // 1 - one element per work item, 2 - one element per subgroup
                         unsigned int numElements = numAdditionalElements;
-                        if (allocAllWorkgroups)
+                        if (allocAllWorkgroups == 2)
+                        {
+                            numElements += (workGroupSize + minSubGroupSize - 1) / minSubGroupSize;
+                        }
+                        else if (allocAllWorkgroups)
                         {
-                            numElements += maxWorkGroupSize;
+                            numElements += workGroupSize;
                         }
                         const unsigned int size = numElements * elementSize;
                         const unsigned int align = elementSize;
@@ -0,0 +1,337 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "Compiler/Optimizer/OpenCLPasses/ProfileFeedback/ProfileFeedback.hpp"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Transforms/Utils/FunctionComparator.h>
+#include "common/LLVMWarningsPop.hpp"
+#include "Probe/Assertion.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+static const char* const ProfileCountMDName = "igc.profile.count";
+
+uint64_t IGC::getProfileHash(const Function& F)
+{
+    return FunctionComparator::functionHash(const_cast<Function&>(F));
+}
+
+int64_t IGC::getProfileBlockCount(const BasicBlock* BB)
+{
+    const Instruction* term = BB->getTerminator();
+    MDNode* node = term ? term->getMetadata(ProfileCountMDName) : nullptr;
+    if (!node)
+    {
+        return -1;
+    }
+    ConstantInt* count = mdconst::extract<ConstantInt>(node->getOperand(0));
+    return (int64_t)std::min<uint64_t>(count->getZExtValue(), (uint64_t)std::numeric_limits<int64_t>::max());
+}
+
+// Register pass to igc-opt
+#define PASS_FLAG "igc-profile-feedback-annotation"
+#define PASS_DESCRIPTION "Attach profile feedback to kernels"
+#define PASS_CFG_ONLY true
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(ProfileFeedbackAnnotation, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_END(ProfileFeedbackAnnotation, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+char ProfileFeedbackAnnotation::ID = 0;
+
+ProfileFeedbackAnnotation::ProfileFeedbackAnnotation(const std::string& path)
+    : ModulePass(ID), m_path(path)
+{
+    initializeProfileFeedbackAnnotationPass(*PassRegistry::getPassRegistry());
+}
+
+void ProfileFeedbackAnnotation::getAnalysisUsage(AnalysisUsage& AU) const
+{
+    AU.setPreservesAll();
+    AU.addRequired<CodeGenContextWrapper>();
+    AU.addRequired<MetaDataUtilsWrapper>();
+}
+
+bool ProfileFeedbackAnnotation::runOnModule(Module& M)
+{
+    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+
+    ProfileFeedback profiles;
+    std::string error;
+    if (!profiles.read(m_path, error))
+    {
+        ctx->EmitWarning(error.c_str());
+        return false;
+    }
+
+    bool changed = false;
+    for (Function& F : M)
+    {
+        if (F.isDeclaration() || !isEntryFunc(pMdUtils, &F))
+        {
+            continue;
+        }
+        const KernelProfile* profile = profiles.getKernelProfile(F.getName());
+        if (!profile)
+        {
+            continue;
+        }
+        if (!annotate(F, *profile))
+        {
+            std::string warning = "profile feedback for " + F.getName().str() +
+                " does not match the kernel and is ignored";
+            ctx->EmitWarning(warning.c_str());
+            continue;
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+bool ProfileFeedbackAnnotation::annotate(Function& F, const KernelProfile& profile)
+{
+    if (!profile.matches(getProfileHash(F), F.size()))
+    {
+        return false;
+    }
+
+    SmallVector<BasicBlock*, 32> blocks;
+    DenseMap<const BasicBlock*, uint32_t> blockIndex;
+    for (BasicBlock& BB : F)
+    {
+        blockIndex[&BB] = blocks.size();
+        blocks.push_back(&BB);
+    }
+
+    LLVMContext& C = F.getContext();
+    MDBuilder MDB(C);
+    F.setEntryCount(Function::ProfileCount(profile.entryCount, Function::PCT_Real));
+
+    for (auto& BI : profile.blockCounts)
+    {
+        Instruction* term = blocks[BI.first]->getTerminator();
+        if (term)
+        {
+            Metadata* count = ConstantAsMetadata::get(ConstantInt::get(Type::getInt64Ty(C), BI.second));
+            term->setMetadata(ProfileCountMDName, MDNode::get(C, count));
+        }
+    }
+
+    for (uint32_t i = 0; i < blocks.size(); ++i)
+    {
+        Instruction* term = blocks[i]->getTerminator();
+        if (!term || term->getNumSuccessors() < 2 ||
+            (!isa<BranchInst>(term) && !isa<SwitchInst>(term)))
+        {
+            continue;
+        }
+
+        std::vector<uint64_t> weights;
+        auto explicitWeights = profile.branchWeights.find(i);
+        if (explicitWeights != profile.branchWeights.end())
+        {
+            weights = explicitWeights->second;
+        }
+        else
+        {
+            // A successor with a single predecessor runs exactly as often
+            // as its incoming edge is taken.
+            for (unsigned s = 0; s < term->getNumSuccessors(); ++s)
+            {
+                BasicBlock* succ = term->getSuccessor(s);
+                auto count = profile.blockCounts.find(blockIndex[succ]);
+                if (succ->getSinglePredecessor() != blocks[i] || count == profile.blockCounts.end())
+                {
+                    weights.clear();
+                    break;
+                }
+                weights.push_back(count->second);
+            }
+        }
+        if (weights.size() != term->getNumSuccessors())
+        {
+            continue;
+        }
+
+        // Branch weights are 32 bit; scale them down keeping the ratios.
+        uint64_t maxWeight = *std::max_element(weights.begin(), weights.end());
+        if (maxWeight == 0)
+        {
+            continue;
+        }
+        uint64_t scale = maxWeight / std::numeric_limits<uint32_t>::max() + 1;
+        SmallVector<uint32_t, 4> scaled;
+        for (uint64_t weight : weights)
+        {
+            scaled.push_back((uint32_t)(weight / scale));
+        }
+        term->setMetadata(LLVMContext::MD_prof, MDB.createBranchWeights(scaled));
+    }
+    return true;
+}
+
+// Register pass to igc-opt
+#define PASS_FLAG2 "igc-profile-instrumentation"
+#define PASS_DESCRIPTION2 "Count block executions of kernels"
+#define PASS_CFG_ONLY2 false
+#define PASS_ANALYSIS2 false
+IGC_INITIALIZE_PASS_BEGIN(ProfileInstrumentation, PASS_FLAG2, PASS_DESCRIPTION2, PASS_CFG_ONLY2, PASS_ANALYSIS2)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+IGC_INITIALIZE_PASS_END(ProfileInstrumentation, PASS_FLAG2, PASS_DESCRIPTION2, PASS_CFG_ONLY2, PASS_ANALYSIS2)
+
+char ProfileInstrumentation::ID = 0;
+
+ProfileInstrumentation::ProfileInstrumentation(const std::string& mapPath, uint64_t shaderHash)
+    : ModulePass(ID), m_mapPath(mapPath), m_shaderHash(shaderHash)
+{
+    initializeProfileInstrumentationPass(*PassRegistry::getPassRegistry());
+}
+
+void ProfileInstrumentation::getAnalysisUsage(AnalysisUsage& AU) const
+{
+    AU.setPreservesCFG();
+    AU.addRequired<CodeGenContextWrapper>();
+    AU.addRequired<MetaDataUtilsWrapper>();
+    AU.addRequired<LoopInfoWrapperPass>();
+}
+
+bool ProfileInstrumentation::runOnModule(Module& M)
+{
+    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+
+    std::string mapPath = getMapPath();
+    std::ofstream map(mapPath);
+    if (!map)
+    {
+        std::string warning = "cannot write profile map file " + mapPath +
+            ", kernels are not instrumented";
+        ctx->EmitWarning(warning.c_str());
+        return false;
+    }
+    map << "version " << ProfileFeedback::Version << "\n";
+
+    SmallVector<Function*, 8> kernels;
+    for (Function& F : M)
+    {
+        if (!F.isDeclaration() && isEntryFunc(pMdUtils, &F))
+        {
+            kernels.push_back(&F);
+        }
+    }
+    for (Function* F : kernels)
+    {
+        instrument(*F, map);
+    }
+    return !kernels.empty();
+}
+
+std::string ProfileInstrumentation::getMapPath() const
+{
+    if (m_shaderHash == 0)
+    {
+        return m_mapPath;
+    }
+    std::ostringstream hash;
+    hash << "_asm" << std::hex << std::setfill('0') << std::setw(16) << m_shaderHash;
+
+    SmallString<256> path(m_mapPath);
+    std::string ext = sys::path::extension(path).str();
+    sys::path::replace_extension(path, "");
+    path += hash.str() + ext;
+    return path.str().str();
+}
+
+// "<line> <file>" of the first instruction of BB with a debug location.
+static std::string getSourceLocation(const BasicBlock& BB)
+{
+    for (const Instruction& I : BB)
+    {
+        if (const DILocation* loc = I.getDebugLoc().get())
+        {
+            return std::to_string(loc->getLine()) + " " + loc->getFilename().str();
+        }
+    }
+    return "0 -";
+}
+
+void ProfileInstrumentation::instrument(Function& F, std::ostream& map)
+{
+    Module& M = *F.getParent();
+    LLVMContext& C = M.getContext();
+    LoopInfo& LI = getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
+
+    // Hash the kernel before it is instrumented, as the profile built from
+    // the counters is applied to the uninstrumented kernel.
+    uint64_t hash = getProfileHash(F);
+
+    Type* int64Ty = Type::getInt64Ty(C);
+    ArrayType* countersTy = ArrayType::get(int64Ty, F.size());
+    std::string symbol = "__igc_profile_counters_" + F.getName().str();
+    GlobalVariable* counters = new GlobalVariable(
+        M, countersTy, false, GlobalValue::ExternalLinkage,
+        ConstantAggregateZero::get(countersTy), symbol, nullptr,
+        GlobalValue::NotThreadLocal, ADDRESS_SPACE_GLOBAL);
+
+    // Resolved to a GenISA atomic by ResolveOCLAtomics.
+    PointerType* counterPtrTy = PointerType::get(int64Ty, ADDRESS_SPACE_GLOBAL);
+    FunctionType* atomicAddTy = FunctionType::get(int64Ty, { counterPtrTy, int64Ty }, false);
+    auto atomicAdd = M.getOrInsertFunction("__builtin_IB_atomic_add_global_i64", atomicAddTy);
+
+    map << "kernel " << F.getName().str() << " " << symbol << " "
+        << std::hex << hash << std::dec << " " << F.size() << "\n";
+
+    uint32_t index = 0;
+    for (BasicBlock& BB : F)
+    {
+        // Keep the allocas of the entry block together at its top.
+        BasicBlock::iterator insertPt = BB.getFirstInsertionPt();
+        while (isa<AllocaInst>(*insertPt))
+        {
+            ++insertPt;
+        }
+
+        IRBuilder<> builder(&BB, insertPt);
+        Value* counter = builder.CreateConstInBoundsGEP2_32(countersTy, counters, 0, index);
+        builder.CreateCall(atomicAdd, { counter, builder.getInt64(1) });
+
+        map << "block " << index << " " << getSourceLocation(BB) << "\n";
+        Loop* L = LI.getLoopFor(&BB);
+        if (L && L->getHeader() == &BB)
+        {
+            map << "loop " << index << " " << L->getLoopDepth() << "\n";
+        }
+        ++index;
+    }
+}
@@ -0,0 +1,145 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include <llvm/ADT/StringRef.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace llvm
+{
+    class BasicBlock;
+    class Function;
+}
+
+namespace IGC
+{
+    /// Measured execution counts of one kernel.
+    ///
+    /// Blocks are identified by their position in the function at the point
+    /// of the pipeline where profiles are collected and applied (see
+    /// ProfileFeedbackAnnotation), so a profile only matches the same source
+    /// compiled with the same options. The kernel's hash (getProfileHash)
+    /// and block count at that point are recorded to reject stale profiles.
+    struct KernelProfile
+    {
+        uint64_t hash = 0;
+        uint64_t entryCount = 0;
+        uint32_t numBlocks = 0;
+        std::map<uint32_t, uint64_t> blockCounts;
+        // Per block, the weight of each successor of its terminator.
+        std::map<uint32_t, std::vector<uint64_t>> branchWeights;
+
+        bool matches(uint64_t kernelHash, uint32_t kernelBlocks) const;
+    };
+
+    /// Profile feedback file. It is a text file with one record per line;
+    /// '#' starts a comment:
+    ///
+    ///   version 2
+    ///   kernel <name> <hash> <entry count> <number of blocks>
+    ///   block <block index> <execution count>
+    ///   branch <block index> <successor 0 weight> <successor 1 weight> ...
+    ///
+    /// The hash is in hex, all other numbers are decimal. block and branch
+    /// records belong to the last kernel record. Branch
+    /// weights may be omitted; they are then derived from the counts of
+    /// successors that have a single predecessor.
+    class ProfileFeedback
+    {
+    public:
+        static constexpr uint32_t Version = 2;
+
+        bool read(const std::string& path, std::string& error);
+        bool parse(llvm::StringRef text, std::string& error);
+        void write(std::ostream& os) const;
+
+        const KernelProfile* getKernelProfile(llvm::StringRef name) const;
+        KernelProfile& getOrCreateKernelProfile(llvm::StringRef name);
+
+        bool empty() const { return m_kernels.empty(); }
+
+    private:
+        std::map<std::string, KernelProfile> m_kernels;
+    };
+
+    /// Attaches a profile feedback file to the kernels of the module:
+    /// function entry counts, !prof branch weights, and the execution count
+    /// of each block as "igc.profile.count" metadata on its terminator.
+    class ProfileFeedbackAnnotation : public llvm::ModulePass
+    {
+    public:
+        static char ID;
+
+        ProfileFeedbackAnnotation(const std::string& path = "");
+
+        virtual llvm::StringRef getPassName() const override
+        {
+            return "ProfileFeedbackAnnotation";
+        }
+
+        virtual void getAnalysisUsage(llvm::AnalysisUsage& AU) const override;
+
+        virtual bool runOnModule(llvm::Module& M) override;
+
+    private:
+        bool annotate(llvm::Function& F, const KernelProfile& profile);
+
+        std::string m_path;
+    };
+
+    /// Counts how many work items execute each block of each kernel, for
+    /// profiling builds. Kernel K gets a zero initialized program scope
+    /// global "__igc_profile_counters_K" with one 64-bit counter per block,
+    /// in the block order ProfileFeedbackAnnotation uses, which the host
+    /// reads back through the global's symbol. The block layout and the
+    /// source line of each block are written to a map file, which
+    /// IGC/tools/profile_counters.py combines with the counter values.
+    ///
+    /// Each build writes its own map file: the shader hash is added to the
+    /// given name, as in shader dumps (prof.map -> prof_asm<hash>.map).
+    class ProfileInstrumentation : public llvm::ModulePass
+    {
+    public:
+        static char ID;
+
+        ProfileInstrumentation(const std::string& mapPath = "", uint64_t shaderHash = 0);
+
+        virtual llvm::StringRef getPassName() const override
+        {
+            return "ProfileInstrumentation";
+        }
+
+        virtual void getAnalysisUsage(llvm::AnalysisUsage& AU) const override;
+
+        virtual bool runOnModule(llvm::Module& M) override;
+
+    private:
+        void instrument(llvm::Function& F, std::ostream& map);
+        std::string getMapPath() const;
+
+        std::string m_mapPath;
+        uint64_t m_shaderHash;
+    };
+
+    /// Structural hash of F (block structure, opcodes and types, not names),
+    /// stored in profiles to check that they were collected on the same IR.
+    uint64_t getProfileHash(const llvm::Function& F);
+
+    /// Execution count of BB recorded by ProfileFeedbackAnnotation, or -1
+    /// if there is none.
+    int64_t getProfileBlockCount(const llvm::BasicBlock* BB);
+} // namespace IGC
@@ -0,0 +1,149 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Reading and writing of profile feedback files. Kept apart from the passes
+// so that it only depends on LLVMSupport.
+
+#include "Compiler/Optimizer/OpenCLPasses/ProfileFeedback/ProfileFeedback.hpp"
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <ios>
+
+using namespace llvm;
+using namespace IGC;
+
+bool KernelProfile::matches(uint64_t kernelHash, uint32_t kernelBlocks) const
+{
+    return hash == kernelHash && numBlocks == kernelBlocks;
+}
+
+bool ProfileFeedback::read(const std::string& path, std::string& error)
+{
+    ErrorOr<std::unique_ptr<MemoryBuffer>> buffer = MemoryBuffer::getFile(path);
+    if (!buffer)
+    {
+        error = "cannot read profile feedback file " + path;
+        return false;
+    }
+    return parse((*buffer)->getBuffer(), error);
+}
+
+bool ProfileFeedback::parse(StringRef text, std::string& error)
+{
+    KernelProfile* current = nullptr;
+    unsigned lineNo = 0;
+    while (!text.empty())
+    {
+        StringRef line;
+        std::tie(line, text) = text.split('\n');
+        ++lineNo;
+        line = line.split('#').first.trim();
+        if (line.empty())
+        {
+            continue;
+        }
+
+        SmallVector<StringRef, 8> tokens;
+        line.split(tokens, ' ', -1, false);
+        auto fail = [&](const char* msg) {
+            error = "profile feedback line " + std::to_string(lineNo) + ": " + msg;
+            return false;
+        };
+
+        StringRef kind = tokens[0];
+        if (kind == "version")
+        {
+            uint32_t version = 0;
+            if (tokens.size() != 2 || tokens[1].getAsInteger(10, version))
+                return fail("expected 'version <n>'");
+            if (version != Version)
+                return fail("unsupported version");
+        }
+        else if (kind == "kernel")
+        {
+            KernelProfile profile;
+            if (tokens.size() != 5 ||
+                tokens[2].getAsInteger(16, profile.hash) ||
+                tokens[3].getAsInteger(10, profile.entryCount) ||
+                tokens[4].getAsInteger(10, profile.numBlocks))
+                return fail("expected 'kernel <name> <hash> <entry count> <number of blocks>'");
+            current = &getOrCreateKernelProfile(tokens[1]);
+            *current = profile;
+        }
+        else if (kind == "block")
+        {
+            uint32_t index = 0;
+            uint64_t count = 0;
+            if (tokens.size() != 3 || tokens[1].getAsInteger(10, index) || tokens[2].getAsInteger(10, count))
+                return fail("expected 'block <index> <count>'");
+            if (!current || index >= current->numBlocks)
+                return fail("block record outside of a kernel or out of range");
+            current->blockCounts[index] = count;
+        }
+        else if (kind == "branch")
+        {
+            uint32_t index = 0;
+            if (tokens.size() < 3 || tokens[1].getAsInteger(10, index))
+                return fail("expected 'branch <index> <weight>...'");
+            if (!current || index >= current->numBlocks)
+                return fail("branch record outside of a kernel or out of range");
+            std::vector<uint64_t>& weights = current->branchWeights[index];
+            weights.clear();
+            for (unsigned i = 2; i < tokens.size(); ++i)
+            {
+                uint64_t weight = 0;
+                if (tokens[i].getAsInteger(10, weight))
+                    return fail("invalid branch weight");
+                weights.push_back(weight);
+            }
+        }
+        else
+        {
+            return fail("unknown record");
+        }
+    }
+    return true;
+}
+
+void ProfileFeedback::write(std::ostream& os) const
+{
+    os << "version " << Version << "\n";
+    for (auto& KI : m_kernels)
+    {
+        const KernelProfile& profile = KI.second;
+        os << "kernel " << KI.first << " " << std::hex << profile.hash << std::dec << " "
+            << profile.entryCount << " " << profile.numBlocks << "\n";
+        for (auto& BI : profile.blockCounts)
+        {
+            os << "block " << BI.first << " " << BI.second << "\n";
+        }
+        for (auto& BI : profile.branchWeights)
+        {
+            os << "branch " << BI.first;
+            for (uint64_t weight : BI.second)
+            {
+                os << " " << weight;
+            }
+            os << "\n";
+        }
+    }
+}
+
+const KernelProfile* ProfileFeedback::getKernelProfile(StringRef name) const
+{
+    auto it = m_kernels.find(name.str());
+    return it == m_kernels.end() ? nullptr : &it->second;
+}
+
+KernelProfile& ProfileFeedback::getOrCreateKernelProfile(StringRef name)
+{
+    return m_kernels[name.str()];
+}
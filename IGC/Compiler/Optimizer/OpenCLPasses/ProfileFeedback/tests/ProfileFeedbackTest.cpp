@@ -0,0 +1,135 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Tests of the profile feedback file parser: well formed files, profiles
+// that don't match the kernel they are applied to, and malformed input.
+
+#include "Compiler/Optimizer/OpenCLPasses/ProfileFeedback/ProfileFeedback.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace IGC;
+
+static unsigned g_numErrors = 0;
+
+static void check(bool cond, const std::string& what)
+{
+    if (!cond)
+    {
+        std::cerr << "FAIL: " << what << "\n";
+        ++g_numErrors;
+    }
+}
+
+static const char* const ValidProfile =
+    "# comment line\n"
+    "version 2\n"
+    "kernel foo 1f2e3d4c5b6a7988 256 4   # trailing comment\n"
+    "block 0 256\n"
+    "block 1 200\n"
+    "block 3 256\n"
+    "branch 0 200 56\n"
+    "\n"
+    "kernel bar abc 1 1\n"
+    "block 0 1\n";
+
+static void testValid()
+{
+    ProfileFeedback profiles;
+    std::string error;
+    check(profiles.parse(ValidProfile, error), "valid: parses (" + error + ")");
+
+    const KernelProfile* foo = profiles.getKernelProfile("foo");
+    check(foo != nullptr, "valid: has kernel foo");
+    if (foo)
+    {
+        check(foo->hash == 0x1f2e3d4c5b6a7988ull, "valid: foo hash");
+        check(foo->entryCount == 256, "valid: foo entry count");
+        check(foo->numBlocks == 4, "valid: foo block count");
+        check(foo->blockCounts.size() == 3 && foo->blockCounts.at(1) == 200,
+            "valid: foo block counts");
+        check(foo->branchWeights.size() == 1 &&
+            foo->branchWeights.at(0) == std::vector<uint64_t>({ 200, 56 }),
+            "valid: foo branch weights");
+    }
+    const KernelProfile* bar = profiles.getKernelProfile("bar");
+    check(bar != nullptr && bar->hash == 0xabc && bar->blockCounts.at(0) == 1,
+        "valid: records follow the last kernel");
+
+    // What write() produces reads back the same.
+    std::ostringstream os;
+    profiles.write(os);
+    ProfileFeedback reread;
+    check(reread.parse(os.str(), error), "valid: written file parses (" + error + ")");
+    const KernelProfile* foo2 = reread.getKernelProfile("foo");
+    check(foo2 != nullptr && foo && foo2->hash == foo->hash &&
+        foo2->entryCount == foo->entryCount && foo2->blockCounts == foo->blockCounts &&
+        foo2->branchWeights == foo->branchWeights,
+        "valid: write/parse round trip");
+}
+
+static void testMismatched()
+{
+    ProfileFeedback profiles;
+    std::string error;
+    check(profiles.parse(ValidProfile, error), "mismatched: parses (" + error + ")");
+
+    check(profiles.getKernelProfile("baz") == nullptr, "mismatched: unknown kernel");
+    const KernelProfile* foo = profiles.getKernelProfile("foo");
+    check(foo != nullptr, "mismatched: has kernel foo");
+    if (foo)
+    {
+        check(foo->matches(0x1f2e3d4c5b6a7988ull, 4), "mismatched: same hash and blocks match");
+        check(!foo->matches(0x1f2e3d4c5b6a7989ull, 4), "mismatched: other hash, same blocks");
+        check(!foo->matches(0x1f2e3d4c5b6a7988ull, 5), "mismatched: same hash, other blocks");
+    }
+}
+
+static void expectError(const char* text, const char* expected, const char* what)
+{
+    ProfileFeedback profiles;
+    std::string error;
+    bool parsed = profiles.parse(text, error);
+    check(!parsed, std::string("malformed: ") + what + " is rejected");
+    check(error.find(expected) != std::string::npos,
+        std::string("malformed: ") + what + " reports '" + expected + "', got '" + error + "'");
+}
+
+static void testMalformed()
+{
+    expectError("version 1\n", "line 1: unsupported version", "old version");
+    expectError("version\n", "line 1: expected 'version <n>'", "missing version");
+    expectError("version 2\nkernel foo 256 4\n", "line 2: expected 'kernel", "kernel without hash");
+    expectError("version 2\nkernel foo xyz 256 4\n", "line 2: expected 'kernel", "invalid hash");
+    expectError("version 2\nkernel foo 12 -1 4\n", "line 2: expected 'kernel", "negative count");
+    expectError("version 2\nblock 0 1\n", "line 2: block record outside", "block before kernel");
+    expectError("version 2\nkernel foo 12 1 2\nblock 2 1\n", "line 3: block record outside",
+        "block out of range");
+    expectError("version 2\nkernel foo 12 1 2\nbranch 0\n", "line 3: expected 'branch",
+        "branch without weights");
+    expectError("version 2\nkernel foo 12 1 2\nbranch 0 1 x\n", "line 3: invalid branch weight",
+        "invalid branch weight");
+    expectError("version 2\nloop 0 1\n", "line 2: unknown record", "unknown record");
+}
+
+int main()
+{
+    testValid();
+    testMismatched();
+    testMalformed();
+
+    if (g_numErrors)
+    {
+        std::cerr << g_numErrors << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "PASSED\n";
+    return 0;
+}
@@ -11,16 +11,19 @@ SPDX-License-Identifier: MIT
 #include "Compiler/Optimizer/CodeAssumption.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/StatelessToStateful/StatelessToStateful.hpp"
 #include "common/Stats.hpp"
+#include "common/debug/Debug.hpp"
 #include "common/secure_string.h"
 #include "common/LLVMWarningsPush.hpp"
 #include "llvmWrapper/IR/Instructions.h"
 #include "llvmWrapper/Support/Alignment.h"
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/GetElementPtrTypeIterator.h>
 #include <llvm/Analysis/ValueTracking.h>
 #include "common/LLVMWarningsPop.hpp"
 #include <string>
+#include <fstream>
 #include "Probe/Assertion.h"
 
 using namespace llvm;
@@ -35,6 +38,7 @@ using namespace IGC::IGCMD;
 IGC_INITIALIZE_PASS_BEGIN(StatelessToStateful, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_DEPENDENCY(AssumptionCacheTracker)
+IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
 IGC_INITIALIZE_PASS_END(StatelessToStateful, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 // This pass turns a global/constants address space (stateless) load/store into a stateful a load/store.
@@ -111,6 +115,21 @@ IGC_INITIALIZE_PASS_END(StatelessToStateful, PASS_FLAG, PASS_DESCRIPTION, PASS_C
 //                 To assume all offsets are positive (all BUFFER_OFFSET = 0). Thus, no need to
 //                 have implicit BUFFER_OFFSET arguments at all.
 //
+//  Tracing across spills and calls (igc key: EnableStatelessToStatefulAcrossCalls)
+//    A pointer that is stored to a private slot and loaded back is traced through the slot
+//    if the slot is written exactly once, by a store that dominates the load, and the
+//    alloca holding it does not escape. For example, a kernel argument kept in a private
+//    struct is still promoted.
+//
+//    A function that is only called directly by a single kernel (subroutine or stack call)
+//    is processed too, using that kernel's binding table. A pointer argument of the function
+//    is treated as a kernel argument if every call site passes that kernel argument itself.
+//    Since BUFFER_OFFSET is only available in the kernel, this is done only if buffer offsets
+//    are zero, i.e. there is no BUFFER_OFFSET or SToSProducesPositivePointer holds.
+//
+//    igc key: EnableOptReportStatelessToStateful writes every promoted access, with the
+//    kernel argument it is based on, to StatelessToStateful.opt.
+//
 
 // Future things to look out for:
 //  - This transformation cannot be done if a pointer is stored to or loaded from memory
@@ -135,6 +154,9 @@ StatelessToStateful::StatelessToStateful(bool hasBufOff)
     m_hasSubDWAlignedPtrArg(false),
     m_hasPositivePointerOffset(false),
     m_ACT(nullptr),
+    m_DT(nullptr),
+    m_kernel(nullptr),
+    m_throughSpill(false),
     m_pImplicitArgs(nullptr),
     m_pKernelArgs(nullptr),
     m_changed(false)
@@ -149,8 +171,13 @@ bool StatelessToStateful::runOnFunction(llvm::Function& F)
 
     // skip device enqueue tests for now to avoid tracking binding tables acorss
     // enqueued blocks.
-    if ((F.getParent()->getNamedMetadata("igc.device.enqueue") != nullptr) ||
-        !isEntryFunc(pMdUtils, &F))
+    if (F.getParent()->getNamedMetadata("igc.device.enqueue") != nullptr)
+    {
+        return false;
+    }
+
+    m_kernel = isEntryFunc(pMdUtils, &F) ? &F : getCallerKernel(F, pMdUtils);
+    if (m_kernel == nullptr)
     {
         return false;
     }
@@ -175,19 +202,91 @@ bool StatelessToStateful::runOnFunction(llvm::Function& F)
 
     m_hasPositivePointerOffset = (IGC_IS_FLAG_ENABLED(SToSProducesPositivePointer) || modMD->compOpt.HasPositivePointerOffset);
 
-    m_pImplicitArgs = new ImplicitArgs(F, pMdUtils);
+    // BUFFER_OFFSET of the kernel is not visible in a callee.
+    if (m_kernel != &F && m_hasBufferOffsetArg && !m_hasPositivePointerOffset)
+    {
+        return false;
+    }
+
+    m_DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+
+    m_pImplicitArgs = new ImplicitArgs(*m_kernel, pMdUtils);
     CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
-    m_pKernelArgs = new KernelArgs(F, &(F.getParent()->getDataLayout()), pMdUtils, modMD, ctx->platform.getGRFSize());
+    m_pKernelArgs = new KernelArgs(*m_kernel, &(F.getParent()->getDataLayout()), pMdUtils, modMD, ctx->platform.getGRFSize());
 
-    visit(F);
+    if (m_kernel != &F)
+    {
+        mapCalleeArgs(F);
+    }
+    if (m_kernel == &F || !m_calleeArgs.empty())
+    {
+        visit(F);
+    }
 
     finalizeArgInitialValue(&F);
+    emitOptReport();
     delete m_pImplicitArgs;
     delete m_pKernelArgs;
-    m_promotedKernelArgs.clear();
+    m_calleeArgs.clear();
     return m_changed;
 }
 
+Function* StatelessToStateful::getCallerKernel(Function& F, MetaDataUtils* pMdUtils)
+{
+    if (IGC_IS_FLAG_DISABLED(EnableStatelessToStatefulAcrossCalls) ||
+        F.isDeclaration() || F.hasFnAttribute("referenced-indirectly") || F.use_empty())
+    {
+        return nullptr;
+    }
+
+    Function* kernel = nullptr;
+    for (User* U : F.users())
+    {
+        CallInst* CI = dyn_cast<CallInst>(U);
+        if (!CI || CI->getCalledFunction() != &F)
+        {
+            return nullptr;
+        }
+        Function* caller = CI->getParent()->getParent();
+        if ((kernel && caller != kernel) || !isEntryFunc(pMdUtils, caller))
+        {
+            return nullptr;
+        }
+        kernel = caller;
+    }
+    return kernel;
+}
+
+void StatelessToStateful::mapCalleeArgs(Function& F)
+{
+    for (Argument& arg : F.args())
+    {
+        PointerType* ptrTy = dyn_cast<PointerType>(arg.getType());
+        if (!ptrTy || (ptrTy->getAddressSpace() != ADDRESS_SPACE_GLOBAL &&
+            ptrTy->getAddressSpace() != ADDRESS_SPACE_CONSTANT))
+        {
+            continue;
+        }
+
+        const KernelArg* kernelArg = nullptr;
+        for (User* U : F.users())
+        {
+            Value* actual = cast<CallInst>(U)->getArgOperand(arg.getArgNo())->stripPointerCasts();
+            const KernelArg* KA = getKernelArgFromPtr(*ptrTy, actual);
+            if (KA == nullptr || (kernelArg && KA != kernelArg))
+            {
+                kernelArg = nullptr;
+                break;
+            }
+            kernelArg = KA;
+        }
+        if (kernelArg && !kernelArg->isImplicitArg())
+        {
+            m_calleeArgs[&arg] = kernelArg;
+        }
+    }
+}
+
 Argument* StatelessToStateful::getBufferOffsetArg(Function* F, uint32_t ArgNumber)
 {
     uint32_t nImplicitArgs = m_pImplicitArgs->size();
@@ -335,18 +434,126 @@ const KernelArg* StatelessToStateful::getKernelArgFromPtr(const PointerType& ptr
     return nullptr;
 }
 
-bool StatelessToStateful::pointerIsFromKernelArgument(Value& ptr)
+Value* StatelessToStateful::getSpilledPointer(LoadInst* LI)
 {
-    // find the last gep
-    Value* base = ptr.stripPointerCasts();
-    // gep : the last gep of pointer address, null if no GEP at all.
-    GetElementPtrInst* gep = nullptr;
-    while (isa<GetElementPtrInst>(base)) {
-        gep = static_cast<GetElementPtrInst*>(base);
-        base = gep->getPointerOperand()->stripPointerCasts();
+    if (IGC_IS_FLAG_DISABLED(EnableStatelessToStatefulAcrossCalls) ||
+        !LI->isSimple() || LI->getPointerAddressSpace() != ADDRESS_SPACE_PRIVATE)
+    {
+        return nullptr;
     }
 
-    if (!m_supportNonGEPPtr && gep == nullptr)
+    const DataLayout& DL = LI->getModule()->getDataLayout();
+    Value* ldPtr = LI->getPointerOperand();
+    APInt ldOffset(DL.getIndexTypeSizeInBits(ldPtr->getType()), 0);
+    AllocaInst* AI = dyn_cast<AllocaInst>(ldPtr->stripAndAccumulateInBoundsConstantOffsets(DL, ldOffset));
+    if (AI == nullptr)
+    {
+        return nullptr;
+    }
+    const int64_t ldStart = ldOffset.getSExtValue();
+    const int64_t ldEnd = ldStart + (int64_t)DL.getTypeStoreSize(LI->getType());
+
+    // Find the only store that writes the loaded bytes. Give up if the
+    // address of the alloca escapes or is used by anything else than
+    // loads, stores and lifetime markers.
+    StoreInst* spill = nullptr;
+    SmallVector<std::pair<Value*, int64_t>, 8> worklist;
+    worklist.push_back(std::make_pair(AI, 0));
+    while (!worklist.empty())
+    {
+        Value* ptr = worklist.back().first;
+        int64_t offset = worklist.back().second;
+        worklist.pop_back();
+        for (User* U : ptr->users())
+        {
+            if (isa<BitCastInst>(U))
+            {
+                worklist.push_back(std::make_pair(U, offset));
+            }
+            else if (GetElementPtrInst* GEP = dyn_cast<GetElementPtrInst>(U))
+            {
+                APInt gepOffset(DL.getIndexTypeSizeInBits(GEP->getType()), 0);
+                if (!GEP->accumulateConstantOffset(DL, gepOffset))
+                {
+                    return nullptr;
+                }
+                worklist.push_back(std::make_pair(U, offset + gepOffset.getSExtValue()));
+            }
+            else if (isa<LoadInst>(U))
+            {
+                continue;
+            }
+            else if (StoreInst* SI = dyn_cast<StoreInst>(U))
+            {
+                if (SI->getValueOperand() == ptr)
+                {
+                    return nullptr;
+                }
+                const int64_t stEnd = offset + (int64_t)DL.getTypeStoreSize(SI->getValueOperand()->getType());
+                if (stEnd <= ldStart || offset >= ldEnd)
+                {
+                    continue;
+                }
+                if (spill || offset != ldStart || stEnd != ldEnd || !SI->isSimple() ||
+                    !SI->getValueOperand()->getType()->isPointerTy())
+                {
+                    return nullptr;
+                }
+                spill = SI;
+            }
+            else if (IntrinsicInst* II = dyn_cast<IntrinsicInst>(U))
+            {
+                if (II->getIntrinsicID() != Intrinsic::lifetime_start &&
+                    II->getIntrinsicID() != Intrinsic::lifetime_end)
+                {
+                    return nullptr;
+                }
+            }
+            else
+            {
+                return nullptr;
+            }
+        }
+    }
+
+    if (spill == nullptr || !m_DT->dominates(spill, LI))
+    {
+        return nullptr;
+    }
+    return spill->getValueOperand();
+}
+
+Value* StatelessToStateful::getPointerBase(
+    Value* ptr, SmallVectorImpl<GetElementPtrInst*>& GEPs, bool& throughSpill)
+{
+    Value* base = ptr->stripPointerCasts();
+    while (true)
+    {
+        if (GetElementPtrInst* gep = dyn_cast<GetElementPtrInst>(base))
+        {
+            GEPs.push_back(gep);
+            base = gep->getPointerOperand()->stripPointerCasts();
+        }
+        else if (Value* spilled = isa<LoadInst>(base) ? getSpilledPointer(cast<LoadInst>(base)) : nullptr)
+        {
+            throughSpill = true;
+            base = spilled->stripPointerCasts();
+        }
+        else
+        {
+            break;
+        }
+    }
+    return base;
+}
+
+bool StatelessToStateful::pointerIsFromKernelArgument(Value& ptr)
+{
+    SmallVector<GetElementPtrInst*, 4> GEPs;
+    bool throughSpill = false;
+    Value* base = getPointerBase(&ptr, GEPs, throughSpill);
+
+    if (!m_supportNonGEPPtr && GEPs.empty())
         return false;
 
     if (getKernelArgFromPtr(*dyn_cast<PointerType>(ptr.getType()), base) != nullptr)
@@ -382,14 +589,10 @@ bool StatelessToStateful::pointerIsPositiveOffsetFromKernelArgument(
     }
 
     SmallVector<GetElementPtrInst*, 4> GEPs;
-    Value* base = V->stripPointerCasts();
+    m_throughSpill = false;
+    Value* base = getPointerBase(V, GEPs, m_throughSpill);
     // gep : the last gep of pointer address, null if no GEP at all.
-    GetElementPtrInst* gep = nullptr;
-    while (isa<GetElementPtrInst>(base)) {
-        gep = static_cast<GetElementPtrInst*>(base);
-        GEPs.push_back(gep);
-        base = gep->getPointerOperand()->stripPointerCasts();
-    }
+    GetElementPtrInst* gep = GEPs.empty() ? nullptr : GEPs.back();
 
     if (!m_supportNonGEPPtr && gep == nullptr)
     {
@@ -533,10 +736,10 @@ void StatelessToStateful::visitCallInst(CallInst& I)
             Value* offset = nullptr;
             unsigned int baseArgNumber  = 0;
             const KernelArg* kernelArg = nullptr;
-            if (m_promotedKernelArgs.size() < maxPromotionCount && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
+            if (belowPromotionLimit() && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
             {
                 ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-                FunctionMetaData* funcMD = &modMD->FuncMD[F];
+                FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
                 ResourceAllocMD* resAllocMD = &funcMD->resAllocMD;
                 IGC_ASSERT_MESSAGE(resAllocMD->argAllocMDList.size() > 0, "ArgAllocMDList is empty.");
                 ArgAllocMD* argAlloc = &resAllocMD->argAllocMDList[baseArgNumber];
@@ -555,6 +758,7 @@ void StatelessToStateful::visitCallInst(CallInst& I)
                         { Inst->getType(),pTy });
                     Instruction* simdMediaBlockRead = CallInst::Create(simdMediaBlockReadFunc, { pPtrToInt }, "", Inst);
                     simdMediaBlockRead->setDebugLoc(DL);
+                    reportPromotion(*Inst, kernelArg);
                     Inst->replaceAllUsesWith(simdMediaBlockRead);
                     Inst->eraseFromParent();
                     finalInst = simdMediaBlockRead;
@@ -584,6 +788,7 @@ void StatelessToStateful::visitCallInst(CallInst& I)
                             Inst);
                     }
                     pIntrinInst->setDebugLoc(DL);
+                    reportPromotion(*Inst, kernelArg);
                     Inst->replaceAllUsesWith(pIntrinInst);
                     Inst->eraseFromParent();
                     finalInst = pIntrinInst;
@@ -601,13 +806,14 @@ void StatelessToStateful::visitCallInst(CallInst& I)
                         { pTy,Inst->getOperand(1)->getType() });
                     Instruction* pIntrinInst = CallInst::Create(pFunc, args, "", Inst);
                     pIntrinInst->setDebugLoc(DL);
+                    reportPromotion(*Inst, kernelArg);
                     Inst->replaceAllUsesWith(pIntrinInst);
                     Inst->eraseFromParent();
                     finalInst = pIntrinInst;
                 }
 
                 m_changed = true;
-                m_promotedKernelArgs.insert(kernelArg);
+                recordPromotion(kernelArg);
             }
         }
 
@@ -646,7 +852,7 @@ void StatelessToStateful::visitCallInst(CallInst& I)
                 Value* ptr = finalInst->getOperand(0);
                 if (!pointerIsFromKernelArgument(*ptr)) {
                     ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-                    FunctionMetaData* funcMD = &modMD->FuncMD[finalInst->getParent()->getParent()];
+                    FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
                     if (isStoreIntrinsic(intrinID))
                         funcMD->hasNonKernelArgStore = true;
                     else if (isLoadIntrinsic(intrinID))
@@ -670,10 +876,10 @@ void StatelessToStateful::visitLoadInst(LoadInst& I)
     Value* offset = nullptr;
     unsigned int baseArgNumber = 0;
     const KernelArg* kernelArg = nullptr;
-    if (m_promotedKernelArgs.size() < maxPromotionCount && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
+    if (belowPromotionLimit() && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
     {
         ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-        FunctionMetaData* funcMD = &modMD->FuncMD[F];
+        FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
         ResourceAllocMD* resAllocMD = &funcMD->resAllocMD;
         IGC_ASSERT_MESSAGE(resAllocMD->argAllocMDList.size() > 0, "ArgAllocMDList is empty.");
         ArgAllocMD* argAlloc = &resAllocMD->argAllocMDList[baseArgNumber];
@@ -700,18 +906,19 @@ void StatelessToStateful::visitLoadInst(LoadInst& I)
             pLoad->setMetadata(LLVMContext::MD_invariant_load, node);
         }
 
+        reportPromotion(I, kernelArg);
         I.replaceAllUsesWith(pLoad);
         I.eraseFromParent();
 
         m_changed = true;
-        m_promotedKernelArgs.insert(kernelArg);
+        recordPromotion(kernelArg);
     }
 
     // check if there's non-kernel-arg load/store
     if (IGC_IS_FLAG_ENABLED(DumpHasNonKernelArgLdSt) &&
         ptr != nullptr && !pointerIsFromKernelArgument(*ptr)) {
         ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-        FunctionMetaData* funcMD = &modMD->FuncMD[F];
+        FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
         funcMD->hasNonKernelArgLoad = true;
     }
 }
@@ -727,14 +934,14 @@ void StatelessToStateful::visitStoreInst(StoreInst& I)
     Value* offset = nullptr;
     unsigned int baseArgNumber = 0;
     const KernelArg* kernelArg = nullptr;
-    if (m_promotedKernelArgs.size() < maxPromotionCount && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
+    if (belowPromotionLimit() && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
     {
         Value* dataVal = I.getOperand(0);
 
         if (dataVal != nullptr)
         {
             ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-            FunctionMetaData* funcMD = &modMD->FuncMD[F];
+            FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
             ResourceAllocMD* resAllocMD = &funcMD->resAllocMD;
             IGC_ASSERT_MESSAGE(resAllocMD->argAllocMDList.size() > 0, "ArgAllocMDList is empty.");
             ArgAllocMD* argAlloc = &resAllocMD->argAllocMDList[baseArgNumber];
@@ -751,17 +958,18 @@ void StatelessToStateful::visitStoreInst(StoreInst& I)
             Instruction* pStore = new StoreInst(dataVal, pPtrToInt, I.isVolatile(), IGCLLVM::getCorrectAlign(I.getAlignment()), I.getOrdering(), I.getSyncScopeID(), &I);
             pStore->setDebugLoc(DL);
 
+            reportPromotion(I, kernelArg);
             I.eraseFromParent();
 
             m_changed = true;
-            m_promotedKernelArgs.insert(kernelArg);
+            recordPromotion(kernelArg);
         }
     }
 
     if (IGC_IS_FLAG_ENABLED(DumpHasNonKernelArgLdSt) &&
         ptr != nullptr && !pointerIsFromKernelArgument(*ptr)) {
         ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-        FunctionMetaData* funcMD = &modMD->FuncMD[F];
+        FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
         funcMD->hasNonKernelArgStore = true;
     }
 }
@@ -830,6 +1038,60 @@ void StatelessToStateful::setPointerSizeTo32bit(int32_t AddrSpace, Module* M)
     M->setDataLayout(newStrDL);
 }
 
+bool StatelessToStateful::belowPromotionLimit()
+{
+    return m_promotedKernelArgs[m_kernel].size() < maxPromotionCount;
+}
+
+void StatelessToStateful::recordPromotion(const KernelArg* KA)
+{
+    m_promotedKernelArgs[m_kernel].insert(KA->getArg());
+}
+
+void StatelessToStateful::reportPromotion(Instruction& I, const KernelArg* KA)
+{
+    if (IGC_IS_FLAG_DISABLED(EnableOptReportStatelessToStateful))
+    {
+        return;
+    }
+    Function* F = I.getParent()->getParent();
+    m_optReport << "Function " << F->getName().str() << ": promoted ";
+    if (CallInst* CI = dyn_cast<CallInst>(&I))
+    {
+        m_optReport << CI->getCalledFunction()->getName().str();
+    }
+    else
+    {
+        m_optReport << I.getOpcodeName();
+    }
+    m_optReport << " based on arg " << KA->getAssociatedArgNo()
+        << " of kernel " << m_kernel->getName().str();
+    if (m_kernel != F)
+    {
+        m_optReport << " (passed through call)";
+    }
+    if (m_throughSpill)
+    {
+        m_optReport << " (reloaded from private memory)";
+    }
+    m_optReport << std::endl;
+}
+
+void StatelessToStateful::emitOptReport()
+{
+    if (m_optReport.tellp() <= 0)
+    {
+        return;
+    }
+    std::stringstream optReportFile;
+    optReportFile << IGC::Debug::GetShaderOutputFolder() << "StatelessToStateful.opt";
+
+    std::ofstream optReportStream;
+    optReportStream.open(optReportFile.str(), std::ios::app);
+    optReportStream << m_optReport.str();
+    m_optReport.str("");
+}
+
 void StatelessToStateful::updateArgInfo(
     const KernelArg* kernelArg, bool isPositive)
 {
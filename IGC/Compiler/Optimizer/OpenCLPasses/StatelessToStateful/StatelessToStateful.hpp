@@ -15,9 +15,13 @@ SPDX-License-Identifier: MIT
 #include <llvm/Pass.h>
 #include <llvm/IR/InstVisitor.h>
 #include <llvm/IR/Instruction.h>
+#include <llvm/IR/Dominators.h>
 #include <llvm/Analysis/AssumptionCache.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "Probe/Assertion.h"
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace IGC
 {
@@ -42,6 +46,7 @@ namespace IGC
             AU.setPreservesCFG();
             AU.addRequired<MetaDataUtilsWrapper>();
             AU.addRequired<llvm::AssumptionCacheTracker>();
+            AU.addRequired<llvm::DominatorTreeWrapperPass>();
             AU.addRequired<CodeGenContextWrapper>();
         }
 
@@ -52,6 +57,12 @@ namespace IGC
 
         virtual bool runOnFunction(llvm::Function& F) override;
 
+        virtual bool doFinalization(llvm::Module& M) override
+        {
+            m_promotedKernelArgs.clear();
+            return false;
+        }
+
         void visitLoadInst(llvm::LoadInst& I);
         void visitStoreInst(llvm::StoreInst& I);
         void visitCallInst(llvm::CallInst& I);
@@ -69,6 +80,29 @@ namespace IGC
         // check if the given pointer can be traced back to any kernel argument
         bool pointerIsFromKernelArgument(llvm::Value& ptr);
 
+        // Strip casts and GEPs off ptr, looking through private memory spills
+        // of the pointer. GEPs are collected in the reverse order of execution.
+        llvm::Value* getPointerBase(
+            llvm::Value* ptr, llvm::SmallVectorImpl<llvm::GetElementPtrInst*>& GEPs, bool& throughSpill);
+
+        // Return the pointer that was spilled to the private slot read by LI,
+        // or nullptr if that value cannot be determined.
+        llvm::Value* getSpilledPointer(llvm::LoadInst* LI);
+
+        // Return the kernel if F is only called directly from a single kernel.
+        llvm::Function* getCallerKernel(llvm::Function& F, IGCMD::MetaDataUtils* pMdUtils);
+        // Map the pointer arguments of F that receive the same kernel argument
+        // at every call site to that kernel argument.
+        void mapCalleeArgs(llvm::Function& F);
+
+        // Whether m_kernel has fewer than maxPromotionCount promoted args,
+        // counting the ones promoted in its callees.
+        bool belowPromotionLimit();
+        void recordPromotion(const KernelArg* KA);
+
+        void reportPromotion(llvm::Instruction& I, const KernelArg* KA);
+        void emitOptReport();
+
         bool getOffsetFromGEP(
             llvm::Function* F, llvm::SmallVector<llvm::GetElementPtrInst*, 4> GEPs,
             uint32_t argNumber, bool isImplicitArg, llvm::Value*& offset);
@@ -81,6 +115,10 @@ namespace IGC
         const KernelArg* getKernelArg(llvm::Value* Arg)
         {
             IGC_ASSERT_MESSAGE(m_pKernelArgs, "Should initialize it before use!");
+            auto CI = m_calleeArgs.find(Arg);
+            if (CI != m_calleeArgs.end()) {
+                return CI->second;
+            }
             for (const KernelArg& arg : *m_pKernelArgs) {
                 if (arg.getArg() == Arg) {
                     return &arg;
@@ -129,11 +167,26 @@ namespace IGC
                 : nullptr);
         }
 
+        llvm::DominatorTree* m_DT;
+
+        // The kernel whose arguments and binding table are used. It is the
+        // function being processed, or its only caller for a non-kernel.
+        llvm::Function* m_kernel;
+        // Arguments of a non-kernel function that always receive the same
+        // kernel argument.
+        llvm::DenseMap<const llvm::Value*, const KernelArg*> m_calleeArgs;
+        // Whether the pointer of the access being promoted was reloaded
+        // from private memory.
+        bool m_throughSpill;
+        std::stringstream m_optReport;
+
         ImplicitArgs* m_pImplicitArgs;
         KernelArgs* m_pKernelArgs;
         ArgInfoMap   m_argsInfo;
         bool m_changed;
-        std::unordered_set<const KernelArg*> m_promotedKernelArgs; // ptr args which have been promoted to stateful
+        // Kernel ptr args which have been promoted to stateful, per kernel.
+        // Kept across functions so that callees add to their kernel.
+        std::unordered_map<const llvm::Function*, std::unordered_set<const llvm::Argument*>> m_promotedKernelArgs;
     };
 
 }
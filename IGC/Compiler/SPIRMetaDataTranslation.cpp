@@ -318,6 +318,7 @@ bool SPIRMetaDataTranslation::runOnModule(Module& M)
                 DASH_G,
                 RELAXED_BUILTINS,
                 MATCH_SINCOSPI,
+                FAST_COMPILE_TIER0,
                 NONE,
             };
             int igc_compiler_option = llvm::StringSwitch<OCL_OPTIONS>(co)
@@ -332,6 +333,7 @@ bool SPIRMetaDataTranslation::runOnModule(Module& M)
                 .Case("-g", DASH_G)
                 .Case("-relaxed-builtins", RELAXED_BUILTINS)
                 .Case("-match-sincospi", MATCH_SINCOSPI)
+                .Case("-intel-fast-compile-tier0", FAST_COMPILE_TIER0)
                 .Default(NONE);
 
 
@@ -360,6 +362,8 @@ bool SPIRMetaDataTranslation::runOnModule(Module& M)
                 break;
             case MATCH_SINCOSPI: modMD->compOpt.MatchSinCosPi = true;
                 break;
+            case FAST_COMPILE_TIER0: modMD->compOpt.FastCompileTier0 = true;
+                break;
             default:
                 break;
             }
@@ -0,0 +1,24 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt -igc-spir-metadata-translation -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; -cl-intel-fast-compile-tier0 selects the vISA tier-0 pipeline. It is
+; recorded in the module metadata for the code generator.
+
+define spir_kernel void @test_tier0(float addrspace(1)* %p) {
+  store float 0.000000e+00, float addrspace(1)* %p
+  ret void
+}
+
+; CHECK: !{!"FastCompileTier0", i1 true}
+
+!opencl.compiler.options = !{!0}
+
+!0 = !{!"-cl-intel-fast-compile-tier0"}
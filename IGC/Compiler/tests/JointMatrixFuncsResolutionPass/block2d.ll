@@ -0,0 +1,182 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt %s -S -o - --platformpvc -igc-joint-matrix-resolution -igc-joint-matrix-2d-block | FileCheck %s
+; RUN: igc_opt %s -S -o - --platformpvc -igc-joint-matrix-resolution | FileCheck %s --check-prefix=DEFAULT
+; RUN: igc_opt %s -S -o - --platformdg2 -igc-joint-matrix-resolution -igc-joint-matrix-2d-block | FileCheck %s --check-prefix=DG2
+
+; With -igc-joint-matrix-2d-block (or EnableJointMatrix2DBlock), JointMatrix
+; loads and stores on PVC become LSC 2d block messages when the stride is a
+; constant giving a valid surface pitch and the pointer is global and dword
+; aligned. Otherwise they call the per-layout BiF.
+;
+; The 2d block arguments are: base, width - 1, height - 1, pitch - 1, x, y,
+; element size, block width, block height, number of blocks, transpose, vnni.
+
+%intel.joint_matrix_packedA_8x16_i16_t = type opaque
+%intel.joint_matrix_packedB_16x16_i16_t = type opaque
+%intel.joint_matrix_acc_8x16_f32_t = type opaque
+
+declare %intel.joint_matrix_packedA_8x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedA(i8 addrspace(1)*, i64, i32)
+declare %intel.joint_matrix_packedA_8x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedA_local(i8 addrspace(3)*, i64, i32)
+declare %intel.joint_matrix_packedB_16x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedB(i8 addrspace(1)*, i64, i32)
+declare %intel.joint_matrix_acc_8x16_f32_t* @__builtin_spirv_OpJointMatrixLoadINTEL_acc(i8 addrspace(1)*, i64, i32)
+declare void @__builtin_spirv_OpJointMatrixStoreINTEL_acc(i8 addrspace(1)*, %intel.joint_matrix_acc_8x16_f32_t*, i64, i32)
+
+; Shape selection
+
+; Matrix A, row major: one row per slice element, 16 x 16 bit wide. The
+; stride of 64 is scaled like in the BiF, to a pitch of 64 bytes.
+define void @load_a(i8 addrspace(1)* align 64 %mem) {
+  %m = call %intel.joint_matrix_packedA_8x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedA(i8 addrspace(1)* %mem, i64 64, i32 0)
+  ret void
+}
+
+; CHECK-LABEL: define void @load_a
+; CHECK: call <8 x i16> @llvm.genx.GenISA.LSC2DBlockRead{{[^(]*}}(i64 %matrix.base, i32 63, i32 7, i32 63, i32 %matrix.x, i32 0, i32 16, i32 16, i32 8, i32 1, i1 false, i1 false)
+; CHECK-NOT: __builtin_spriv_OpJointMatrixLoadINTEL
+; CHECK: ret void
+
+; DEFAULT-LABEL: define void @load_a
+; DEFAULT-NOT: LSC2DBlockRead
+; DEFAULT: call <8 x i16> @__builtin_spriv_OpJointMatrixLoadINTEL_PackedA_RowMajor_SG16_8x16_i16_v8i8_pi32_i32(i8 addrspace(1)* %mem, i64 64)
+; DEFAULT: ret void
+
+; DG2-LABEL: define void @load_a
+; DG2-NOT: LSC2DBlockRead
+; DG2: call <8 x i32> @__builtin_spriv_OpJointMatrixLoadINTEL_PackedA_RowMajor_8x16_i16_v8i8_pi32_i32(i8 addrspace(1)* %mem, i64 64)
+; DG2: ret void
+
+; Accumulator, row major, loaded and stored with 32 bit elements. Float
+; slices are read and written as integers of the same size.
+define void @acc_roundtrip(i8 addrspace(1)* align 64 %src, i8 addrspace(1)* align 64 %dst) {
+  %m = call %intel.joint_matrix_acc_8x16_f32_t* @__builtin_spirv_OpJointMatrixLoadINTEL_acc(i8 addrspace(1)* %src, i64 16, i32 0)
+  call void @__builtin_spirv_OpJointMatrixStoreINTEL_acc(i8 addrspace(1)* %dst, %intel.joint_matrix_acc_8x16_f32_t* %m, i64 16, i32 0)
+  ret void
+}
+
+; CHECK-LABEL: define void @acc_roundtrip
+; CHECK: [[LD:%.*]] = call <8 x i32> @llvm.genx.GenISA.LSC2DBlockRead{{[^(]*}}(i64 {{%.*}}, i32 63, i32 7, i32 63, i32 {{%.*}}, i32 0, i32 32, i32 16, i32 8, i32 1, i1 false, i1 false)
+; CHECK: [[F:%.*]] = bitcast <8 x i32> [[LD]] to <8 x float>
+; CHECK: [[I:%.*]] = bitcast <8 x float> [[F]] to <8 x i32>
+; CHECK: call void @llvm.genx.GenISA.LSC2DBlockWrite{{[^(]*}}(i64 {{%.*}}, i32 63, i32 7, i32 63, i32 {{%.*}}, i32 0, i32 32, i32 16, i32 8, i32 1, i1 false, i1 false, <8 x i32> [[I]])
+; CHECK-NOT: __builtin_spriv_OpJointMatrix
+; CHECK: ret void
+
+; Matrix B, already packed: dword elements, pitch (32 / 2) * 4 bytes.
+define void @load_b_packed(i8 addrspace(1)* align 64 %mem) {
+  %m = call %intel.joint_matrix_packedB_16x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedB(i8 addrspace(1)* %mem, i64 32, i32 3)
+  ret void
+}
+
+; CHECK-LABEL: define void @load_b_packed
+; CHECK: call <8 x i32> @llvm.genx.GenISA.LSC2DBlockRead{{[^(]*}}(i64 %matrix.base, i32 63, i32 7, i32 63, i32 %matrix.x, i32 0, i32 32, i32 16, i32 8, i32 1, i1 false, i1 false)
+; CHECK: ret void
+
+; Matrix B, row major: the whole 16 x 16 matrix is read with the VNNI
+; transform, which packs it for DPAS.
+define void @load_b_vnni(i8 addrspace(1)* align 64 %mem) {
+  %m = call %intel.joint_matrix_packedB_16x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedB(i8 addrspace(1)* %mem, i64 32, i32 0)
+  ret void
+}
+
+; CHECK-LABEL: define void @load_b_vnni
+; CHECK: call <8 x i32> @llvm.genx.GenISA.LSC2DBlockRead{{[^(]*}}(i64 %matrix.base, i32 63, i32 15, i32 63, i32 %matrix.x, i32 0, i32 16, i32 16, i32 16, i32 1, i1 false, i1 true)
+; CHECK: ret void
+
+; Matrix B, column major: every work item reads one row, with the
+; transposed dword read.
+define void @load_b_transposed(i8 addrspace(1)* align 64 %mem) {
+  %m = call %intel.joint_matrix_packedB_16x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedB(i8 addrspace(1)* %mem, i64 16, i32 1)
+  ret void
+}
+
+; CHECK-LABEL: define void @load_b_transposed
+; CHECK: call <8 x i32> @llvm.genx.GenISA.LSC2DBlockRead{{[^(]*}}(i64 %matrix.base, i32 63, i32 15, i32 63, i32 %matrix.x, i32 0, i32 32, i32 8, i32 16, i32 1, i1 true, i1 false)
+; CHECK: ret void
+
+; Stride and pitch gates
+
+; The pitch can only be checked for a constant stride.
+define void @dynamic_stride(i8 addrspace(1)* align 64 %mem, i64 %stride) {
+  %m = call %intel.joint_matrix_packedA_8x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedA(i8 addrspace(1)* %mem, i64 %stride, i32 0)
+  ret void
+}
+
+; CHECK-LABEL: define void @dynamic_stride
+; CHECK-NOT: LSC2DBlockRead
+; CHECK: call <8 x i16> @__builtin_spriv_OpJointMatrixLoadINTEL_PackedA_RowMajor_SG16_8x16_i16_v8i8_pi32_i32(i8 addrspace(1)* %mem, i64 %stride)
+; CHECK: ret void
+
+; A 32 byte pitch is below the 64 byte minimum.
+define void @small_pitch(i8 addrspace(1)* align 64 %mem) {
+  %m = call %intel.joint_matrix_packedA_8x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedA(i8 addrspace(1)* %mem, i64 32, i32 0)
+  ret void
+}
+
+; CHECK-LABEL: define void @small_pitch
+; CHECK-NOT: LSC2DBlockRead
+; CHECK: call <8 x i16> @__builtin_spriv_OpJointMatrixLoadINTEL_PackedA_RowMajor_SG16_8x16_i16_v8i8_pi32_i32(i8 addrspace(1)* %mem, i64 32)
+; CHECK: ret void
+
+; A 72 byte pitch is not a multiple of 16 bytes.
+define void @unaligned_pitch(i8 addrspace(1)* align 64 %mem) {
+  %m = call %intel.joint_matrix_packedA_8x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedA(i8 addrspace(1)* %mem, i64 72, i32 0)
+  ret void
+}
+
+; CHECK-LABEL: define void @unaligned_pitch
+; CHECK-NOT: LSC2DBlockRead
+; CHECK: call <8 x i16> @__builtin_spriv_OpJointMatrixLoadINTEL_PackedA_RowMajor_SG16_8x16_i16_v8i8_pi32_i32(i8 addrspace(1)* %mem, i64 72)
+; CHECK: ret void
+
+; Pointer alignment gates
+
+; A dword aligned pointer may be up to 60 bytes past the 64 byte aligned
+; surface base, and the 32 byte row must still fit in the 96 byte pitch.
+define void @dword_aligned(i8 addrspace(1)* align 4 %mem) {
+  %m = call %intel.joint_matrix_packedA_8x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedA(i8 addrspace(1)* %mem, i64 96, i32 0)
+  ret void
+}
+
+; CHECK-LABEL: define void @dword_aligned
+; CHECK: call <8 x i16> @llvm.genx.GenISA.LSC2DBlockRead{{[^(]*}}(i64 %matrix.base, i32 95, i32 7, i32 95, i32 %matrix.x, i32 0, i32 16, i32 16, i32 8, i32 1, i1 false, i1 false)
+; CHECK: ret void
+
+; With a 64 byte pitch, the row may not fit past a 60 byte offset.
+define void @dword_aligned_narrow(i8 addrspace(1)* align 4 %mem) {
+  %m = call %intel.joint_matrix_packedA_8x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedA(i8 addrspace(1)* %mem, i64 64, i32 0)
+  ret void
+}
+
+; CHECK-LABEL: define void @dword_aligned_narrow
+; CHECK-NOT: LSC2DBlockRead
+; CHECK: call <8 x i16> @__builtin_spriv_OpJointMatrixLoadINTEL_PackedA_RowMajor_SG16_8x16_i16_v8i8_pi32_i32(i8 addrspace(1)* %mem, i64 64)
+; CHECK: ret void
+
+; The x offset has to be dword aligned.
+define void @word_aligned(i8 addrspace(1)* align 2 %mem) {
+  %m = call %intel.joint_matrix_packedA_8x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedA(i8 addrspace(1)* %mem, i64 64, i32 0)
+  ret void
+}
+
+; CHECK-LABEL: define void @word_aligned
+; CHECK-NOT: LSC2DBlockRead
+; CHECK: call <8 x i16> @__builtin_spriv_OpJointMatrixLoadINTEL_PackedA_RowMajor_SG16_8x16_i16_v8i8_pi32_i32(i8 addrspace(1)* %mem, i64 64)
+; CHECK: ret void
+
+; 2d block messages only access global memory.
+define void @local_ptr(i8 addrspace(3)* align 64 %mem) {
+  %m = call %intel.joint_matrix_packedA_8x16_i16_t* @__builtin_spirv_OpJointMatrixLoadINTEL_packedA_local(i8 addrspace(3)* %mem, i64 64, i32 0)
+  ret void
+}
+
+; CHECK-LABEL: define void @local_ptr
+; CHECK-NOT: LSC2DBlockRead
+; CHECK: call <8 x i16> {{.*}}@__builtin_spriv_OpJointMatrixLoadINTEL_PackedA_RowMajor_SG16_8x16_i16_v8i8_pi32_i32{{.*}}(i8 addrspace(3)* %mem, i64 64)
+; CHECK: ret void
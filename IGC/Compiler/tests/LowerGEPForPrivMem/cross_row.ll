@@ -0,0 +1,87 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt %s -S -o - -igc-priv-mem-to-reg -igc-priv-mem-partial-promotion | FileCheck %s
+; RUN: igc_opt %s -S -o - -igc-priv-mem-to-reg | FileCheck %s --check-prefix=DEFAULT
+
+; The arrays below are too large to be promoted as a whole, so their rows are
+; considered for promotion one by one. A row may only be split off if every
+; access through it stays inside the row. Rows are only considered with
+; -igc-priv-mem-partial-promotion (or EnablePartialPrivateArrayPromotion).
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f16:16:16-f32:32:32-f64:64:64-f80:128:128-v16:16:16-v24:32:32-v32:32:32-v48:64:64-v64:64:64-v96:128:128-v128:128:128-v192:256:256-v256:256:256-v512:512:512-v1024:1024:1024-a:64:64-f80:128:128-n8:16:32:64"
+
+; All accesses stay within rows 0 and 1: the array is split.
+define void @rows_local(float* %dst, float %v) {
+entry:
+  %a = alloca [8 x [16 x float]], align 4
+  %r0 = getelementptr inbounds [8 x [16 x float]], [8 x [16 x float]]* %a, i32 0, i32 0, i32 3
+  store float %v, float* %r0, align 4
+  %r1 = getelementptr inbounds [8 x [16 x float]], [8 x [16 x float]]* %a, i32 0, i32 1
+  %r1e = getelementptr inbounds [16 x float], [16 x float]* %r1, i32 0, i32 5
+  store float %v, float* %r1e, align 4
+  %l0 = load float, float* %r0, align 4
+  %l1 = load float, float* %r1e, align 4
+  %sum = fadd float %l0, %l1
+  store float %sum, float* %dst, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @rows_local
+; CHECK-NOT: alloca [8 x [16 x float]]
+; CHECK: ret void
+
+; DEFAULT-LABEL: define void @rows_local
+; DEFAULT: %a = alloca [8 x [16 x float]]
+; DEFAULT-NOT: .row
+; DEFAULT: ret void
+
+; Indexing from &a[1] with a non-zero first index reaches row 2.
+define void @cross_row_gep(float* %dst, float %v) {
+entry:
+  %a = alloca [8 x [16 x float]], align 4
+  %r1 = getelementptr inbounds [8 x [16 x float]], [8 x [16 x float]]* %a, i32 0, i32 1
+  %next = getelementptr inbounds [16 x float], [16 x float]* %r1, i32 1, i32 3
+  store float %v, float* %next, align 4
+  %r2 = getelementptr inbounds [8 x [16 x float]], [8 x [16 x float]]* %a, i32 0, i32 2, i32 3
+  %l = load float, float* %r2, align 4
+  store float %l, float* %dst, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @cross_row_gep
+; CHECK: %a = alloca [8 x [16 x float]]
+; CHECK-NOT: .row
+; CHECK: ret void
+
+; A wide load through a bitcast of &a[0] reads rows 0 and 1.
+define void @cross_row_bitcast(<32 x float>* %dst, float %v) {
+entry:
+  %a = alloca [8 x [16 x float]], align 4
+  %r1 = getelementptr inbounds [8 x [16 x float]], [8 x [16 x float]]* %a, i32 0, i32 1, i32 0
+  store float %v, float* %r1, align 4
+  %r0 = getelementptr inbounds [8 x [16 x float]], [8 x [16 x float]]* %a, i32 0, i32 0
+  %wide = bitcast [16 x float]* %r0 to <32 x float>*
+  %l = load <32 x float>, <32 x float>* %wide, align 4
+  store <32 x float> %l, <32 x float>* %dst, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @cross_row_bitcast
+; CHECK: %a = alloca [8 x [16 x float]]
+; CHECK-NOT: .row
+; CHECK: ret void
+
+!igc.functions = !{!0, !3, !4}
+
+!0 = !{void (float*, float)* @rows_local, !1}
+!3 = !{void (float*, float)* @cross_row_gep, !1}
+!4 = !{void (<32 x float>*, float)* @cross_row_bitcast, !1}
+
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
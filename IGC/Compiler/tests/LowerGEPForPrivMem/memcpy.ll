@@ -0,0 +1,62 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt %s -S -o - -igc-priv-mem-to-reg -igc-priv-mem-partial-promotion | FileCheck %s
+
+; A private array that is too large to be promoted as a whole must not be
+; split into rows when a row pointer escapes to a call that may access the
+; rows after it, such as a memcpy or memset covering several rows.
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f16:16:16-f32:32:32-f64:64:64-f80:128:128-v16:16:16-v24:32:32-v32:32:32-v48:64:64-v64:64:64-v96:128:128-v128:128:128-v192:256:256-v256:256:256-v512:512:512-v1024:1024:1024-a:64:64-f80:128:128-n8:16:32:64"
+
+declare void @llvm.memcpy.p0i8.p0i8.i32(i8* nocapture writeonly, i8* nocapture readonly, i32, i1 immarg)
+declare void @llvm.memset.p0i8.i32(i8* nocapture writeonly, i8, i32, i1 immarg)
+
+define void @memcpy_rows(i8* %src, float* %dst) {
+entry:
+  %a = alloca [8 x [16 x float]], align 4
+  %r0 = getelementptr inbounds [8 x [16 x float]], [8 x [16 x float]]* %a, i32 0, i32 0
+  %p = bitcast [16 x float]* %r0 to i8*
+  call void @llvm.memcpy.p0i8.p0i8.i32(i8* align 4 %p, i8* align 4 %src, i32 128, i1 false)
+  %r1 = getelementptr inbounds [8 x [16 x float]], [8 x [16 x float]]* %a, i32 0, i32 1, i32 2
+  %l = load float, float* %r1, align 4
+  store float %l, float* %dst, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @memcpy_rows
+; CHECK: %a = alloca [8 x [16 x float]]
+; CHECK-NOT: .row
+; CHECK: call void @llvm.memcpy
+; CHECK: ret void
+
+define void @memset_rows(float* %dst) {
+entry:
+  %a = alloca [8 x [16 x float]], align 4
+  %r2 = getelementptr inbounds [8 x [16 x float]], [8 x [16 x float]]* %a, i32 0, i32 2
+  %p = bitcast [16 x float]* %r2 to i8*
+  call void @llvm.memset.p0i8.i32(i8* align 4 %p, i8 0, i32 256, i1 false)
+  %r3 = getelementptr inbounds [8 x [16 x float]], [8 x [16 x float]]* %a, i32 0, i32 3, i32 1
+  %l = load float, float* %r3, align 4
+  store float %l, float* %dst, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @memset_rows
+; CHECK: %a = alloca [8 x [16 x float]]
+; CHECK-NOT: .row
+; CHECK: call void @llvm.memset
+; CHECK: ret void
+
+!igc.functions = !{!0, !3}
+
+!0 = !{void (i8*, float*)* @memcpy_rows, !1}
+!3 = !{void (float*)* @memset_rows, !1}
+
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
@@ -0,0 +1,129 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt %s -S -o - -basicaa -igc-memopt -igc-memopt-across-blocks -instcombine | FileCheck %s
+; RUN: igc_opt %s -S -o - -basicaa -igc-memopt -instcombine | FileCheck %s --check-prefix=DEFAULT
+
+; With -igc-memopt-across-blocks (or EnableMemOptAcrossBlocks), loads and
+; stores are merged across a chain of blocks that fall through to each other.
+; By default each block is still scanned on its own.
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f16:16:16-f32:32:32-f64:64:64-f80:128:128-v16:16:16-v24:32:32-v32:32:32-v48:64:64-v64:64:64-v96:128:128-v128:128:128-v192:256:256-v256:256:256-v512:512:512-v1024:1024:1024-a:64:64-f80:128:128-n8:16:32:64"
+
+define void @chain(i32* noalias %dst, i32* noalias %src) {
+entry:
+  %0 = load i32, i32* %src, align 4
+  %arrayidx1 = getelementptr inbounds i32, i32* %src, i64 1
+  %1 = load i32, i32* %arrayidx1, align 4
+  br label %bb1
+
+bb1:
+  %arrayidx2 = getelementptr inbounds i32, i32* %src, i64 2
+  %2 = load i32, i32* %arrayidx2, align 4
+  store i32 %0, i32* %dst, align 4
+  br label %bb2
+
+bb2:
+  %arrayidx4 = getelementptr inbounds i32, i32* %dst, i64 1
+  store i32 %1, i32* %arrayidx4, align 4
+  %arrayidx5 = getelementptr inbounds i32, i32* %dst, i64 2
+  store i32 %2, i32* %arrayidx5, align 4
+  ret void
+}
+
+; The three blocks always execute together, so the loads and the stores are
+; each merged into one access.
+
+; CHECK-LABEL: define void @chain
+; CHECK-NOT: load i32,
+; CHECK: load <3 x i32>
+; CHECK-NOT: load i32,
+; CHECK-NOT: store i32
+; CHECK: store <3 x i32>
+; CHECK-NOT: store i32
+; CHECK: ret void
+
+; DEFAULT-LABEL: define void @chain
+; DEFAULT: load <2 x i32>
+; DEFAULT: bb1:
+; DEFAULT: load i32,
+; DEFAULT: store i32
+; DEFAULT: bb2:
+; DEFAULT: store <2 x i32>
+; DEFAULT: ret void
+
+
+define void @side_entry(i32* noalias %dst, i32* noalias %src, i1 %c) {
+entry:
+  br i1 %c, label %then, label %else
+
+then:
+  %0 = load i32, i32* %src, align 4
+  br label %join
+
+else:
+  br label %join
+
+join:
+  %arrayidx1 = getelementptr inbounds i32, i32* %src, i64 1
+  %1 = load i32, i32* %arrayidx1, align 4
+  %2 = add i32 %1, 1
+  store i32 %2, i32* %dst, align 4
+  ret void
+}
+
+; %join is also reached from %else, so it does not always execute together
+; with %then, and the loads are not merged.
+
+; CHECK-LABEL: define void @side_entry
+; CHECK: then:
+; CHECK: load i32, i32* %src, align 4
+; CHECK: join:
+; CHECK: load i32, i32* %arrayidx1, align 4
+; CHECK-NOT: <2 x i32>
+; CHECK: ret void
+
+
+define void @intervening_store(i32* %dst, i32* %src) {
+entry:
+  %0 = load i32, i32* %src, align 4
+  br label %bb1
+
+bb1:
+  store i32 %0, i32* %dst, align 4
+  br label %bb2
+
+bb2:
+  %arrayidx1 = getelementptr inbounds i32, i32* %src, i64 1
+  %1 = load i32, i32* %arrayidx1, align 4
+  %arrayidx2 = getelementptr inbounds i32, i32* %dst, i64 1
+  store i32 %1, i32* %arrayidx2, align 4
+  ret void
+}
+
+; The blocks form a chain, but '%dst' may alias '%src', so the load in %bb2
+; can't move above the store in %bb1, and nothing is merged.
+
+; CHECK-LABEL: define void @intervening_store
+; CHECK: entry:
+; CHECK: %0 = load i32, i32* %src, align 4
+; CHECK: bb1:
+; CHECK: store i32 %0, i32* %dst, align 4
+; CHECK: bb2:
+; CHECK: %1 = load i32, i32* %arrayidx1, align 4
+; CHECK: store i32 %1, i32* %arrayidx2, align 4
+; CHECK: ret void
+
+!igc.functions = !{!0, !3, !4}
+
+!0 = !{void (i32*, i32*)* @chain, !1}
+!3 = !{void (i32*, i32*, i1)* @side_entry, !1}
+!4 = !{void (i32*, i32*)* @intervening_store, !1}
+
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
@@ -0,0 +1,131 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt -igc-stateless-to-stateful-resolution -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; With EnableStatelessToStatefulAcrossCalls (on by default), pointers are
+; traced through private spill slots and into functions called from a
+; single kernel.
+
+; A kernel argument stored to a private slot and loaded back is still
+; based on the argument, so the access through it is promoted.
+
+define void @spill(i32 addrspace(1)* %src, i32 addrspace(1)* %dst) {
+entry:
+  %slot = alloca i32 addrspace(1)*, align 8
+  store i32 addrspace(1)* %src, i32 addrspace(1)** %slot, align 8
+  %p = load i32 addrspace(1)*, i32 addrspace(1)** %slot, align 8
+  %arrayidx = getelementptr inbounds i32, i32 addrspace(1)* %p, i64 1
+  %v = load i32, i32 addrspace(1)* %arrayidx, align 4
+  %arrayidx1 = getelementptr inbounds i32, i32 addrspace(1)* %dst, i64 1
+  store i32 %v, i32 addrspace(1)* %arrayidx1, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @spill
+; CHECK: [[SRC:%.*]] = inttoptr i32 {{%.*}} to i32 addrspace([[AS0:[0-9]+]])*
+; CHECK: [[V:%.*]] = load i32, i32 addrspace([[AS0]])* [[SRC]], align 4
+; CHECK: [[DST:%.*]] = inttoptr i32 {{%.*}} to i32 addrspace([[AS1:[0-9]+]])*
+; CHECK: store i32 [[V]], i32 addrspace([[AS1]])* [[DST]], align 4
+; CHECK-NOT: addrspace(1)* %arrayidx
+; CHECK: ret void
+
+
+; @callee_single is only called by @single, with the kernel's own arguments,
+; so its accesses use the kernel's binding table.
+
+define void @single(i32 addrspace(1)* %src, i32 addrspace(1)* %dst) {
+entry:
+  call spir_func void @callee_single(i32 addrspace(1)* %src, i32 addrspace(1)* %dst)
+  ret void
+}
+
+define internal spir_func void @callee_single(i32 addrspace(1)* %p, i32 addrspace(1)* %q) {
+entry:
+  %arrayidx = getelementptr inbounds i32, i32 addrspace(1)* %p, i64 1
+  %v = load i32, i32 addrspace(1)* %arrayidx, align 4
+  %arrayidx1 = getelementptr inbounds i32, i32 addrspace(1)* %q, i64 1
+  store i32 %v, i32 addrspace(1)* %arrayidx1, align 4
+  ret void
+}
+
+; CHECK-LABEL: define internal spir_func void @callee_single
+; CHECK: [[P:%.*]] = inttoptr i32 {{%.*}} to i32 addrspace([[AS0]])*
+; CHECK: [[W:%.*]] = load i32, i32 addrspace([[AS0]])* [[P]], align 4
+; CHECK: [[Q:%.*]] = inttoptr i32 {{%.*}} to i32 addrspace([[AS1]])*
+; CHECK: store i32 [[W]], i32 addrspace([[AS1]])* [[Q]], align 4
+; CHECK: ret void
+
+
+; @callee_shared is called by two kernels, which have separate binding
+; tables, so its accesses stay stateless.
+
+define void @caller_a(i32 addrspace(1)* %src) {
+entry:
+  call spir_func void @callee_shared(i32 addrspace(1)* %src)
+  ret void
+}
+
+define void @caller_b(i32 addrspace(1)* %src) {
+entry:
+  call spir_func void @callee_shared(i32 addrspace(1)* %src)
+  ret void
+}
+
+define internal spir_func void @callee_shared(i32 addrspace(1)* %p) {
+entry:
+  %arrayidx = getelementptr inbounds i32, i32 addrspace(1)* %p, i64 1
+  %v = load i32, i32 addrspace(1)* %arrayidx, align 4
+  %arrayidx1 = getelementptr inbounds i32, i32 addrspace(1)* %p, i64 2
+  store i32 %v, i32 addrspace(1)* %arrayidx1, align 4
+  ret void
+}
+
+; CHECK-LABEL: define internal spir_func void @callee_shared
+; CHECK-NOT: inttoptr
+; CHECK: %v = load i32, i32 addrspace(1)* %arrayidx, align 4
+; CHECK-NOT: inttoptr
+; CHECK: store i32 %v, i32 addrspace(1)* %arrayidx1, align 4
+; CHECK: ret void
+
+!igc.functions = !{!0, !3, !4, !5}
+
+!0 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @spill, !1}
+!3 = !{void (i32 addrspace(1)*, i32 addrspace(1)*)* @single, !1}
+!4 = !{void (i32 addrspace(1)*)* @caller_a, !1}
+!5 = !{void (i32 addrspace(1)*)* @caller_b, !1}
+
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+
+!IGCMetadata = !{!10}
+
+!10 = !{!"ModuleMD", !11}
+!11 = !{!"FuncMD", !12, !13, !14, !15, !16, !17, !18, !19}
+!12 = !{!"FuncMDMap[0]", void (i32 addrspace(1)*, i32 addrspace(1)*)* @spill}
+!13 = !{!"FuncMDValue[0]", !20}
+!14 = !{!"FuncMDMap[1]", void (i32 addrspace(1)*, i32 addrspace(1)*)* @single}
+!15 = !{!"FuncMDValue[1]", !20}
+!16 = !{!"FuncMDMap[2]", void (i32 addrspace(1)*)* @caller_a}
+!17 = !{!"FuncMDValue[2]", !23}
+!18 = !{!"FuncMDMap[3]", void (i32 addrspace(1)*)* @caller_b}
+!19 = !{!"FuncMDValue[3]", !25}
+
+; Two UAVs, at binding table indices 0 and 1.
+!20 = !{!"resAllocMD", !21}
+!21 = !{!"argAllocMDList", !22, !26}
+!22 = !{!"argAllocMDListVec[0]", !30, !31, !32}
+!26 = !{!"argAllocMDListVec[1]", !30, !31, !33}
+!23 = !{!"resAllocMD", !24}
+!24 = !{!"argAllocMDList", !22}
+!25 = !{!"resAllocMD", !24}
+!30 = !{!"type", i32 1}
+!31 = !{!"extensionType", i32 -1}
+!32 = !{!"indexType", i32 0}
+!33 = !{!"indexType", i32 1}
@@ -0,0 +1,189 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt -igc-stateless-to-stateful-resolution -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; A kernel promotes at most maxPromotionCount (32) arguments to stateful,
+; and the arguments promoted in its callees count toward that limit.
+; @many promotes its first 32 arguments itself, so the access to the 33rd
+; one in @callee_over stays stateless, even though the same access is
+; promoted when the kernel is below the limit (see across_calls.ll).
+
+define void @many(i32 addrspace(1)* %a0, i32 addrspace(1)* %a1, i32 addrspace(1)* %a2, i32 addrspace(1)* %a3, i32 addrspace(1)* %a4, i32 addrspace(1)* %a5, i32 addrspace(1)* %a6, i32 addrspace(1)* %a7, i32 addrspace(1)* %a8, i32 addrspace(1)* %a9, i32 addrspace(1)* %a10, i32 addrspace(1)* %a11, i32 addrspace(1)* %a12, i32 addrspace(1)* %a13, i32 addrspace(1)* %a14, i32 addrspace(1)* %a15, i32 addrspace(1)* %a16, i32 addrspace(1)* %a17, i32 addrspace(1)* %a18, i32 addrspace(1)* %a19, i32 addrspace(1)* %a20, i32 addrspace(1)* %a21, i32 addrspace(1)* %a22, i32 addrspace(1)* %a23, i32 addrspace(1)* %a24, i32 addrspace(1)* %a25, i32 addrspace(1)* %a26, i32 addrspace(1)* %a27, i32 addrspace(1)* %a28, i32 addrspace(1)* %a29, i32 addrspace(1)* %a30, i32 addrspace(1)* %a31, i32 addrspace(1)* %a32) {
+entry:
+  %p0 = getelementptr inbounds i32, i32 addrspace(1)* %a0, i64 1
+  %v0 = load i32, i32 addrspace(1)* %p0, align 4
+  %p1 = getelementptr inbounds i32, i32 addrspace(1)* %a1, i64 1
+  %v1 = load i32, i32 addrspace(1)* %p1, align 4
+  %p2 = getelementptr inbounds i32, i32 addrspace(1)* %a2, i64 1
+  %v2 = load i32, i32 addrspace(1)* %p2, align 4
+  %p3 = getelementptr inbounds i32, i32 addrspace(1)* %a3, i64 1
+  %v3 = load i32, i32 addrspace(1)* %p3, align 4
+  %p4 = getelementptr inbounds i32, i32 addrspace(1)* %a4, i64 1
+  %v4 = load i32, i32 addrspace(1)* %p4, align 4
+  %p5 = getelementptr inbounds i32, i32 addrspace(1)* %a5, i64 1
+  %v5 = load i32, i32 addrspace(1)* %p5, align 4
+  %p6 = getelementptr inbounds i32, i32 addrspace(1)* %a6, i64 1
+  %v6 = load i32, i32 addrspace(1)* %p6, align 4
+  %p7 = getelementptr inbounds i32, i32 addrspace(1)* %a7, i64 1
+  %v7 = load i32, i32 addrspace(1)* %p7, align 4
+  %p8 = getelementptr inbounds i32, i32 addrspace(1)* %a8, i64 1
+  %v8 = load i32, i32 addrspace(1)* %p8, align 4
+  %p9 = getelementptr inbounds i32, i32 addrspace(1)* %a9, i64 1
+  %v9 = load i32, i32 addrspace(1)* %p9, align 4
+  %p10 = getelementptr inbounds i32, i32 addrspace(1)* %a10, i64 1
+  %v10 = load i32, i32 addrspace(1)* %p10, align 4
+  %p11 = getelementptr inbounds i32, i32 addrspace(1)* %a11, i64 1
+  %v11 = load i32, i32 addrspace(1)* %p11, align 4
+  %p12 = getelementptr inbounds i32, i32 addrspace(1)* %a12, i64 1
+  %v12 = load i32, i32 addrspace(1)* %p12, align 4
+  %p13 = getelementptr inbounds i32, i32 addrspace(1)* %a13, i64 1
+  %v13 = load i32, i32 addrspace(1)* %p13, align 4
+  %p14 = getelementptr inbounds i32, i32 addrspace(1)* %a14, i64 1
+  %v14 = load i32, i32 addrspace(1)* %p14, align 4
+  %p15 = getelementptr inbounds i32, i32 addrspace(1)* %a15, i64 1
+  %v15 = load i32, i32 addrspace(1)* %p15, align 4
+  %p16 = getelementptr inbounds i32, i32 addrspace(1)* %a16, i64 1
+  %v16 = load i32, i32 addrspace(1)* %p16, align 4
+  %p17 = getelementptr inbounds i32, i32 addrspace(1)* %a17, i64 1
+  %v17 = load i32, i32 addrspace(1)* %p17, align 4
+  %p18 = getelementptr inbounds i32, i32 addrspace(1)* %a18, i64 1
+  %v18 = load i32, i32 addrspace(1)* %p18, align 4
+  %p19 = getelementptr inbounds i32, i32 addrspace(1)* %a19, i64 1
+  %v19 = load i32, i32 addrspace(1)* %p19, align 4
+  %p20 = getelementptr inbounds i32, i32 addrspace(1)* %a20, i64 1
+  %v20 = load i32, i32 addrspace(1)* %p20, align 4
+  %p21 = getelementptr inbounds i32, i32 addrspace(1)* %a21, i64 1
+  %v21 = load i32, i32 addrspace(1)* %p21, align 4
+  %p22 = getelementptr inbounds i32, i32 addrspace(1)* %a22, i64 1
+  %v22 = load i32, i32 addrspace(1)* %p22, align 4
+  %p23 = getelementptr inbounds i32, i32 addrspace(1)* %a23, i64 1
+  %v23 = load i32, i32 addrspace(1)* %p23, align 4
+  %p24 = getelementptr inbounds i32, i32 addrspace(1)* %a24, i64 1
+  %v24 = load i32, i32 addrspace(1)* %p24, align 4
+  %p25 = getelementptr inbounds i32, i32 addrspace(1)* %a25, i64 1
+  %v25 = load i32, i32 addrspace(1)* %p25, align 4
+  %p26 = getelementptr inbounds i32, i32 addrspace(1)* %a26, i64 1
+  %v26 = load i32, i32 addrspace(1)* %p26, align 4
+  %p27 = getelementptr inbounds i32, i32 addrspace(1)* %a27, i64 1
+  %v27 = load i32, i32 addrspace(1)* %p27, align 4
+  %p28 = getelementptr inbounds i32, i32 addrspace(1)* %a28, i64 1
+  %v28 = load i32, i32 addrspace(1)* %p28, align 4
+  %p29 = getelementptr inbounds i32, i32 addrspace(1)* %a29, i64 1
+  %v29 = load i32, i32 addrspace(1)* %p29, align 4
+  %p30 = getelementptr inbounds i32, i32 addrspace(1)* %a30, i64 1
+  %v30 = load i32, i32 addrspace(1)* %p30, align 4
+  %p31 = getelementptr inbounds i32, i32 addrspace(1)* %a31, i64 1
+  %v31 = load i32, i32 addrspace(1)* %p31, align 4
+  call spir_func void @callee_over(i32 addrspace(1)* %a32)
+  ret void
+}
+
+define internal spir_func void @callee_over(i32 addrspace(1)* %p) {
+entry:
+  %arrayidx = getelementptr inbounds i32, i32 addrspace(1)* %p, i64 1
+  %v = load i32, i32 addrspace(1)* %arrayidx, align 4
+  ret void
+}
+
+; CHECK-LABEL: define void @many
+; CHECK-COUNT-32: inttoptr i32 {{.*}} to i32 addrspace({{[0-9]+}})*
+; CHECK-NOT: addrspace(1)* %p
+; CHECK: ret void
+
+; CHECK-LABEL: define internal spir_func void @callee_over
+; CHECK-NOT: inttoptr
+; CHECK: %v = load i32, i32 addrspace(1)* %arrayidx, align 4
+; CHECK: ret void
+
+!igc.functions = !{!0}
+
+!0 = !{void (i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*)* @many, !1}
+
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+
+!IGCMetadata = !{!10}
+
+!10 = !{!"ModuleMD", !11}
+!11 = !{!"FuncMD", !12, !13}
+!12 = !{!"FuncMDMap[0]", void (i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*, i32 addrspace(1)*)* @many}
+!13 = !{!"FuncMDValue[0]", !20}
+
+; 33 UAVs, at binding table indices 0 to 32.
+!20 = !{!"resAllocMD", !21}
+!21 = !{!"argAllocMDList", !100, !101, !102, !103, !104, !105, !106, !107, !108, !109, !110, !111, !112, !113, !114, !115, !116, !117, !118, !119, !120, !121, !122, !123, !124, !125, !126, !127, !128, !129, !130, !131, !132}
+!100 = !{!"argAllocMDListVec[0]", !30, !31, !200}
+!101 = !{!"argAllocMDListVec[1]", !30, !31, !201}
+!102 = !{!"argAllocMDListVec[2]", !30, !31, !202}
+!103 = !{!"argAllocMDListVec[3]", !30, !31, !203}
+!104 = !{!"argAllocMDListVec[4]", !30, !31, !204}
+!105 = !{!"argAllocMDListVec[5]", !30, !31, !205}
+!106 = !{!"argAllocMDListVec[6]", !30, !31, !206}
+!107 = !{!"argAllocMDListVec[7]", !30, !31, !207}
+!108 = !{!"argAllocMDListVec[8]", !30, !31, !208}
+!109 = !{!"argAllocMDListVec[9]", !30, !31, !209}
+!110 = !{!"argAllocMDListVec[10]", !30, !31, !210}
+!111 = !{!"argAllocMDListVec[11]", !30, !31, !211}
+!112 = !{!"argAllocMDListVec[12]", !30, !31, !212}
+!113 = !{!"argAllocMDListVec[13]", !30, !31, !213}
+!114 = !{!"argAllocMDListVec[14]", !30, !31, !214}
+!115 = !{!"argAllocMDListVec[15]", !30, !31, !215}
+!116 = !{!"argAllocMDListVec[16]", !30, !31, !216}
+!117 = !{!"argAllocMDListVec[17]", !30, !31, !217}
+!118 = !{!"argAllocMDListVec[18]", !30, !31, !218}
+!119 = !{!"argAllocMDListVec[19]", !30, !31, !219}
+!120 = !{!"argAllocMDListVec[20]", !30, !31, !220}
+!121 = !{!"argAllocMDListVec[21]", !30, !31, !221}
+!122 = !{!"argAllocMDListVec[22]", !30, !31, !222}
+!123 = !{!"argAllocMDListVec[23]", !30, !31, !223}
+!124 = !{!"argAllocMDListVec[24]", !30, !31, !224}
+!125 = !{!"argAllocMDListVec[25]", !30, !31, !225}
+!126 = !{!"argAllocMDListVec[26]", !30, !31, !226}
+!127 = !{!"argAllocMDListVec[27]", !30, !31, !227}
+!128 = !{!"argAllocMDListVec[28]", !30, !31, !228}
+!129 = !{!"argAllocMDListVec[29]", !30, !31, !229}
+!130 = !{!"argAllocMDListVec[30]", !30, !31, !230}
+!131 = !{!"argAllocMDListVec[31]", !30, !31, !231}
+!132 = !{!"argAllocMDListVec[32]", !30, !31, !232}
+!30 = !{!"type", i32 1}
+!31 = !{!"extensionType", i32 -1}
+!200 = !{!"indexType", i32 0}
+!201 = !{!"indexType", i32 1}
+!202 = !{!"indexType", i32 2}
+!203 = !{!"indexType", i32 3}
+!204 = !{!"indexType", i32 4}
+!205 = !{!"indexType", i32 5}
+!206 = !{!"indexType", i32 6}
+!207 = !{!"indexType", i32 7}
+!208 = !{!"indexType", i32 8}
+!209 = !{!"indexType", i32 9}
+!210 = !{!"indexType", i32 10}
+!211 = !{!"indexType", i32 11}
+!212 = !{!"indexType", i32 12}
+!213 = !{!"indexType", i32 13}
+!214 = !{!"indexType", i32 14}
+!215 = !{!"indexType", i32 15}
+!216 = !{!"indexType", i32 16}
+!217 = !{!"indexType", i32 17}
+!218 = !{!"indexType", i32 18}
+!219 = !{!"indexType", i32 19}
+!220 = !{!"indexType", i32 20}
+!221 = !{!"indexType", i32 21}
+!222 = !{!"indexType", i32 22}
+!223 = !{!"indexType", i32 23}
+!224 = !{!"indexType", i32 24}
+!225 = !{!"indexType", i32 25}
+!226 = !{!"indexType", i32 26}
+!227 = !{!"indexType", i32 27}
+!228 = !{!"indexType", i32 28}
+!229 = !{!"indexType", i32 29}
+!230 = !{!"indexType", i32 30}
+!231 = !{!"indexType", i32 31}
+!232 = !{!"indexType", i32 32}
@@ -2148,6 +2148,23 @@ Imported_Intrinsics = \
                                        "only and elemSize 32)")],
     "None"]],
 ####################################################################################################
+"GenISA_LSC2DBlockWrite": ["LSC 2d block write",
+    [("void",                          ""),
+    [("long",                          "flat image base offset"),
+     ("int",                           "flat image base width"),
+     ("int",                           "flat image base height"),
+     ("int",                           "flat image base pitch"),
+     ("int",                           "offset x"),
+     ("int",                           "offset y"),
+     ("int",                           "elemSize"),
+     ("int",                           "tile width"),
+     ("int",                           "tile height"),
+     ("int",                           "V - num blocks (must be 1 for 2d block write)"),
+     ("bool",                          "transpose (must be false for 2d block write)"),
+     ("bool",                          "vnni transform (must be false for 2d block write)"),
+     ("anyint",                        "value to store")],
+    "None"]],
+####################################################################################################
 "GenISA_LSCAtomicFP32": ["LSC atomic FP32 add,sub,min,max,fcas",
     [("float",                         "return old value"),
     [("anyptr",                        "memory pointer: ugm, ugml, tgm, slm"),
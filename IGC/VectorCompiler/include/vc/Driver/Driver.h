@@ -25,6 +25,7 @@ SPDX-License-Identifier: MIT
 #include <llvm/Target/TargetOptions.h>
 
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <variant>
 #include <vector>
@@ -159,4 +160,10 @@ llvm::Expected<CompileOutput> Compile(llvm::ArrayRef<char> Input,
 llvm::Expected<CompileOptions> ParseOptions(llvm::StringRef ApiOptions,
                                             llvm::StringRef InternalOptions,
                                             bool IsStrictMode);
+
+// LLVM command line options, pass timers and statistics are process-wide.
+// Compile holds this lock shared while it only reads them and exclusively
+// while it changes them. Anyone else setting LLVM options in the same
+// process (e.g. the scalar part) must hold it exclusively too.
+std::shared_mutex &getLLVMGlobalStateMutex();
 } // namespace vc
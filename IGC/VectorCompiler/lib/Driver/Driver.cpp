@@ -55,6 +55,8 @@ SPDX-License-Identifier: MIT
 #include "Probe/Assertion.h"
 
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 
 using namespace llvm;
@@ -475,20 +477,68 @@ static void printLLVMTimers(const vc::CompileOptions &Opts) {
   llvm::errs() << OutStr;
 }
 
+std::shared_mutex &vc::getLLVMGlobalStateMutex() {
+  static std::shared_mutex Mutex;
+  return Mutex;
+}
+
+static bool needsLLVMGlobalState(const vc::CompileOptions &Opts) {
+  return !Opts.LLVMOptions.empty() || Opts.TimePasses ||
+         Opts.ResetTimePasses || Opts.ShowStats || Opts.ResetLLVMStats ||
+         !Opts.StatsFile.empty();
+}
+
+// Check whether someone else (e.g. the scalar part) left LLVM options set.
+static bool hasLLVMOptionOccurrences() {
+  for (auto &Entry : cl::getRegisteredOptions())
+    if (Entry.getValue()->getNumOccurrences())
+      return true;
+  return false;
+}
+
+static void initializeGenXTarget() {
+  static std::once_flag InitFlag;
+  std::call_once(InitFlag, []() {
+    LLVMInitializeGenXTarget();
+    LLVMInitializeGenXTargetInfo();
+  });
+}
+
 Expected<vc::CompileOutput> vc::Compile(ArrayRef<char> Input,
                                         const vc::CompileOptions &Opts,
                                         const vc::ExternalData &ExtData,
                                         ArrayRef<uint32_t> SpecConstIds,
                                         ArrayRef<uint64_t> SpecConstValues) {
-  parseLLVMOptions(Opts.LLVMOptions);
+  // Compilations that leave LLVM options, timers and statistics alone only
+  // read global LLVM state and can share it. Anything else, including
+  // cleaning up options left over by the scalar part, is done exclusively.
+  // The scalar part sets its options under the exclusive lock as well, so
+  // they cannot change while they are checked here.
+  std::shared_lock<std::shared_mutex> SharedLock(getLLVMGlobalStateMutex(),
+                                                 std::defer_lock);
+  std::unique_lock<std::shared_mutex> ExclusiveLock(getLLVMGlobalStateMutex(),
+                                                    std::defer_lock);
+  bool UsesGlobalState = needsLLVMGlobalState(Opts);
+  if (!UsesGlobalState) {
+    SharedLock.lock();
+    if (hasLLVMOptionOccurrences()) {
+      SharedLock.unlock();
+      UsesGlobalState = true;
+    }
+  }
+  if (UsesGlobalState) {
+    ExclusiveLock.lock();
+    parseLLVMOptions(Opts.LLVMOptions);
+  }
   // Reset options when everything is done here. This is needed to not
   // interfere with subsequent translations (including scalar part).
-  const auto ClOptGuard =
-      llvm::make_scope_exit([]() { cl::ResetAllOptionOccurrences(); });
+  const auto ClOptGuard = llvm::make_scope_exit([UsesGlobalState]() {
+    if (UsesGlobalState)
+      cl::ResetAllOptionOccurrences();
+  });
 
   LLVMContext Context;
-  LLVMInitializeGenXTarget();
-  LLVMInitializeGenXTargetInfo();
+  initializeGenXTarget();
 
   Expected<std::unique_ptr<llvm::Module>> ExpModule =
       getModule(Input, Opts.FType, SpecConstIds, SpecConstValues, Context);
@@ -521,9 +571,10 @@ Expected<vc::CompileOutput> vc::Compile(ArrayRef<char> Input,
   // Save the old value (to restore it once compilation process is finished)
   const bool TimePassesIsEnabledOld = llvm::TimePassesIsEnabled;
   const auto TimePassesReenableGuard =
-      llvm::make_scope_exit([TimePassesIsEnabledOld]() {
-        // WARNING (FIXME): we modify global variable here
-        llvm::TimePassesIsEnabled = TimePassesIsEnabledOld;
+      llvm::make_scope_exit([TimePassesIsEnabledOld, UsesGlobalState]() {
+        // Only written under the exclusive lock.
+        if (UsesGlobalState)
+          llvm::TimePassesIsEnabled = TimePassesIsEnabledOld;
       });
 
   // Enable tracking of time needed for LLVM passes to run
@@ -548,8 +599,12 @@ Expected<vc::CompileOutput> vc::Compile(ArrayRef<char> Input,
 
   vc::CompileOutput Output = runCodeGen(Opts, ExtData, TM, M);
 
-  printLLVMStats(Opts);
-  printLLVMTimers(Opts);
+  // Timers and statistics are shared by all compilations; only report them
+  // when this one owns them.
+  if (UsesGlobalState) {
+    printLLVMStats(Opts);
+    printLLVMTimers(Opts);
+  }
   return Output;
 }
 
@@ -281,6 +281,7 @@ namespace IGC
         bool EnableTakeGlobalAddress                    = false;
         bool IsLibraryCompilation                       = false;
         bool FastVISACompile                            = false;
+        bool FastCompileTier0                           = false;
         bool MatchSinCosPi                              = false;
         bool CaptureCompilerStats                       = false;
         // Suggest to enableZEBinary. IGC could still fall-back to legacy
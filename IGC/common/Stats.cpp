@@ -17,6 +17,7 @@ SPDX-License-Identifier: MIT
 #include <llvm/Support/FormattedStream.h>
 #include <llvm/Support/raw_os_ostream.h>
 #include <llvm/Support/Debug.h>
+#include <llvm/Support/JSON.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include "common/secure_string.h"
@@ -34,6 +35,11 @@ extern "C" double getTimerCounts(unsigned int idx);
 extern "C" void getTimerNames(char* timerName, unsigned int idx);
 extern "C" unsigned int getTimerHits(unsigned int idx);
 extern "C" unsigned int getTotalTimers();
+extern "C" unsigned int getTotalPassStats();
+extern "C" const char* getPassStatName(unsigned int idx);
+extern "C" int64_t getPassStatTicks(unsigned int idx);
+extern "C" unsigned int getPassStatHits(unsigned int idx);
+extern "C" int64_t getPassStatInstDelta(unsigned int idx);
 #endif
 
 namespace {
@@ -535,6 +541,17 @@ int parentIntervalDepth( COMPILE_TIME_INTERVALS cti )
 
 #if GET_TIME_STATS
 
+bool isCompileTelemetryEnabled()
+{
+    return IGC::Debug::GetCompileTelemetryCallback(nullptr) != nullptr;
+}
+
+bool isPerPassTimeStatsEnabled()
+{
+    return IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS) ||
+        isCompileTelemetryEnabled();
+}
+
 TimeStats::TimeStats()
     : m_isPostProcessed(false)
     , m_totalShaderCount(0)
@@ -561,6 +578,19 @@ void TimeStats::recordVISATimers()
         m_elapsedTime[TIME_VISA_TOTAL+i] += getTimerTicks(i);
         m_hitCount[TIME_VISA_TOTAL + i] = getTimerHits(i);
     }
+
+    // Per-pass stats of the vISA optimizer, reported next to the IGC/LLVM passes
+    if (isPerPassTimeStatsEnabled())
+    {
+        for (unsigned int i = 0; i < getTotalPassStats(); ++i)
+        {
+            PerPassTimeStat& stat = m_PassTimeStatsMap[std::string("vISA::") + getPassStatName(i)];
+            stat.PassElapsedTime += getPassStatTicks(i);
+            stat.PassHitCount += getPassStatHits(i);
+            stat.PassInstDelta += getPassStatInstDelta(i);
+            m_PassTotalTicks += getPassStatTicks(i);
+        }
+    }
 }
 
 void TimeStats::recordTimerStart( COMPILE_TIME_INTERVALS compileInterval )
@@ -624,6 +654,7 @@ void TimeStats::sumWith( const TimeStats* pOther )
                     // If the pass is already included in the combined list, add the numbers
                     toIter->second.PassHitCount += fromIter->second.PassHitCount;
                     toIter->second.PassElapsedTime += fromIter->second.PassElapsedTime;
+                    toIter->second.PassInstDelta += fromIter->second.PassInstDelta;
                 }
                 else
                 {
@@ -631,6 +662,7 @@ void TimeStats::sumWith( const TimeStats* pOther )
                     PerPassTimeStat stat;
                     stat.PassElapsedTime = fromIter->second.PassElapsedTime;
                     stat.PassHitCount = fromIter->second.PassHitCount;
+                    stat.PassInstDelta = fromIter->second.PassInstDelta;
                     m_PassTimeStatsMap.insert(std::pair<std::string, PerPassTimeStat>(fromIter->first, stat));
                 }
             }
@@ -837,7 +869,7 @@ void TimeStats::printPerPassSumTimeCSV(const char* outputFile) const
     }
 }
 
-void TimeStats::recordPerPassTimerStart(std::string PassName)
+void TimeStats::recordPerPassTimerStart(std::string PassName, int64_t InstCount)
 {
     IGC_ASSERT(!PassName.empty());
 
@@ -847,17 +879,19 @@ void TimeStats::recordPerPassTimerStart(std::string PassName)
         PerPassTimeStat stat;
         stat.PassElapsedTime = 0;
         stat.PassHitCount = 0;
+        stat.PassInstCountStart = InstCount;
         stat.PassClockStart = iSTD::GetTimestampCounter();
 
         m_PassTimeStatsMap.insert(std::pair<std::string, PerPassTimeStat>(PassName, stat));
     }
     else
     {
+        iter->second.PassInstCountStart = InstCount;
         iter->second.PassClockStart = iSTD::GetTimestampCounter();
     }
 }
 
-void TimeStats::recordPerPassTimerEnd(std::string PassName)
+void TimeStats::recordPerPassTimerEnd(std::string PassName, int64_t InstCount)
 {
     IGC_ASSERT(!PassName.empty());
 
@@ -874,10 +908,64 @@ void TimeStats::recordPerPassTimerEnd(std::string PassName)
 
         iter->second.PassHitCount += 1;
         iter->second.PassElapsedTime += elapsed;
+        iter->second.PassInstDelta += InstCount - iter->second.PassInstCountStart;
         m_PassTotalTicks += elapsed;
     }
 }
 
+void TimeStats::reportTelemetry(ShaderType type, ShaderHash hash, unsigned retryId, unsigned spillSize) const
+{
+    void* userData = nullptr;
+    IGC::Debug::CompileTelemetryCallback callback = IGC::Debug::GetCompileTelemetryCallback(&userData);
+    if (!callback)
+    {
+        return;
+    }
+
+    TimeStats pp = postProcess();
+    auto toNS = [&](uint64_t ticks) {
+        return int64_t(ticks / (double)m_freq * 1000000000.0);
+    };
+
+    std::string record;
+    llvm::raw_string_ostream OS(record);
+    llvm::json::OStream J(OS);
+    J.object([&]() {
+        J.attribute("type", ShaderTypeString[static_cast<int>(type)]);
+        J.attribute("asmHash", int64_t(hash.asmHash));
+        J.attribute("nosHash", int64_t(hash.nosHash));
+        J.attribute("retryId", int64_t(retryId));
+        J.attribute("spillSize", int64_t(spillSize));
+        J.attributeObject("timers", [&]() {
+            for (int i = 0; i < MAX_COMPILE_TIME_INTERVALS; i++)
+            {
+                if (pp.m_hitCount[i] == 0 && pp.m_elapsedTime[i] == 0)
+                {
+                    continue;
+                }
+                J.attributeObject(g_cCompTimeIntervals[i], [&]() {
+                    J.attribute("ns", toNS(pp.m_elapsedTime[i]));
+                    J.attribute("hits", int64_t(pp.m_hitCount[i]));
+                });
+            }
+        });
+        J.attributeArray("passes", [&]() {
+            for (const auto& pass : pp.m_PassTimeStatsMap)
+            {
+                J.object([&]() {
+                    J.attribute("name", pass.first);
+                    J.attribute("ns", toNS(pass.second.PassElapsedTime));
+                    J.attribute("hits", int64_t(pass.second.PassHitCount));
+                    J.attribute("instDelta", pass.second.PassInstDelta);
+                });
+            }
+        });
+    });
+    OS.flush();
+
+    callback(record.c_str(), record.size(), userData);
+}
+
 namespace {
     std::string str( double num, unsigned width, unsigned sigFigs )
     {
@@ -1011,16 +1099,19 @@ void TimeStats::printPerPassSumTime(llvm::raw_ostream& OS) const
     const unsigned ticksCol = 50;                     //<! Location of the first character of the ticks column
     const unsigned percCol = ticksCol + colWidth + 2; //<! Location of the first character of the percent column
     const unsigned hitCol = percCol + colWidth + 2;   //<! Location of the first character of the hit column
+    const unsigned instCol = hitCol + colWidth + 2;   //<! Location of the first character of the inst delta column
 
     // table header
     FS.PadToColumn(ticksCol) << "ticks";
     FS.PadToColumn(percCol)  << "percent";
     FS.PadToColumn(hitCol)   << "hits";
+    FS.PadToColumn(instCol)  << "insts";
     FS << "\n";
     const std::string bar(colWidth + 1, '-');
     FS.PadToColumn(ticksCol) << bar;
     FS.PadToColumn(percCol) << bar;
     FS.PadToColumn(hitCol) << bar;
+    FS.PadToColumn(instCol) << bar;
     FS << "\n";
 
     PerPassTimeStat stat;
@@ -1036,7 +1127,11 @@ void TimeStats::printPerPassSumTime(llvm::raw_ostream& OS) const
         FS.PadToColumn(startCol) << iter->first.substr(0, ticksCol - startCol - 1);
         FS.PadToColumn(ticksCol) << str(ticks, colWidth);
         FS.PadToColumn(percCol) << str(ticks / (double)m_PassTotalTicks * 100.0, colWidth, 2);
-        FS.PadToColumn(percCol) << str(stat.PassHitCount, colWidth);
+        FS.PadToColumn(hitCol) << str(stat.PassHitCount, colWidth);
+        if (stat.PassInstDelta != 0)
+        {
+            FS.PadToColumn(instCol) << std::to_string(stat.PassInstDelta);
+        }
         FS << "\n";
     }
 
@@ -205,8 +205,17 @@ struct PerPassTimeStat
     uint64_t PassClockStart = 0;
     uint64_t PassElapsedTime = 0;
     int PassHitCount = 0;
+    // Net number of instructions added by the pass. LLVM passes are only
+    // counted for the compile telemetry record.
+    int64_t PassInstDelta = 0;
+    int64_t PassInstCountStart = 0;
 };
 
+/// Per-pass stats are collected for DumpTimeStatsPerPass and for the
+/// compile telemetry record.
+bool isPerPassTimeStatsEnabled();
+bool isCompileTelemetryEnabled();
+
 class TimeStats
 {
 public:
@@ -254,8 +263,12 @@ public:
                 (double)m_freq * 1000.0;
     }
 
-    void recordPerPassTimerStart(std::string PassName);
-    void recordPerPassTimerEnd(std::string PassName);
+    void recordPerPassTimerStart(std::string PassName, int64_t InstCount = 0);
+    void recordPerPassTimerEnd(std::string PassName, int64_t InstCount = 0);
+
+    /// Send the stats of a single shader to the compile telemetry callback
+    /// as one JSON record
+    void reportTelemetry(ShaderType type, ShaderHash hash, unsigned retryId, unsigned spillSize) const;
 
 private:
     /// \deprecated Print aggregate times for multiple shaders in csv format
@@ -285,6 +298,45 @@ private:
     std::map<std::string, PerPassTimeStat> m_PassTimeStatsMap;
 };
 
+/// Times an interval for the lifetime of the object. Used by passes with
+/// several exits that can't be wrapped by timer passes without changing
+/// pass manager scheduling (e.g. analyses shared by all EmitPass variants).
+class TimeStatsScope
+{
+public:
+    TimeStatsScope(TimeStats* stats, COMPILE_TIME_INTERVALS interval)
+        : m_stats(stats), m_interval(interval)
+    {
+        if (m_stats)
+        {
+            m_stats->recordTimerStart(m_interval);
+        }
+    }
+    ~TimeStatsScope()
+    {
+        if (m_stats)
+        {
+            m_stats->recordTimerEnd(m_interval);
+        }
+    }
+    TimeStatsScope(const TimeStatsScope&) = delete;
+    TimeStatsScope& operator=(const TimeStatsScope&) = delete;
+
+private:
+    TimeStats* m_stats;
+    COMPILE_TIME_INTERVALS m_interval;
+};
+
+template <typename T>
+inline TimeStats* getCompilerTimeStats(T* pointer)
+{
+    return pointer ? pointer->m_compilerTimeStats : nullptr;
+}
+
+#define COMPILER_TIME_SCOPE( pointer, compileTimeInterval ) \
+    TimeStatsScope compileTimeScope_##compileTimeInterval( \
+        getCompilerTimeStats(pointer), compileTimeInterval)
+
 #define COMPILER_TIME_GETNS(pointer, timerName) \
     ((pointer) && (pointer)->m_compilerTimeStats) ? \
         (pointer)->m_compilerTimeStats->getCompileTimeNS(timerName) : 0
@@ -306,20 +358,20 @@ private:
         } \
     } while (0)
 
-#define COMPILER_TIME_PASS_START( pointer, name ) \
+#define COMPILER_TIME_PASS_START( pointer, name, instCount ) \
     do \
     { \
         if( (pointer) && (pointer)->m_compilerTimeStats ) \
         { \
-                (pointer)->m_compilerTimeStats->recordPerPassTimerStart( name );  \
+                (pointer)->m_compilerTimeStats->recordPerPassTimerStart( name, instCount );  \
         } \
     } while (0)
-#define COMPILER_TIME_PASS_END( pointer, name ) \
+#define COMPILER_TIME_PASS_END( pointer, name, instCount ) \
     do \
     { \
         if( (pointer) && (pointer)->m_compilerTimeStats ) \
         { \
-                (pointer)->m_compilerTimeStats->recordPerPassTimerEnd( name ); \
+                (pointer)->m_compilerTimeStats->recordPerPassTimerEnd( name, instCount ); \
         } \
     } while (0)
 
@@ -438,11 +490,24 @@ private:
         } \
     } while (0)
 
+#define COMPILER_TIME_TELEMETRY( pointer, shaderType, shaderHash ) \
+    do \
+    { \
+        if( (pointer) && (pointer)->m_compilerTimeStats && isCompileTelemetryEnabled() ) \
+        { \
+            (pointer)->m_compilerTimeStats->reportTelemetry( shaderType, shaderHash, \
+                (pointer)->m_retryManager.GetRetryId(), \
+                (pointer)->m_retryManager.GetLastSpillSize() ); \
+        } \
+    } while (0)
+
 #else // GET_TIME_STATS
 
 #   define COMPILER_TIME_START( pointer, value ) do { } while (0)
 #   define COMPILER_TIME_END( pointer, value ) do { } while (0)
+#   define COMPILER_TIME_SCOPE( pointer, value ) do { } while (0)
 #   define COMPILER_TIME_PRINT( pointer, shaderType, shaderhash ) do { } while (0)
+#   define COMPILER_TIME_TELEMETRY( pointer, shaderType, shaderHash ) do { } while (0)
 #   define COMPILER_TIME_SUM( pointerDst, pointerSrc ) do { } while (0)
 #   define COMPILER_TIME_SUM2( pointerDst, pointerSrc ) do { } while (0)
 #   define COMPILER_TIME_SUM_PRINT( pointer ) do { } while (0)
@@ -0,0 +1,141 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "common/debug/AsyncDumpWriter.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace IGC
+{
+namespace Debug
+{
+
+static void writeFile(const std::string& path, const char* data, size_t size, bool append, bool binary)
+{
+    std::ios_base::openmode mode = std::ios_base::out;
+    if (append)
+        mode |= std::ios_base::app;
+    if (binary)
+        mode |= std::ios_base::binary;
+    std::ofstream file(path, mode);
+    file.write(data, size);
+}
+
+AsyncDumpWriter& AsyncDumpWriter::get()
+{
+    static AsyncDumpWriter writer(
+        size_t(IGC_GET_FLAG_VALUE(AsyncDumpQueueSizeMB)) * 1024 * 1024);
+    return writer;
+}
+
+AsyncDumpWriter::AsyncDumpWriter(size_t maxQueuedBytes)
+    : m_maxQueuedBytes(maxQueuedBytes)
+{
+    m_worker = std::thread(&AsyncDumpWriter::run, this);
+}
+
+AsyncDumpWriter::~AsyncDumpWriter()
+{
+#if defined(_WIN32)
+    // Static destructors run from DLL detach. At process exit the worker has
+    // already been terminated, possibly while holding m_lock, so write
+    // whatever is left from here without locking.
+    if (WaitForSingleObject(m_worker.native_handle(), 0) == WAIT_OBJECT_0)
+    {
+        for (const Request& req : m_queue)
+        {
+            writeFile(req.path, req.data.data(), req.data.size(), req.append, req.binary);
+        }
+        m_queue.clear();
+        m_worker.detach();
+        return;
+    }
+#endif
+    std::unique_lock<std::mutex> guard(m_lock);
+    m_exit = true;
+    m_hasWork.notify_all();
+    // the worker empties the queue before it stops
+    m_hasRoom.wait(guard, [&]() { return m_stopped; });
+    guard.unlock();
+#if defined(_WIN32)
+    // The worker is done, but joining it from DLL detach would deadlock on
+    // the loader lock its thread exit needs.
+    m_worker.detach();
+#else
+    m_worker.join();
+#endif
+}
+
+void AsyncDumpWriter::submit(std::string path, std::string&& data, bool append, bool binary)
+{
+    const size_t size = data.size();
+    {
+        std::unique_lock<std::mutex> guard(m_lock);
+        // A buffer larger than the whole queue is still accepted once the
+        // queue is empty.
+        m_hasRoom.wait(guard, [&]() {
+            return m_queuedBytes == 0 || m_queuedBytes + size <= m_maxQueuedBytes;
+        });
+        m_queue.push_back(Request{ std::move(path), std::move(data), append, binary });
+        m_queuedBytes += size;
+    }
+    m_hasWork.notify_one();
+}
+
+void AsyncDumpWriter::run()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+    while (true)
+    {
+        m_hasWork.wait(guard, [&]() { return m_exit || !m_queue.empty(); });
+        if (m_queue.empty())
+        {
+            break;
+        }
+        Request req = std::move(m_queue.front());
+        m_queue.pop_front();
+
+        guard.unlock();
+        writeFile(req.path, req.data.data(), req.data.size(), req.append, req.binary);
+        guard.lock();
+
+        m_queuedBytes -= req.data.size();
+        m_hasRoom.notify_all();
+    }
+    m_stopped = true;
+    m_hasRoom.notify_all();
+}
+
+void WriteDumpFile(const std::string& path, std::string&& data, bool append, bool binary)
+{
+    if (IGC_IS_FLAG_ENABLED(EnableAsyncDumps))
+    {
+        AsyncDumpWriter::get().submit(path, std::move(data), append, binary);
+        return;
+    }
+    writeFile(path, data.data(), data.size(), append, binary);
+}
+
+void WriteDumpFile(const std::string& path, const char* data, size_t size, bool append, bool binary)
+{
+    if (IGC_IS_FLAG_ENABLED(EnableAsyncDumps))
+    {
+        // the caller keeps its buffer, so the queue needs a copy
+        AsyncDumpWriter::get().submit(path, std::string(data, size), append, binary);
+        return;
+    }
+    writeFile(path, data, size, append, binary);
+}
+
+} // namespace Debug
+} // namespace IGC
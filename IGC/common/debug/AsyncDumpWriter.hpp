@@ -0,0 +1,73 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace IGC
+{
+namespace Debug
+{
+    /// Writes dump files on a background thread so that dumping does not
+    /// stall the compile. Buffers are moved into the queue and written in
+    /// submission order, so appends to one file stay ordered. submit()
+    /// blocks while the queue holds more than the configured number of
+    /// bytes. Whatever is still queued at exit is written before the
+    /// destructor returns.
+    class AsyncDumpWriter
+    {
+    public:
+        static AsyncDumpWriter& get();
+
+        void submit(std::string path, std::string&& data, bool append, bool binary);
+
+        ~AsyncDumpWriter();
+
+        AsyncDumpWriter(const AsyncDumpWriter&) = delete;
+        AsyncDumpWriter& operator=(const AsyncDumpWriter&) = delete;
+
+    private:
+        explicit AsyncDumpWriter(size_t maxQueuedBytes);
+
+        struct Request
+        {
+            std::string path;
+            std::string data;
+            bool append;
+            bool binary;
+        };
+
+        void run();
+
+        std::mutex              m_lock;
+        std::condition_variable m_hasWork;
+        std::condition_variable m_hasRoom;
+        std::deque<Request>     m_queue;
+        size_t                  m_queuedBytes = 0;
+        const size_t            m_maxQueuedBytes;
+        bool                    m_exit = false;
+        // set by the worker once it has emptied the queue after m_exit
+        bool                    m_stopped = false;
+        std::thread             m_worker;
+    };
+
+    /// Write (or append) data to path. With EnableAsyncDumps the buffer is
+    /// handed to the AsyncDumpWriter, otherwise it is written right away.
+    void WriteDumpFile(const std::string& path, std::string&& data, bool append, bool binary);
+
+    /// Same for a buffer the caller keeps. It is only copied when the write
+    /// is queued.
+    void WriteDumpFile(const std::string& path, const char* data, size_t size, bool append, bool binary);
+} // namespace Debug
+} // namespace IGC
@@ -7,6 +7,7 @@ SPDX-License-Identifier: MIT
 ============================= end_copyright_notice ===========================*/
 
 #include "common/debug/Dump.hpp"
+#include "common/debug/AsyncDumpWriter.hpp"
 
 #include "common/debug/TeeOutputStream.hpp"
 
@@ -631,20 +632,9 @@ void Dump::flush()
     {
         return;
     }
-    std::ios_base::openmode mode = std::ios_base::out;
-    if (m_ClearFile)
-    {
-        m_ClearFile = false;
-    }
-    else
-    {
-        mode |= std::ios_base::app;
-    }
-    if (!isText(m_type))
-        mode |= std::ios_base::binary;
-    std::ofstream asmFile(m_name.str(), mode);
-    asmFile << m_string;
-    asmFile.close();
+    const bool append = !m_ClearFile;
+    m_ClearFile = false;
+    WriteDumpFile(m_name.str(), std::move(m_string), append, !isText(m_type));
     m_string.clear();
 }
 
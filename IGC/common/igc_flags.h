@@ -119,6 +119,7 @@ DECLARE_IGC_REGKEY(bool, DisableCodeSinkingInputVec,    false, "Setting this to
 DECLARE_IGC_REGKEY(DWORD, LoopSinkMinSave,              5,  "If loop sink can have save more than this Minimum, do it; otherwise, skip", false)
 DECLARE_IGC_REGKEY(DWORD, LoopSinkThresholdDelta,       50,  "Do loop sink If the estimated register pressure is higher than this + #avaialble registers", false)
 DECLARE_IGC_REGKEY(bool, DisableCodeHoisting,           false, "Setting this to 1/true adds a compiler switch to disable code-hoisting", false)
+DECLARE_IGC_REGKEY(bool, DisableProfileGuidedLayout,    false, "Setting this to 1/true disables placing the likely successor of a branch as its fall-through in block layout", false)
 DECLARE_IGC_REGKEY(bool, DisableDeSSA,                  false, "Setting this to 1/true adds a compiler switch to disable optimized De-SSA", false)
 DECLARE_IGC_REGKEY(bool, EnableDeSSAWA,                 true,  "[tmp]Keep some piece of code to avoid perf regression", false)
 DECLARE_IGC_REGKEY(DWORD, EnableDeSSAAlias,             3, "[tmp]Enable adding alias feature to DeSSA (3: dessa alias on)", false)
@@ -127,6 +128,7 @@ DECLARE_IGC_REGKEY(bool, DisablePayloadCoalescing_RT,   false, "Setting this to
 DECLARE_IGC_REGKEY(bool, DisablePayloadCoalescing_Sample, false, "Setting this to 1/true adds a compiler switch to disable payload coalescing optimization for Samplers only", false)
 DECLARE_IGC_REGKEY(bool, DisablePayloadCoalescing_URB,  false, "Setting this to 1/true adds a compiler switch to disable payload coalescing optimization for URB writes only", false)
 DECLARE_IGC_REGKEY(bool, DisableUniformAnalysis,        false, "Setting this to 1/true adds a compiler switch to disable uniform_analysis", false)
+DECLARE_IGC_REGKEY(bool, EnableUniformBroadcastReuse,   false,  "Reuse the full-width copy of a uniform value for all its vector uses within a basic block", false)
 DECLARE_IGC_REGKEY(bool, EnableWorkGroupUniformGoto,    false, "Setting to 1 enables generating uniform goto for work group uniform [eu fusion only]", false)
 DECLARE_IGC_REGKEY(DWORD, DisablePushConstant,           0, "Bit mask to disable push constant per shader stages. bit0 = All, Bit 1 = VS, Bit 2 = HS, Bit 3 = DS, Bit 4 = GS, Bit 5 = PS", false)
 DECLARE_IGC_REGKEY(DWORD, DisableAttributePush,          0, "Bit mask to disable push Attribute per shader stages. bit0 = All, Bit 1 = VS, Bit 2 = HS, Bit 3 = DS, Bit 4 = GS", false)
@@ -211,6 +213,8 @@ DECLARE_IGC_REGKEY(DWORD, RovOpt,                           3, "Bitmask for ROV
 DECLARE_IGC_REGKEY(bool, EnablePlatformFenceOpt,        true,  "Force DG2 only fence optimization", false)
 DECLARE_IGC_REGKEY(bool, EnableSLMConstProp,            true,   "Enable SLM constant propagation (compute shader only).", false)
 DECLARE_IGC_REGKEY(bool, EnableStatelessToStateful,    true,  "Enable Stateless To Stateful transformation for global and constant address space in OpenCL kernels", false)
+DECLARE_IGC_REGKEY(bool, EnableStatelessToStatefulAcrossCalls, true, "Let Stateless To Stateful trace pointers through private memory spills and into functions called from a single kernel", false)
+DECLARE_IGC_REGKEY(bool, EnableOptReportStatelessToStateful, false, "Generate opt report file listing the accesses promoted by Stateless To Stateful", false)
 DECLARE_IGC_REGKEY(bool, EnableStatefulToken,           true,  "Enable generating patch token to indicate a ptr argument is fully converted to stateful (temporary)", false)
 DECLARE_IGC_REGKEY(bool, EnableGenUpdateCB,             false, "Enable derived constant optimization.", false)
 DECLARE_IGC_REGKEY(bool, EnableGenUpdateCBResInfo,      false, "Enable derived constant optimization with resinfo.", false)
@@ -318,6 +322,8 @@ DECLARE_IGC_REGKEY(bool, InterleaveSourceShader,        true, "Interleave the so
 DECLARE_IGC_REGKEY(bool, ShaderDumpPidDisable,          false, "disabled adding PID to the name of shader dump directory", true)
 DECLARE_IGC_REGKEY(bool, DumpToCurrentDir,              false, "dump shaders to the current directory", true)
 DECLARE_IGC_REGKEY(debugString, DumpToCustomDir,        0,     "Dump shaders to custom directory. Parent directory must exist.", true)
+DECLARE_IGC_REGKEY(bool, EnableAsyncDumps,              false, "Write shader dumps on a background thread instead of the compile thread", true)
+DECLARE_IGC_REGKEY(DWORD, AsyncDumpQueueSizeMB,         64,    "Max size in MB of dumps queued for the background writer before dumping blocks", true)
 DECLARE_IGC_REGKEY(bool, EnableShaderNumbering,         false, "Number shaders in the order they are dumped based on their hashes", true)
 DECLARE_IGC_REGKEY(bool, PrintToConsole,                false, "dump to console", true)
 DECLARE_IGC_REGKEY(bool, DumpCompilerStats,             false, "dump compiler statistics", true)
@@ -363,9 +369,12 @@ DECLARE_IGC_REGKEY(bool, SendMultipleSIMDModesCS,       true,  "Send multiple SI
 DECLARE_IGC_REGKEY(DWORD, OCLSIMD16SelectionMask,       6,     "Select SIMD 16 heuristics. Valid values are 0, 1, 2 and 3", false)
 DECLARE_IGC_REGKEY(bool, EnableHSSinglePatchDispatch,   false, "Setting this to 1/true enables SIMD8 single-patch dispatch in HullShader. Default is either SIMD8 single patch/dual patch dispatch based on control point count", false)
 DECLARE_IGC_REGKEY(bool, DisableGPGPUIndirectPayload,   false, "Disable OCL indirect GPGPU payload", false)
+DECLARE_IGC_REGKEY(bool, EnableSPIRVLazyTranslation,    false, "Only translate SPIR-V functions reachable from kernels, exported or indirectly called functions", false)
+DECLARE_IGC_REGKEY(bool, EnableConcurrentCompile,       false, "Each OCL build works on its own copy of the IGC flags so that builds can safely run concurrently", true)
 DECLARE_IGC_REGKEY(bool, DisableDSDualPatch,            false, "Setting it to true with enable Single and Dual Patch dispatch mode for Domain Shader", false)
 DECLARE_IGC_REGKEY(bool, DisableMemOpt,                 false, "Disable MemOpt, merging load/store", false)
 DECLARE_IGC_REGKEY(bool, DisableMemOpt2,                false, "Disable MemOpt2", false)
+DECLARE_IGC_REGKEY(bool, EnableMemOptAcrossBlocks,      false, "Let MemOpt merge loads/stores across blocks that always execute together (fall-through chains)", false)
 DECLARE_IGC_REGKEY(bool, DisablePreRAScheduler,         false, "Disable Pre RA Scheduling", false)
 DECLARE_IGC_REGKEY(DWORD,MaxLiveOutThreshold,           0,     "Max LiveOut Threshold in MemOpt2", false)
 DECLARE_IGC_REGKEY(bool, DisableScalarAtomics,          false, "Disable the Scalar Atomics optimization", false)
@@ -482,6 +491,7 @@ DECLARE_IGC_REGKEY(bool, EnablePartialEmuI64,  true,  "Enable the partial I64 em
 DECLARE_IGC_REGKEY(DWORD, LscLoadCacheControlOverride, 0, "Overrides cache-control options for non-intrinsic LSC loads.  Off=0, L1UC_L3UC=1, L1UC_L3C=2, L1C_L3UC=3, L1C_L3C=4, L1S_L3UC=5, L1S_L3C=6, L1IAR_L3C=7", true)
 DECLARE_IGC_REGKEY(DWORD, LscStoreCacheControlOverride, 0, "Overrides cache-control options for non-intrinsic LSC stores.  Off=0, L1UC_L3UC=1, L1UC_L3WB=2, L1WT_L3UC=3, L1WT_L3WB=4, L1S_L3UC=5, L1S_L3WB=6, L1WB_L3WB=7", true)
 DECLARE_IGC_REGKEY(bool, LscForceSpillNonStackcall, false, "Non-stack call kernels that spill will use LSC on DG2+", true)
+DECLARE_IGC_REGKEY(bool, EnableJointMatrix2DBlock, false, "Resolve JointMatrix loads/stores to LSC 2d block messages when layout, stride and alignment allow [PVC+]", true)
 DECLARE_IGC_REGKEY(bool, EnableQWAddSupport, true, "Enable QW Add support", true)
 DECLARE_IGC_REGKEY(bool, ForceQWAddSupport, false, "Force enabling the QW Add support along with ForcePartialInt64", true)
 DECLARE_IGC_REGKEY(bool, ForcePartialInt64, false, "Force hasPartialInt64Support() regardless of the stepping", true)
@@ -600,6 +610,8 @@ DECLARE_IGC_REGKEY(bool, EnableSubroutineForEmulation,  true,  "Enable subroutin
 DECLARE_IGC_REGKEY(bool, ForceSubroutineForEmulation,   false,  "Force subroutine call for all emulation functions if emulation(double) is on.", false)
 DECLARE_IGC_REGKEY(DWORD, InlinedEmulationThreshold,    125000, "Inlined instruction threshold for enabling subroutines", false)
 DECLARE_IGC_REGKEY(int, ByPassAllocaSizeHeuristic,   0,  "Force some Alloca to pass the pressure heuristic until the given size", false)
+DECLARE_IGC_REGKEY(bool, EnablePartialPrivateArrayPromotion, false, "Promote the hottest constant-indexed rows of a private array that is too large to be promoted to registers as a whole", false)
+DECLARE_IGC_REGKEY(bool, EnableOptReportPromotePrivateArray, false, "Generate opt report file with the register or scratch decision for every private alloca", false)
 DECLARE_IGC_REGKEY(DWORD, MemOptWindowSize,   150,  "Size of the window in unit of instructions in which load/stores are allowed to be coalesced. Keep it limited in order to avoid creating long liveranges. Default value is 150", false)
 DECLARE_IGC_REGKEY(bool, ForceNoFP64bRegioning, false, "force regioning rules for FP and 64b FPU instructions", false)
 DECLARE_IGC_REGKEY(bool, EmitDebugLoc, true, "Enable generation of .debug_loc section", false)
@@ -615,6 +627,7 @@ DECLARE_IGC_REGKEY(bool, UseOldSubRoutineAugIntf, false, "Use the old subroutine
 DECLARE_IGC_REGKEY(bool, DisableFastRAWA, true, "Disable Fast RA for hanging issues on large workloads", false)
 DECLARE_IGC_REGKEY(bool, FastCompileRA, false, "Provide the fast compilatoin path for RA, fail safe at first iteration", false)
 DECLARE_IGC_REGKEY(bool, HybridRAWithSpill, false, "Did Hybrid RA with Spill", false)
+DECLARE_IGC_REGKEY(bool, FastCompileTier0, false, "Tier-0 compile: linear scan RA with spilling and only the vISA passes required for correctness", false)
 DECLARE_IGC_REGKEY(DWORD, StripDebugInfo, 0,
     "Strip debug info from llvm IR lowered from input to IGC ."\
     "Possible values: 0 - dont strip, 1 - strip all, 2 - strip non-line info",
@@ -42,6 +42,7 @@ SPDX-License-Identifier: MIT
 #define IGC_REGISTRY_KEY "SOFTWARE\\INTEL\\IGFX\\IGC"
 
 SRegKeysList g_RegKeyList;
+thread_local SRegKeysList* g_pThreadRegKeyList = nullptr;
 
 #if defined(_WIN64) || defined(_WIN32)
 
@@ -857,6 +858,46 @@ void SetCurrentDebugHash(unsigned long long hash)
     g_CurrentShaderHash = hash;
 }
 
+// innermost snapshot scope open on this thread
+static thread_local RegKeySnapshotScope* g_pThreadRegKeyScope = nullptr;
+
+RegKeySnapshotScope::RegKeySnapshotScope(bool enable)
+    : m_enabled(enable)
+{
+    if (m_enabled)
+    {
+        // Nested scopes read the values of the enclosing one until they
+        // write.
+        m_prevScope = g_pThreadRegKeyScope;
+        m_prevList = g_pThreadRegKeyList;
+        g_pThreadRegKeyScope = this;
+    }
+}
+
+RegKeySnapshotScope::~RegKeySnapshotScope()
+{
+    if (m_enabled)
+    {
+        g_pThreadRegKeyScope = m_prevScope;
+        g_pThreadRegKeyList = m_prevList;
+    }
+}
+
+SRegKeysList& GetWritableRegKeyList()
+{
+    RegKeySnapshotScope* scope = g_pThreadRegKeyScope;
+    if (!scope)
+    {
+        return g_RegKeyList;
+    }
+    if (!scope->m_copy)
+    {
+        scope->m_copy.reset(new SRegKeysList(IGC_REGKEY_LIST()));
+        g_pThreadRegKeyList = scope->m_copy.get();
+    }
+    return *scope->m_copy;
+}
+
 /*****************************************************************************\
 
 Function:
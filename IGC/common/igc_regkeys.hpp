@@ -14,6 +14,7 @@ PURPOSE: Defines meta data for holding/defining regkey variables
 #include "IGC/common/igc_debug.h"
 #include "IGC/common/igc_flags.hpp"
 #include "common/SysUtils.hpp"
+#include <memory>
 #include <string>
 
 typedef char debugString[256];
@@ -100,24 +101,36 @@ struct SRegKeysList
 #undef DECLARE_IGC_REGKEY
 bool CheckHashRange(const SRegKeyVariableMetaData& varname);
 extern SRegKeysList g_RegKeyList;
+// A compilation may install its own copy of the regkeys for the current
+// thread (see RegKeySnapshotScope); all flag accessors go through it, and
+// read it once per access since a thread_local access is not free.
+extern thread_local SRegKeysList* g_pThreadRegKeyList;
+#define IGC_REGKEY_LIST() (g_pThreadRegKeyList ? *g_pThreadRegKeyList : g_RegKeyList)
+// The list flags are written to: the current snapshot, copied on the first
+// write, or g_RegKeyList outside of a snapshot scope.
+SRegKeysList& GetWritableRegKeyList();
 #if defined(LINUX_RELEASE_MODE)
 #define IGC_GET_FLAG_VALUE(name)                 \
-  ((CheckHashRange(g_RegKeyList.name) && g_RegKeyList.name.IsReleaseMode()) ? g_RegKeyList.name.m_Value : g_RegKeyList.name.GetDefault())
-#define IGC_GET_FLAG_DEFAULT_VALUE(name)         (g_RegKeyList.name.GetDefault())
+  ([]() -> unsigned { const SRegKeysList& list = IGC_REGKEY_LIST(); \
+    return (CheckHashRange(list.name) && list.name.IsReleaseMode()) ? list.name.m_Value : list.name.GetDefault(); }())
+#define IGC_GET_FLAG_DEFAULT_VALUE(name)         (IGC_REGKEY_LIST().name.GetDefault())
 #define IGC_IS_FLAG_ENABLED(name)                (IGC_GET_FLAG_VALUE(name) != 0)
 #define IGC_IS_FLAG_DISABLED(name)               (!IGC_IS_FLAG_ENABLED(name))
-#define IGC_SET_FLAG_VALUE(name, regkeyValue)    (g_RegKeyList.name.m_Value = regkeyValue)
+#define IGC_SET_FLAG_VALUE(name, regkeyValue)    (GetWritableRegKeyList().name.m_Value = regkeyValue)
 #define IGC_GET_REGKEYSTRING(name)               \
-  ((CheckHashRange(g_RegKeyList.name) && g_RegKeyList.name.IsReleaseMode()) ? g_RegKeyList.name.m_string : "")
+  ([]() -> const char* { const SRegKeysList& list = IGC_REGKEY_LIST(); \
+    return (CheckHashRange(list.name) && list.name.IsReleaseMode()) ? list.name.m_string : ""; }())
 #else
 #define IGC_GET_FLAG_VALUE(name)                 \
-  (CheckHashRange(g_RegKeyList.name) ? g_RegKeyList.name.m_Value : g_RegKeyList.name.GetDefault())
-#define IGC_GET_FLAG_DEFAULT_VALUE(name)         (g_RegKeyList.name.GetDefault())
+  ([]() -> unsigned { const SRegKeysList& list = IGC_REGKEY_LIST(); \
+    return CheckHashRange(list.name) ? list.name.m_Value : list.name.GetDefault(); }())
+#define IGC_GET_FLAG_DEFAULT_VALUE(name)         (IGC_REGKEY_LIST().name.GetDefault())
 #define IGC_IS_FLAG_ENABLED(name)                (IGC_GET_FLAG_VALUE(name) != 0)
 #define IGC_IS_FLAG_DISABLED(name)               (!IGC_IS_FLAG_ENABLED(name))
-#define IGC_SET_FLAG_VALUE(name, regkeyValue)    (g_RegKeyList.name.m_Value = regkeyValue)
+#define IGC_SET_FLAG_VALUE(name, regkeyValue)    (GetWritableRegKeyList().name.m_Value = regkeyValue)
 #define IGC_GET_REGKEYSTRING(name)               \
-  (CheckHashRange(g_RegKeyList.name) ? g_RegKeyList.name.m_string : "")
+  ([]() -> const char* { const SRegKeysList& list = IGC_REGKEY_LIST(); \
+    return CheckHashRange(list.name) ? list.name.m_string : ""; }())
 #endif
 
 #define IGC_REGKEY_OR_FLAG_ENABLED(name, flag) (IGC_IS_FLAG_ENABLED(name) || IGC::Debug::GetDebugFlag(IGC::Debug::DebugFlag::flag))
@@ -144,11 +157,41 @@ void DumpIGCRegistryKeyDefinitions();
 void DumpIGCRegistryKeyDefinitions3(std::string driverRegistryPath, unsigned long pciBus, unsigned long pciDevice, unsigned long pciFunction);
 void LoadRegistryKeys(const std::string& options = "", bool *RegFlagNameError = nullptr);
 void SetCurrentDebugHash(unsigned long long hash);
+
+// Gives the calling thread a private view of the regkey values for the
+// lifetime of the object. Flags changed while compiling (IGC_SET_FLAG_VALUE)
+// then stay local to that build and neither race with nor leak into other
+// builds. The values are only copied on the first write, so builds that
+// don't change any flag read the shared list. The registry must already be
+// loaded.
+class RegKeySnapshotScope
+{
+public:
+    explicit RegKeySnapshotScope(bool enable = true);
+    ~RegKeySnapshotScope();
+    RegKeySnapshotScope(const RegKeySnapshotScope&) = delete;
+    RegKeySnapshotScope& operator=(const RegKeySnapshotScope&) = delete;
+
+private:
+    friend SRegKeysList& GetWritableRegKeyList();
+
+    bool m_enabled = false;
+    // private copy made by the first write
+    std::unique_ptr<SRegKeysList> m_copy;
+    RegKeySnapshotScope* m_prevScope = nullptr;
+    SRegKeysList* m_prevList = nullptr;
+};
+
 #undef LINUX_RELEASE_MODE
 #else
 static inline void GetKeysSetExplicitly(std::string* KeyValuePairs, std::string* OptionKeys) {}
 static inline void SetCurrentDebugHash(unsigned long long hash) {}
 static inline void LoadRegistryKeys(const std::string& options = "", bool *RegFlagNameError=nullptr) {}
+class RegKeySnapshotScope
+{
+public:
+    explicit RegKeySnapshotScope(bool enable = true) {}
+};
 #define IGC_SET_FLAG_VALUE(name, regkeyValue)
 #define DECLARE_IGC_REGKEY(dataType, regkeyName, defaultValue, description, releaseMode) \
     static const unsigned int regkeyName##default = (unsigned int)defaultValue;
@@ -0,0 +1,188 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Test of the compile telemetry callback: registers a callback with the IGC
+// library, builds a kernel through the OCL translation interface, and checks
+// the JSON record the build reports - the shader type, the coarse timers,
+// and the pass names, timings and instruction deltas.
+//
+// Usage: CompileTelemetryTest <path to libigc>
+
+#include "IGCLibraryBuild.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/JSON.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <dlfcn.h>
+#include <iostream>
+#include <vector>
+
+static unsigned g_numErrors = 0;
+
+static void check(bool cond, const std::string& what)
+{
+    if (!cond)
+    {
+        std::cerr << "FAIL: " << what << "\n";
+        ++g_numErrors;
+    }
+}
+
+// Matches IGC::Debug::CompileTelemetryCallback in AdaptorCommon/customApi.hpp.
+typedef void (*CompileTelemetryCallback)(const char* record, size_t size, void* userData);
+typedef void (*SetCompileTelemetryCallbackFn)(CompileTelemetryCallback callback, void* userData);
+
+static void collectRecord(const char* record, size_t size, void* userData)
+{
+    static_cast<std::vector<std::string>*>(userData)->emplace_back(record, size);
+}
+
+static bool isCount(const llvm::json::Object& obj, llvm::StringRef key, int64_t min)
+{
+    llvm::Optional<int64_t> value = obj.getInteger(key);
+    return value && *value >= min;
+}
+
+static void checkRecord(const std::string& record)
+{
+    llvm::Expected<llvm::json::Value> parsed = llvm::json::parse(record);
+    if (!parsed)
+    {
+        check(false, "record is not JSON: " + llvm::toString(parsed.takeError()));
+        return;
+    }
+    const llvm::json::Object* root = parsed->getAsObject();
+    if (!root)
+    {
+        check(false, "record is not a JSON object");
+        return;
+    }
+
+    check(root->getString("type") == llvm::Optional<llvm::StringRef>("OCL"), "type is OCL");
+    check(isCount(*root, "retryId", 0), "retryId is a count");
+    check(isCount(*root, "spillSize", 0), "spillSize is a count");
+    check(root->getInteger("asmHash").hasValue(), "asmHash is present");
+
+    const llvm::json::Object* timers = root->getObject("timers");
+    check(timers && !timers->empty(), "timers are reported");
+    if (timers)
+    {
+        for (const auto& timer : *timers)
+        {
+            const llvm::json::Object* t = timer.second.getAsObject();
+            const std::string name = timer.first.str();
+            check(t && isCount(*t, "ns", 0), "timer " + name + " has ns");
+            check(t && isCount(*t, "hits", 0), "timer " + name + " has hits");
+        }
+    }
+
+    const llvm::json::Array* passes = root->getArray("passes");
+    check(passes && !passes->empty(), "passes are reported");
+    if (!passes)
+    {
+        return;
+    }
+    bool sawUnify = false;
+    bool sawCodeGen = false;
+    bool sawInstDelta = false;
+    for (const llvm::json::Value& value : *passes)
+    {
+        const llvm::json::Object* pass = value.getAsObject();
+        check(pass != nullptr, "pass entry is an object");
+        if (!pass)
+        {
+            continue;
+        }
+        llvm::Optional<llvm::StringRef> name = pass->getString("name");
+        check(name && !name->empty(), "pass has a name");
+        const std::string passName = name ? name->str() : "<unnamed>";
+        check(isCount(*pass, "ns", 0), "pass " + passName + " has ns");
+        check(isCount(*pass, "hits", 1), "pass " + passName + " ran");
+        llvm::Optional<int64_t> instDelta = pass->getInteger("instDelta");
+        check(instDelta.hasValue(), "pass " + passName + " has instDelta");
+
+        // Pass names are prefixed with the name of their IGCPassManager.
+        sawUnify |= name && name->startswith("Unify_");
+        sawCodeGen |= name && name->startswith("CG_");
+        sawInstDelta |= instDelta && *instDelta != 0;
+    }
+    check(sawUnify, "the unification passes are reported");
+    check(sawCodeGen, "the code generation passes are reported");
+    check(sawInstDelta, "some pass changes the instruction count");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <path to libigc>\n";
+        return 1;
+    }
+
+    auto package = CIF::OpenLibraryInterface(CIF::OpenLibrary(argv[1], false));
+    if (!package || !package->IsValid())
+    {
+        std::cerr << "cannot load " << argv[1] << "\n";
+        return 1;
+    }
+    void* library = dlopen(argv[1], RTLD_NOW | RTLD_LOCAL);
+    auto setCallback = library ?
+        reinterpret_cast<SetCompileTelemetryCallbackFn>(dlsym(library, "SetCompileTelemetryCallback")) :
+        nullptr;
+    if (!setCallback)
+    {
+        std::cerr << "no SetCompileTelemetryCallback in " << argv[1] << "\n";
+        return 1;
+    }
+
+    CIF::CIFMain* main = package->GetCIFMain();
+    auto device = main->CreateInterface<IGC::IgcOclDeviceCtxTagOCL>();
+    if (!device)
+    {
+        std::cerr << "no IGC device context\n";
+        return 1;
+    }
+    setupDevice(*device);
+    std::mutex deviceLock;
+
+    const std::string bitcode = makeKernelBitcode();
+    if (bitcode.empty())
+    {
+        return 1;
+    }
+
+    std::vector<std::string> records;
+    setCallback(collectRecord, &records);
+    std::string log;
+    std::string binary = buildKernel(main, *device, deviceLock, bitcode, "", log);
+    check(!binary.empty(), "build failed: " + log);
+    check(records.size() == 1, "one record per compile");
+    if (!records.empty())
+    {
+        checkRecord(records.front());
+    }
+
+    // Nothing is reported once the callback is unregistered.
+    setCallback(nullptr, nullptr);
+    records.clear();
+    binary = buildKernel(main, *device, deviceLock, bitcode, "", log);
+    check(!binary.empty(), "build without telemetry failed: " + log);
+    check(records.empty(), "no record without a callback");
+
+    dlclose(library);
+
+    if (g_numErrors)
+    {
+        std::cerr << g_numErrors << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "PASSED\n";
+    return 0;
+}
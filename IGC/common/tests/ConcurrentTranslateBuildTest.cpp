@@ -0,0 +1,118 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Stress test for concurrent builds in EnableConcurrentCompile mode. Several
+// threads compile the same kernel through the OCL translation interface of
+// the IGC library, the way the runtime does for concurrent clBuildProgram
+// calls, so every build goes through TranslateBuild at the same time as the
+// others. Each build must succeed and produce the binary the same build
+// produces on its own. Meant to be run under TSan.
+//
+// Usage: ConcurrentTranslateBuildTest <path to libigc> [builds] [iterations]
+
+#include "IGCLibraryBuild.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static std::atomic<unsigned> g_numErrors{ 0 };
+
+static void check(bool cond, const std::string& what, unsigned build)
+{
+    if (!cond)
+    {
+        if (g_numErrors++ < 16)
+        {
+            std::cerr << "build " << build << ": " << what << "\n";
+        }
+    }
+}
+
+// Builds alternate between these, so concurrent builds don't all take the
+// same path through the compiler.
+static const char* const Options[] = { "", "-cl-opt-disable" };
+static const unsigned NumOptions = sizeof(Options) / sizeof(Options[0]);
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <path to libigc> [builds] [iterations]\n";
+        return 1;
+    }
+    const unsigned numBuilds = argc > 2 ? std::atoi(argv[2]) : 8;
+    const unsigned iterations = argc > 3 ? std::atoi(argv[3]) : 4;
+
+    // Read when the library loads its regkeys.
+    setenv("IGC_EnableConcurrentCompile", "1", 1);
+
+    auto package = CIF::OpenLibraryInterface(CIF::OpenLibrary(argv[1], false));
+    if (!package || !package->IsValid())
+    {
+        std::cerr << "cannot load " << argv[1] << "\n";
+        return 1;
+    }
+    CIF::CIFMain* main = package->GetCIFMain();
+    auto device = main->CreateInterface<IGC::IgcOclDeviceCtxTagOCL>();
+    if (!device)
+    {
+        std::cerr << "no IGC device context\n";
+        return 1;
+    }
+    setupDevice(*device);
+    std::mutex deviceLock;
+
+    const std::string bitcode = makeKernelBitcode();
+    if (bitcode.empty())
+    {
+        return 1;
+    }
+
+    // What each set of options produces when nothing else is compiling.
+    std::vector<std::string> expected(NumOptions);
+    for (unsigned o = 0; o < NumOptions; ++o)
+    {
+        std::string log;
+        expected[o] = buildKernel(main, *device, deviceLock, bitcode, Options[o], log);
+        if (expected[o].empty())
+        {
+            std::cerr << "serial build with '" << Options[o] << "' failed: " << log << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<std::thread> builds;
+    for (unsigned b = 0; b < numBuilds; ++b)
+    {
+        builds.emplace_back([&, b]() {
+            for (unsigned i = 0; i < iterations; ++i)
+            {
+                unsigned o = (b + i) % NumOptions;
+                std::string log;
+                std::string binary = buildKernel(main, *device, deviceLock, bitcode, Options[o], log);
+                check(!binary.empty(), "failed: " + log, b);
+                check(binary.empty() || binary == expected[o],
+                    std::string("binary differs from a serial build with '") + Options[o] + "'", b);
+            }
+        });
+    }
+    for (auto& t : builds)
+    {
+        t.join();
+    }
+
+    if (g_numErrors)
+    {
+        std::cerr << g_numErrors << " errors\n";
+        return 1;
+    }
+    return 0;
+}
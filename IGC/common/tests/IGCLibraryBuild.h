@@ -0,0 +1,140 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Helpers for the tests that drive the IGC library the way the OpenCL
+// runtime does: load it through CIF, describe a device, and build a small
+// kernel from LLVM bitcode.
+
+#pragma once
+
+#include "cif/common/cif_main.h"
+#include "cif/import/cif_main.h"
+#include "cif/builtins/memory/buffer/buffer.h"
+#include "ocl_igc_interface/code_type.h"
+#include "ocl_igc_interface/igc_ocl_device_ctx.h"
+#include "inc/common/igfxfmid.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <cstring>
+#include <mutex>
+#include <string>
+
+// buf[id] += value, with the metadata clang emits for an OpenCL kernel.
+static const char* const KernelIR = R"(
+target datalayout = "e-p:64:64-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024-n8:16:32:64"
+target triple = "spir64-unknown-unknown"
+
+define spir_kernel void @add(i32 addrspace(1)* %buf, i32 %value) !kernel_arg_addr_space !1 !kernel_arg_access_qual !2 !kernel_arg_type !3 !kernel_arg_base_type !3 !kernel_arg_type_qual !4 {
+entry:
+  %id = call spir_func i64 @_Z13get_global_idj(i32 0)
+  %p = getelementptr inbounds i32, i32 addrspace(1)* %buf, i64 %id
+  %v = load i32, i32 addrspace(1)* %p, align 4
+  %r = add i32 %v, %value
+  store i32 %r, i32 addrspace(1)* %p, align 4
+  ret void
+}
+
+declare spir_func i64 @_Z13get_global_idj(i32)
+
+!opencl.ocl.version = !{!0}
+!opencl.spir.version = !{!0}
+
+!0 = !{i32 1, i32 2}
+!1 = !{i32 1, i32 0}
+!2 = !{!"none", !"none"}
+!3 = !{!"int*", !"int"}
+!4 = !{!"", !""}
+)";
+
+static inline std::string makeKernelBitcode()
+{
+    llvm::LLVMContext context;
+    llvm::SMDiagnostic error;
+    std::unique_ptr<llvm::Module> module = llvm::parseAssemblyString(KernelIR, error, context);
+    if (!module)
+    {
+        error.print("KernelIR", llvm::errs());
+        return std::string();
+    }
+    std::string bitcode;
+    llvm::raw_string_ostream os(bitcode);
+    llvm::WriteBitcodeToFile(*module, os);
+    os.flush();
+    return bitcode;
+}
+
+// A Gen12LP device, as the runtime describes it to the compiler.
+static inline void setupDevice(IGC::IgcOclDeviceCtxTagOCL& device)
+{
+    auto platform = device.GetPlatformHandle();
+    platform->SetProductFamily(IGFX_TIGERLAKE_LP);
+    platform->SetRenderCoreFamily(IGFX_GEN12LP_CORE);
+    platform->SetDisplayCoreFamily(IGFX_GEN12LP_CORE);
+    platform->SetDeviceID(0x9A49);
+    platform->SetRevId(0);
+
+    auto sysInfo = device.GetGTSystemInfoHandle();
+    sysInfo->SetEUCount(96);
+    sysInfo->SetThreadCount(96 * 7);
+    sysInfo->SetSliceCount(1);
+    sysInfo->SetSubSliceCount(6);
+    sysInfo->SetMaxEuPerSubSlice(16);
+    sysInfo->SetMaxSlicesSupported(1);
+    sysInfo->SetMaxSubSlicesSupported(6);
+    sysInfo->SetMaxDualSubSlicesSupported(6);
+    sysInfo->SetDualSubSliceCount(6);
+}
+
+// Compiles the bitcode with the given options; returns the binary, or an
+// empty string and the build log when the build fails. The device context
+// is only touched under deviceLock, as in the runtime.
+static inline std::string buildKernel(CIF::CIFMain* main, IGC::IgcOclDeviceCtxTagOCL& device,
+    std::mutex& deviceLock, const std::string& bitcode, const char* options, std::string& log)
+{
+    CIF::RAII::UPtr_t<IGC::IgcOclTranslationCtxTagOCL> translator;
+    {
+        std::lock_guard<std::mutex> guard(deviceLock);
+        translator = device.CreateTranslationCtx(IGC::CodeType::llvmBc, IGC::CodeType::oclGenBin);
+    }
+    if (!translator)
+    {
+        log = "no translation context";
+        return std::string();
+    }
+
+    auto src = CIF::Builtins::CreateConstBuffer<CIF::Builtins::BufferSimple>(
+        main, bitcode.data(), bitcode.size());
+    auto opts = CIF::Builtins::CreateConstBuffer<CIF::Builtins::BufferSimple>(
+        main, options, strlen(options) + 1);
+    auto internalOpts = CIF::Builtins::CreateConstBuffer<CIF::Builtins::BufferSimple>(
+        main, "", 1);
+    auto output = translator->Translate(src.get(), opts.get(), internalOpts.get(), nullptr, 0);
+    if (!output || !output->Successful())
+    {
+        auto* buildLog = output ? output->GetBuildLog() : nullptr;
+        log = buildLog && buildLog->GetSizeRaw() ?
+            std::string(buildLog->GetMemory<char>(), buildLog->GetSize<char>()) :
+            "translation failed";
+        return std::string();
+    }
+    auto* binary = output->GetOutput();
+    if (!binary || binary->GetSizeRaw() == 0)
+    {
+        log = "empty binary";
+        return std::string();
+    }
+    return std::string(binary->GetMemory<char>(), binary->GetSize<char>());
+}
@@ -0,0 +1,201 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Tests of igc-server and its client stub: the wire format round-trips and
+// rejects corrupt messages, and a running server builds a kernel, answers a
+// repeated build from its cache, survives a malformed request and cleans up
+// its socket when stopped.
+//
+// Usage: IgcServerTest <path to igc-server> <path to libigc>
+
+#include "IGCLibraryBuild.h"
+#include "ocl_igc_interface/igc_server_client.h"
+
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+using namespace IGC::Server;
+
+static unsigned g_numErrors = 0;
+
+static void check(bool cond, const std::string& what)
+{
+    if (!cond)
+    {
+        std::cerr << "FAIL: " << what << "\n";
+        ++g_numErrors;
+    }
+}
+
+static BuildRequest makeRequest(const std::string& bitcode, const char* options)
+{
+    BuildRequest request;
+    request.Device.ProductFamily = IGFX_TIGERLAKE_LP;
+    request.Device.RenderCoreFamily = IGFX_GEN12LP_CORE;
+    request.Device.DisplayCoreFamily = IGFX_GEN12LP_CORE;
+    request.Device.DeviceID = 0x9A49;
+    request.Device.EUCount = 96;
+    request.Device.ThreadCount = 96 * 7;
+    request.Device.SliceCount = 1;
+    request.Device.SubSliceCount = 6;
+    request.Device.MaxEuPerSubSlice = 16;
+    request.Device.MaxSlicesSupported = 1;
+    request.Device.MaxSubSlicesSupported = 6;
+    request.Device.MaxDualSubSlicesSupported = 6;
+    request.Device.DualSubSliceCount = 6;
+    request.InType = IGC::CodeType::llvmBc;
+    request.OutType = IGC::CodeType::oclGenBin;
+    request.Src = bitcode;
+    request.Options = options;
+    return request;
+}
+
+static void testProtocol()
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    {
+        check(false, "protocol: socketpair");
+        return;
+    }
+
+    BuildRequest request = makeRequest(std::string("\0bc\xff", 4), "-cl-opt-disable");
+    request.InternalOptions = "-internal";
+    std::string payload;
+    check(SendMessage(fds[0], Encode(request)), "protocol: send request");
+    check(ReceiveMessage(fds[1], payload), "protocol: receive request");
+    BuildRequest decoded;
+    check(Decode(payload, decoded), "protocol: decode request");
+    check(decoded.Src == request.Src && decoded.Options == request.Options &&
+        decoded.InternalOptions == request.InternalOptions &&
+        decoded.InType == request.InType && decoded.OutType == request.OutType &&
+        memcmp(&decoded.Device, &request.Device, sizeof(DeviceDesc)) == 0,
+        "protocol: request round-trips");
+
+    BuildResponse response;
+    response.Successful = true;
+    response.Output = std::string("\x7f" "ELF\0", 5);
+    response.BuildLog = "warning";
+    check(SendMessage(fds[1], Encode(response)), "protocol: send response");
+    check(ReceiveMessage(fds[0], payload), "protocol: receive response");
+    BuildResponse decodedResponse;
+    check(Decode(payload, decodedResponse) && decodedResponse.Successful &&
+        !decodedResponse.FromCache && decodedResponse.Output == response.Output &&
+        decodedResponse.BuildLog == response.BuildLog,
+        "protocol: response round-trips");
+
+    // Truncated or padded payloads and foreign streams are rejected.
+    const std::string encoded = Encode(request);
+    check(!Decode(encoded.substr(0, encoded.size() - 1), decoded), "protocol: truncated request");
+    check(!Decode(encoded + "x", decoded), "protocol: trailing bytes");
+    check(!Decode(std::string(), decodedResponse), "protocol: empty response");
+    const MessageHeader bogus = { 0x12345678, ProtocolVersion, 0 };
+    check(WriteAll(fds[0], &bogus, sizeof(bogus)), "protocol: send bogus header");
+    check(!ReceiveMessage(fds[1], payload), "protocol: bad magic");
+    const MessageHeader huge = { ProtocolMagic, ProtocolVersion, MaxPayloadSize + 1 };
+    check(WriteAll(fds[0], &huge, sizeof(huge)), "protocol: send oversized header");
+    check(!ReceiveMessage(fds[1], payload), "protocol: oversized payload");
+
+    close(fds[0]);
+    check(!ReceiveMessage(fds[1], payload), "protocol: closed peer");
+    close(fds[1]);
+}
+
+static void testServer(const char* serverPath, const char* libraryPath)
+{
+    const std::string socketPath = "/tmp/IgcServerTest." + std::to_string(getpid()) + ".sock";
+    pid_t server = fork();
+    if (server == 0)
+    {
+        execl(serverPath, serverPath, "-socket", socketPath.c_str(), "-igc", libraryPath,
+            "-workers", "2", static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    if (server < 0)
+    {
+        check(false, "server: fork");
+        return;
+    }
+
+    Client client;
+    int status = 0;
+    for (int i = 0; i < 300 && !client.Connect(socketPath); ++i)
+    {
+        if (waitpid(server, &status, WNOHANG) == server)
+        {
+            check(false, "server: exited at startup");
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    check(client.IsConnected(), "server: accepts connections");
+
+    const std::string bitcode = makeKernelBitcode();
+    BuildResponse first, second, other;
+    check(client.Build(makeRequest(bitcode, ""), first), "server: first build answered");
+    check(first.Successful && !first.Output.empty(), "server: first build succeeds: " + first.BuildLog);
+    check(!first.FromCache, "server: first build is compiled");
+
+    check(client.Build(makeRequest(bitcode, ""), second), "server: repeated build answered");
+    check(second.Successful && second.FromCache, "server: repeated build comes from the cache");
+    check(second.Output == first.Output, "server: cached binary is the compiled one");
+
+    check(client.Build(makeRequest(bitcode, "-cl-opt-disable"), other), "server: other options answered");
+    check(other.Successful && !other.FromCache, "server: other options are compiled");
+
+    // A malformed request gets an error back and the connection stays usable.
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    std::string payload;
+    BuildResponse rejected;
+    check(fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0,
+        "server: raw connection");
+    check(SendMessage(fd, "garbage") && ReceiveMessage(fd, payload) && Decode(payload, rejected),
+        "server: malformed request answered");
+    check(!rejected.Successful && !rejected.BuildLog.empty(), "server: malformed request fails");
+    Client raw;
+    raw.Attach(fd);
+    BuildResponse afterError;
+    check(raw.Build(makeRequest(bitcode, ""), afterError) && afterError.Successful,
+        "server: connection usable after a malformed request");
+
+    client.Disconnect();
+    raw.Disconnect();
+    kill(server, SIGTERM);
+    waitpid(server, &status, 0);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "server: clean exit on SIGTERM");
+    struct stat st;
+    check(stat(socketPath.c_str(), &st) != 0, "server: socket removed on exit");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: " << argv[0] << " <path to igc-server> <path to libigc>\n";
+        return 1;
+    }
+
+    testProtocol();
+    testServer(argv[1], argv[2]);
+
+    if (g_numErrors)
+    {
+        std::cerr << g_numErrors << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "PASSED\n";
+    return 0;
+}
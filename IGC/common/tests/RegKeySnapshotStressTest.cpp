@@ -0,0 +1,101 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Stress test for concurrent builds in EnableConcurrentCompile mode. Every
+// thread plays one build: it opens a RegKeySnapshotScope, writes flags and
+// the shader output name, and checks that nothing leaks between builds.
+// Meant to be run under TSan; ConcurrentTranslateBuildTest does the same
+// with real builds.
+
+#include "common/igc_regkeys.hpp"
+#include "AdaptorCommon/customApi.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::atomic<unsigned> g_numErrors{ 0 };
+
+static void check(bool cond, const char* what, unsigned build)
+{
+    if (!cond)
+    {
+        if (g_numErrors++ < 16)
+        {
+            std::cerr << "build " << build << ": " << what << "\n";
+        }
+    }
+}
+
+static void runBuild(unsigned build, unsigned iterations)
+{
+    const unsigned defaultMask = IGC_GET_FLAG_DEFAULT_VALUE(OCLSIMD16SelectionMask);
+    const std::string name = "build" + std::to_string(build);
+
+    for (unsigned i = 0; i < iterations; ++i)
+    {
+        RegKeySnapshotScope flagSnapshot(IGC_IS_FLAG_ENABLED(EnableConcurrentCompile));
+        IGC::Debug::SetShaderOutputName(name.c_str());
+
+        check(IGC_GET_FLAG_VALUE(OCLSIMD16SelectionMask) == defaultMask,
+            "sees a flag written by another build", build);
+        IGC_SET_FLAG_VALUE(OCLSIMD16SelectionMask, build);
+        IGC_SET_FLAG_VALUE(CodePatchLimit, build + i);
+        check(IGC_GET_FLAG_VALUE(OCLSIMD16SelectionMask) == build,
+            "lost its own flag write", build);
+
+        {
+            // nested scopes start from the enclosing build's values
+            RegKeySnapshotScope nested;
+            check(IGC_GET_FLAG_VALUE(OCLSIMD16SelectionMask) == build,
+                "nested scope does not see the build's flags", build);
+            IGC_SET_FLAG_VALUE(OCLSIMD16SelectionMask, build + 1);
+        }
+        check(IGC_GET_FLAG_VALUE(OCLSIMD16SelectionMask) == build,
+            "nested scope leaked a flag write", build);
+
+        check(IGC_GET_FLAG_VALUE(CodePatchLimit) == build + i,
+            "lost its own write to a second flag", build);
+
+        check(name == IGC::Debug::GetShaderOutputName(),
+            "sees another build's shader output name", build);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const unsigned numBuilds = argc > 1 ? std::atoi(argv[1]) : 16;
+    const unsigned iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    IGC_SET_FLAG_VALUE(EnableConcurrentCompile, true);
+
+    std::vector<std::thread> builds;
+    for (unsigned b = 0; b < numBuilds; ++b)
+    {
+        // 0 is the default of CodePatchLimit; keep build ids away from it
+        builds.emplace_back(runBuild, b + 100, iterations);
+    }
+    for (auto& t : builds)
+    {
+        t.join();
+    }
+
+    check(IGC_GET_FLAG_VALUE(OCLSIMD16SelectionMask) ==
+        IGC_GET_FLAG_DEFAULT_VALUE(OCLSIMD16SelectionMask),
+        "flag write leaked into the process-wide list", 0);
+
+    if (g_numErrors)
+    {
+        std::cerr << g_numErrors << " errors\n";
+        return 1;
+    }
+    return 0;
+}
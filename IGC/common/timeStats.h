@@ -31,6 +31,11 @@ DEFINE_TIME_STAT(        TIME_CG_Add_Analysis_Passes,            "CodeGen Add An
 DEFINE_TIME_STAT(        TIME_CG_Add_CodeGen_Passes,             "CodeGen Add CodeGen Passes",             TIME_CG_Add_Passes,                 false,         false,          false,          true )
 DEFINE_TIME_STAT(      TIME_CG_Legalization,                     "CodeGen Legalization",                   TIME_CodeGen,                       false,         false,          true,           true )
 DEFINE_TIME_STAT(      TIME_CG_Analysis,                         "CodeGen Analysis",                       TIME_CodeGen,                       false,         false,          true,           true )
+DEFINE_TIME_STAT(      TIME_CG_PatternMatch,                     "CodeGen PatternMatch",                   TIME_CodeGen,                       false,         false,          true,           true )
+DEFINE_TIME_STAT(      TIME_CG_DeSSA,                            "CodeGen DeSSA",                          TIME_CodeGen,                       false,         false,          true,           true )
+DEFINE_TIME_STAT(      TIME_CG_BlockCoalescing,                  "CodeGen BlockCoalescing",                TIME_CodeGen,                       false,         false,          true,           true )
+DEFINE_TIME_STAT(      TIME_CG_CoalescingEngine,                 "CodeGen CoalescingEngine",               TIME_CodeGen,                       false,         false,          true,           true )
+DEFINE_TIME_STAT(      TIME_CG_VariableReuse,                    "CodeGen VariableReuseAnalysis",          TIME_CodeGen,                       false,         false,          true,           true )
 DEFINE_TIME_STAT(      TIME_CG_SaveIR,                           "CodeGen SaveIR",                         TIME_CodeGen,                       false,         false,          true,           true )
 DEFINE_TIME_STAT(      TIME_CG_RestoreIR,                        "CodeGen RestoreIR",                      TIME_CodeGen,                       false,         false,          true,           true )
 DEFINE_TIME_STAT(      TIME_CG_vISACompile,                      "vISACompile (by IGC)",                   TIME_CodeGen,                       false,         false,          false,          true )
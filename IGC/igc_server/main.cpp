@@ -0,0 +1,380 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// igc-server: compile server for tools that push many builds through IGC.
+//
+// The server loads the IGC library once and forks a pool of worker
+// processes that accept connections on a local socket. Each worker keeps
+// its device and translation contexts across builds and remembers the
+// binaries it produced, so repeated builds skip the library and context
+// setup, and identical builds are answered from the cache. Workers build
+// one request at a time; a worker that dies in a build is replaced.
+//
+// Clients use IGC::Server::Client from ocl_igc_interface/igc_server_client.h.
+
+#include "ocl_igc_interface/igc_server_protocol.h"
+
+#include "cif/common/cif_main.h"
+#include "cif/import/cif_main.h"
+#include "cif/builtins/memory/buffer/buffer.h"
+#include "ocl_igc_interface/igc_ocl_device_ctx.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Support/CommandLine.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+using namespace llvm;
+using namespace IGC::Server;
+
+static cl::opt<std::string>
+    SocketPath("socket", cl::desc("Path of the local socket to listen on"), cl::Required);
+static cl::opt<std::string>
+    LibraryPath("igc", cl::desc("Path of the IGC library"), cl::Required);
+static cl::opt<unsigned>
+    NumWorkers("workers", cl::desc("Number of worker processes"), cl::init(4));
+static cl::opt<unsigned>
+    CacheSizeMB("cache-mb", cl::desc("Size of each worker's kernel cache in MB"), cl::init(256));
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void onStopSignal(int)
+{
+    g_stop = 1;
+}
+
+// Binaries a worker built, keyed by the whole encoded request, so only an
+// identical build on an identical device hits. The least recently used
+// builds are dropped once the cache grows past its size.
+class KernelCache
+{
+public:
+    explicit KernelCache(size_t maxBytes) : m_maxBytes(maxBytes) {}
+
+    const BuildResponse* lookup(const std::string& key)
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            return nullptr;
+        }
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+        return &it->second.response;
+    }
+
+    void insert(const std::string& key, const BuildResponse& response)
+    {
+        const size_t bytes = entryBytes(key, response);
+        if (bytes > m_maxBytes || m_entries.count(key))
+        {
+            return;
+        }
+        while (m_bytes + bytes > m_maxBytes)
+        {
+            auto victim = m_entries.find(m_lru.back());
+            m_bytes -= entryBytes(victim->first, victim->second.response);
+            m_entries.erase(victim);
+            m_lru.pop_back();
+        }
+        m_lru.push_front(key);
+        m_entries.emplace(key, Entry{ response, m_lru.begin() });
+        m_bytes += bytes;
+    }
+
+private:
+    struct Entry
+    {
+        BuildResponse response;
+        std::list<std::string>::iterator lruPos;
+    };
+
+    static size_t entryBytes(const std::string& key, const BuildResponse& response)
+    {
+        // the key is stored twice, in the map and in the LRU list
+        return 2 * key.size() + response.Output.size() + response.BuildLog.size();
+    }
+
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_lru;
+    size_t m_maxBytes;
+    size_t m_bytes = 0;
+};
+
+class Worker
+{
+public:
+    Worker(CIF::CIFMain* main, size_t cacheBytes) : m_main(main), m_cache(cacheBytes) {}
+
+    // Serves connections until the process is told to stop.
+    void serve(int listenFd)
+    {
+        while (!g_stop)
+        {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                {
+                    continue;
+                }
+                perror("igc-server: accept");
+                return;
+            }
+            std::string payload;
+            while (!g_stop && ReceiveMessage(fd, payload))
+            {
+                BuildResponse response = handle(payload);
+                if (!SendMessage(fd, Encode(response)))
+                {
+                    break;
+                }
+            }
+            close(fd);
+        }
+    }
+
+private:
+    struct Device
+    {
+        CIF::RAII::UPtr_t<IGC::IgcOclDeviceCtxTagOCL> ctx;
+        std::map<std::pair<IGC::CodeType::CodeType_t, IGC::CodeType::CodeType_t>,
+            CIF::RAII::UPtr_t<IGC::IgcOclTranslationCtxTagOCL>> translators;
+    };
+
+    BuildResponse handle(const std::string& payload)
+    {
+        BuildResponse response;
+        BuildRequest request;
+        if (!Decode(payload, request))
+        {
+            response.BuildLog = "igc-server: malformed build request";
+            return response;
+        }
+        if (const BuildResponse* cached = m_cache.lookup(payload))
+        {
+            response = *cached;
+            response.FromCache = true;
+            return response;
+        }
+        response = build(request);
+        m_cache.insert(payload, response);
+        return response;
+    }
+
+    IGC::IgcOclTranslationCtxTagOCL* getTranslator(const BuildRequest& request)
+    {
+        const std::string deviceKey(reinterpret_cast<const char*>(&request.Device), sizeof(request.Device));
+        Device& device = m_devices[deviceKey];
+        if (!device.ctx)
+        {
+            device.ctx = m_main->CreateInterface<IGC::IgcOclDeviceCtxTagOCL>();
+            if (!device.ctx)
+            {
+                return nullptr;
+            }
+            setupDevice(*device.ctx, request.Device);
+        }
+        auto& translator = device.translators[{ request.InType, request.OutType }];
+        if (!translator)
+        {
+            translator = device.ctx->CreateTranslationCtx(request.InType, request.OutType);
+        }
+        return translator.get();
+    }
+
+    static void setupDevice(IGC::IgcOclDeviceCtxTagOCL& ctx, const DeviceDesc& desc)
+    {
+        auto platform = ctx.GetPlatformHandle();
+        platform->SetProductFamily(desc.ProductFamily);
+        platform->SetRenderCoreFamily(desc.RenderCoreFamily);
+        platform->SetDisplayCoreFamily(desc.DisplayCoreFamily);
+        platform->SetDeviceID(desc.DeviceID);
+        platform->SetRevId(desc.RevId);
+
+        auto sysInfo = ctx.GetGTSystemInfoHandle();
+        sysInfo->SetEUCount(desc.EUCount);
+        sysInfo->SetThreadCount(desc.ThreadCount);
+        sysInfo->SetSliceCount(desc.SliceCount);
+        sysInfo->SetSubSliceCount(desc.SubSliceCount);
+        sysInfo->SetMaxEuPerSubSlice(desc.MaxEuPerSubSlice);
+        sysInfo->SetMaxSlicesSupported(desc.MaxSlicesSupported);
+        sysInfo->SetMaxSubSlicesSupported(desc.MaxSubSlicesSupported);
+        sysInfo->SetMaxDualSubSlicesSupported(desc.MaxDualSubSlicesSupported);
+        sysInfo->SetDualSubSliceCount(desc.DualSubSliceCount);
+    }
+
+    BuildResponse build(const BuildRequest& request)
+    {
+        BuildResponse response;
+        auto* translator = getTranslator(request);
+        if (!translator)
+        {
+            response.BuildLog = "igc-server: unsupported device or code types";
+            return response;
+        }
+
+        // Options are passed null-terminated, as the runtime does.
+        auto src = CIF::Builtins::CreateConstBuffer<CIF::Builtins::BufferSimple>(
+            m_main, request.Src.data(), request.Src.size());
+        auto opts = CIF::Builtins::CreateConstBuffer<CIF::Builtins::BufferSimple>(
+            m_main, request.Options.c_str(), request.Options.size() + 1);
+        auto internalOpts = CIF::Builtins::CreateConstBuffer<CIF::Builtins::BufferSimple>(
+            m_main, request.InternalOptions.c_str(), request.InternalOptions.size() + 1);
+        auto output = translator->Translate(src.get(), opts.get(), internalOpts.get(), nullptr, 0);
+        if (!output)
+        {
+            response.BuildLog = "igc-server: translation failed";
+            return response;
+        }
+
+        response.Successful = output->Successful();
+        if (auto* binary = output->GetOutput())
+        {
+            response.Output.assign(binary->GetMemory<char>(), binary->GetSizeRaw());
+        }
+        if (auto* log = output->GetBuildLog())
+        {
+            response.BuildLog.assign(log->GetMemory<char>(), log->GetSizeRaw());
+        }
+        return response;
+    }
+
+    CIF::CIFMain* m_main;
+    std::map<std::string, Device> m_devices;
+    KernelCache m_cache;
+};
+
+static int listenOn(const std::string& path)
+{
+    sockaddr_un addr = {};
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, "igc-server: socket path too long: %s\n", path.c_str());
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        perror("igc-server: socket");
+        return -1;
+    }
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, SOMAXCONN) != 0)
+    {
+        perror("igc-server: bind");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static pid_t spawnWorker(CIF::CIFMain* main, int listenFd)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        signal(SIGINT, SIG_IGN);
+        signal(SIGTERM, SIG_DFL);
+        Worker worker(main, size_t(CacheSizeMB) << 20);
+        worker.serve(listenFd);
+        _exit(0);
+    }
+    if (pid < 0)
+    {
+        perror("igc-server: fork");
+    }
+    return pid;
+}
+
+int main(int argc, char** argv)
+{
+    cl::ParseCommandLineOptions(argc, argv, "IGC compile server\n");
+
+    // Loaded once here, so the workers start with the library, its builtins
+    // and its regkeys already in memory.
+    auto package = CIF::OpenLibraryInterface(CIF::OpenLibrary(LibraryPath, false));
+    if (!package || !package->IsValid())
+    {
+        fprintf(stderr, "igc-server: cannot load %s\n", LibraryPath.c_str());
+        return 1;
+    }
+
+    int listenFd = listenOn(SocketPath);
+    if (listenFd < 0)
+    {
+        return 1;
+    }
+
+    struct sigaction stop = {};
+    stop.sa_handler = onStopSignal;
+    sigaction(SIGINT, &stop, nullptr);
+    sigaction(SIGTERM, &stop, nullptr);
+
+    std::vector<pid_t> workers;
+    for (unsigned i = 0; i < std::max(1u, unsigned(NumWorkers)); ++i)
+    {
+        pid_t pid = spawnWorker(package->GetCIFMain(), listenFd);
+        if (pid > 0)
+        {
+            workers.push_back(pid);
+        }
+    }
+
+    int result = workers.empty() ? 1 : 0;
+    while (!g_stop && !workers.empty())
+    {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            continue;
+        }
+        auto it = std::find(workers.begin(), workers.end(), pid);
+        if (it == workers.end())
+        {
+            continue;
+        }
+        workers.erase(it);
+        if (!g_stop)
+        {
+            fprintf(stderr, "igc-server: worker %d exited, restarting it\n", int(pid));
+            pid_t replacement = spawnWorker(package->GetCIFMain(), listenFd);
+            if (replacement > 0)
+            {
+                workers.push_back(replacement);
+            }
+        }
+    }
+
+    for (pid_t pid : workers)
+    {
+        kill(pid, SIGTERM);
+    }
+    for (pid_t pid : workers)
+    {
+        waitpid(pid, nullptr, 0);
+    }
+    close(listenFd);
+    unlink(SocketPath.c_str());
+    return result;
+}
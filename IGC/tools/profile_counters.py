@@ -0,0 +1,112 @@
+# ========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+# =========================== end_copyright_notice =============================
+
+# Maps the block counters of a kernel built with -cl-intel-profile-instrument
+# back to source lines, and converts them to a profile feedback file for
+# -cl-intel-profile-feedback-file.
+#
+# Every build writes its own map file, <name>_asm<shader hash>.<ext> for
+# -cl-intel-profile-instrument <name>.<ext>; pass all of them. The host dumps
+# each "__igc_profile_counters_<kernel>" global after the run, as raw
+# little-endian 64-bit integers, to <counters dir>/<symbol>.bin.
+#
+# usage: profile_counters.py <counters dir> <map file>... [-o <profile file>]
+
+import argparse
+import os
+import struct
+import sys
+
+
+class Kernel:
+    def __init__(self, name, symbol, hash, numBlocks):
+        self.name = name
+        self.symbol = symbol
+        self.hash = hash
+        self.numBlocks = numBlocks
+        self.lines = {}
+        self.loops = {}
+        self.counts = []
+
+
+def readMap(path):
+    kernels = []
+    with open(path) as f:
+        for lineNo, line in enumerate(f, 1):
+            tokens = line.split(None, 3)
+            if not tokens:
+                continue
+            if tokens[0] == "version":
+                if tokens[1].strip() != "2":
+                    sys.exit("%s:%d: unsupported version" % (path, lineNo))
+            elif tokens[0] == "kernel":
+                name, symbol, hash, numBlocks = line.split()[1:]
+                kernels.append(Kernel(name, symbol, hash, int(numBlocks)))
+            elif tokens[0] == "block":
+                kernels[-1].lines[int(tokens[1])] = (tokens[3].strip(), int(tokens[2]))
+            elif tokens[0] == "loop":
+                kernels[-1].loops[int(tokens[1])] = int(tokens[2])
+            else:
+                sys.exit("%s:%d: unknown record" % (path, lineNo))
+    return kernels
+
+
+def readCounters(kernel, countersDir):
+    path = os.path.join(countersDir, kernel.symbol + ".bin")
+    if not os.path.exists(path):
+        return False
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) != 8 * kernel.numBlocks:
+        sys.exit("%s: expected %d counters" % (path, kernel.numBlocks))
+    kernel.counts = list(struct.unpack("<%dQ" % kernel.numBlocks, data))
+    return True
+
+
+def printReport(kernel):
+    print("kernel %s: %d work items" % (kernel.name, kernel.counts[0]))
+    perLine = {}
+    for block, count in enumerate(kernel.counts):
+        loc = kernel.lines.get(block, ("-", 0))
+        perLine[loc] = max(perLine.get(loc, 0), count)
+    for (file, line), count in sorted(perLine.items(), key=lambda i: -i[1]):
+        if file != "-":
+            print("  %12d  %s:%d" % (count, file, line))
+    for block, depth in sorted(kernel.loops.items()):
+        file, line = kernel.lines.get(block, ("-", 0))
+        print("  loop at %s:%d (depth %d): %d iterations" %
+              (file, line, depth, kernel.counts[block]))
+
+
+def writeProfile(kernels, path):
+    with open(path, "w") as f:
+        f.write("version 2\n")
+        for kernel in kernels:
+            f.write("kernel %s %s %d %d\n" %
+                    (kernel.name, kernel.hash, kernel.counts[0], kernel.numBlocks))
+            for block, count in enumerate(kernel.counts):
+                f.write("block %d %d\n" % (block, count))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Report IGC block counters")
+    parser.add_argument("counters", help="directory with the dumped counter buffers")
+    parser.add_argument("maps", nargs="+", help="map files written by the compiler")
+    parser.add_argument("-o", dest="profile", help="write a profile feedback file")
+    args = parser.parse_args()
+
+    kernels = [k for path in args.maps for k in readMap(path)
+               if readCounters(k, args.counters)]
+    for kernel in kernels:
+        printReport(kernel)
+    if args.profile:
+        writeProfile(kernels, args.profile)
+
+
+if __name__ == "__main__":
+    main()
@@ -528,6 +528,10 @@ public:
 
     void localDataFlowAnalysis();
     void resetLocalDataFlowData();
+    // Recompute def-use and compare against the chains currently on the
+    // instructions. Mismatches are printed to os; returns false if any
+    // def-use edge is missing or points to a removed instruction.
+    bool verifyLocalDataFlow(std::ostream& os);
 
     unsigned getNumBB() const {return numBBId;}
     G4_BB* getEntryBB()       {return BBs.front();}
@@ -23,6 +23,7 @@ SPDX-License-Identifier: MIT
 #include <algorithm>
 #include <cmath>  // sqrt
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <list>
 #include <sstream>
@@ -7346,6 +7347,15 @@ bool GraphColor::regAlloc(
     {
         bool hasStackCall = kernel.fg.getHasStackCalls() || kernel.fg.getIsStackCallFunc();
 
+        // Speculative coloring starts every variant from the state before
+        // the default heuristics below wrote hints and forbidden registers.
+        bool speculate = kernel.getOption(vISA_SpeculativeColoring) && !hasStackCall;
+        ColoringSnapshot initial;
+        if (speculate)
+        {
+            saveColoring(initial);
+        }
+
         bool willSpill = ((builder.getOption(vISA_FastCompileRA) || builder.getOption(vISA_HybridRAWithSpill)) && !hasStackCall) ||
             (kernel.getInt32KernelAttr(Attributes::ATTR_Target) == VISA_3D &&
             rpe->getMaxRP() >= kernel.getNumRegTotal() + 24);
@@ -7393,6 +7403,11 @@ bool GraphColor::regAlloc(
                 assignColors(FIRST_FIT, false, false);
             }
         }
+
+        if (speculate && requireSpillCode())
+        {
+            speculativeColoring(initial, highInternalConflict);
+        }
     }
     else if (liveAnalysis.livenessClass(G4_FLAG))
     {
@@ -7418,6 +7433,142 @@ bool GraphColor::regAlloc(
     return (requireSpillCode() == false);
 }
 
+void GraphColor::saveColoring(ColoringSnapshot& snapshot) const
+{
+    snapshot.regs.resize(numVar);
+    snapshot.hints.resize(numVar);
+    snapshot.spilled.resize(numVar);
+    snapshot.forbidden.resize(numVar);
+    for (unsigned i = 0; i < numVar; i++)
+    {
+        snapshot.regs[i] = std::make_pair(lrs[i]->getPhyReg(), lrs[i]->getPhyRegOff());
+        snapshot.hints[i] = lrs[i]->getAllocHint();
+        snapshot.spilled[i] = lrs[i]->isSpilled();
+        snapshot.forbidden[i] = lrs[i]->saveForbidden();
+    }
+    snapshot.spilledLRs = spilledLRs;
+    snapshot.raType = kernel.getRAType();
+}
+
+void GraphColor::restoreColoring(const ColoringSnapshot& snapshot)
+{
+    MUST_BE_TRUE(snapshot.regs.size() == numVar, "coloring snapshot doesnt match live ranges");
+    for (unsigned i = 0; i < numVar; i++)
+    {
+        // pre-assigned ranges are never touched by coloring
+        if (lrs[i]->getVar()->getPhyReg())
+            continue;
+
+        if (snapshot.regs[i].first)
+            lrs[i]->setPhyReg(snapshot.regs[i].first, snapshot.regs[i].second);
+        else
+            lrs[i]->resetPhyReg();
+
+        lrs[i]->resetAllocHint();
+        if (snapshot.hints[i] != lrs[i]->getAllocHint())
+            lrs[i]->setAllocHint(snapshot.hints[i]);
+
+        lrs[i]->setSpilled(snapshot.spilled[i]);
+        lrs[i]->restoreForbidden(snapshot.forbidden[i]);
+    }
+    spilledLRs = snapshot.spilledLRs;
+    kernel.setRAType(snapshot.raType);
+}
+
+double GraphColor::getSpilledCost() const
+{
+    double cost = 0;
+    for (auto lr : spilledLRs)
+    {
+        cost += lr->getSpillCost();
+    }
+    return cost;
+}
+
+//
+// The default heuristic sequence in regAlloc() spilled. Since the interference
+// graph for this iteration is already built and is not modified by coloring,
+// try alternative coloring heuristics against it and keep the assignment that
+// is spill free, or failing that the one with the lowest total spill cost.
+// Every variant starts from initial, the state before the default sequence.
+// This trades some coloring time for fewer spill iterations.
+//
+void GraphColor::speculativeColoring(const ColoringSnapshot& initial, bool highInternalConflict)
+{
+    ColoringSnapshot best;
+    saveColoring(best);
+    double bestCost = getSpilledCost();
+    const char* bestName = "default";
+
+    auto tryVariant = [&](const char* name, const std::function<void()>& color)
+    {
+        restoreColoring(initial);
+        color();
+        double cost = getSpilledCost();
+        if (builder.getOption(vISA_RATrace))
+        {
+            std::cout << "\t--speculative coloring (" << name << "): " << spilledLRs.size() <<
+                " spilled, spill cost " << cost << "\n";
+        }
+        if (cost < bestCost)
+        {
+            saveColoring(best);
+            bestCost = cost;
+            bestName = name;
+        }
+        return spilledLRs.empty();
+    };
+
+    // Colors with colorOrder stably sorted by less, restoring the
+    // simplification order afterwards. colorOrder is traversed back to
+    // front, so the ranges that compare greatest get colored first.
+    auto tryOrder = [&](const char* name, bool (*less)(const LiveRange*, const LiveRange*))
+    {
+        std::vector<LiveRange*> simplifyOrder = colorOrder;
+        std::stable_sort(colorOrder.begin(), colorOrder.end(), less);
+        bool spillFree = tryVariant(name, [&]()
+        {
+            assignColors(FIRST_FIT, false, highInternalConflict);
+        });
+        colorOrder = std::move(simplifyOrder);
+        return spillFree;
+    };
+
+    // 1. first-fit ignoring split hints
+    bool spillFree = tryVariant("first-fit, no hints", [&]()
+    {
+        assignColors(FIRST_FIT, false, false, false);
+    });
+
+    // 2. first-fit, ranges colored strictly by decreasing spill cost
+    if (!spillFree)
+    {
+        spillFree = tryOrder("first-fit, cost ordered",
+            [](const LiveRange* lr1, const LiveRange* lr2)
+            {
+                return lr1->getSpillCost() < lr2->getSpillCost();
+            });
+    }
+
+    // 3. first-fit, largest ranges first, so that they are not left without
+    //    a contiguous block once the small ones fragmented the file
+    if (!spillFree)
+    {
+        tryOrder("first-fit, largest first",
+            [](const LiveRange* lr1, const LiveRange* lr2)
+            {
+                return lr1->getNumRegNeeded() < lr2->getNumRegNeeded();
+            });
+    }
+
+    restoreColoring(best);
+
+    if (builder.getOption(vISA_RATrace))
+    {
+        std::cout << "\t--speculative coloring picked " << bestName << ", spill cost " << bestCost << "\n";
+    }
+}
+
 void GraphColor::confirmRegisterAssignments()
 {
     for (unsigned i = 0; i < numVar; i++)
@@ -10245,10 +10396,14 @@ int GlobalRA::coloringRegAlloc()
         spillAnalysis = std::make_unique<SpillAnalysis>();
     }
 
+    // spill space already used by linear scan RA if it fell back to
+    // graph coloring
+    uint32_t linearScanSpillSize = 0;
+
     if (!isReRAPass())
     {
         //Global linear scan RA
-        if (builder.getOption(vISA_LinearScan))
+        if (builder.getOption(vISA_LinearScan) || builder.getOption(vISA_FastCompileTier0))
         {
             copyMissingAlignment();
             BankConflictPass bc(*this, false);
@@ -10260,9 +10415,7 @@ int GlobalRA::coloringRegAlloc()
             int success = lra.doLinearScanRA();
             if (success == VISA_SUCCESS)
             {
-                // TODO: Get correct spillSize from LinearScanRA
-                unsigned spillSize = 0;
-                expandSpillFillIntrinsics(spillSize);
+                expandSpillFillIntrinsics(lra.getSpillSize());
                 assignRegForAliasDcl();
                 computePhyReg();
                 if (builder.getOption(vISA_verifyLinearScan))
@@ -10290,6 +10443,8 @@ int GlobalRA::coloringRegAlloc()
             {
                 return VISA_SPILL;
             }
+
+            linearScanSpillSize = lra.getSpillSize();
         }
         else if (builder.getOption(vISA_LocalRA) && !hasStackCall)
         {
@@ -10360,6 +10515,9 @@ int GlobalRA::coloringRegAlloc()
         scratchOffset += 32;
     }
 
+    // linear scan RA's spill offsets already include the frame descriptor
+    nextSpillOffset = std::max(nextSpillOffset, linearScanSpillSize);
+
     uint32_t GRFSpillFillCount = 0;
     uint32_t sendAssociatedGRFSpillFillCount = 0;
     unsigned fastCompileIter = 1;
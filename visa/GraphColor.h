@@ -231,6 +231,11 @@ public:
         bool isSpilled() const { return spilled; }
         void setSpilled(bool v) { spilled = v; }
 
+        // Copy of the forbidden registers, so that markForbidden calls made
+        // by a coloring attempt can be undone.
+        std::vector<bool> saveForbidden() const;
+        void restoreForbidden(const std::vector<bool>& saved);
+
 private:
     //const Options *m_options;
     unsigned getForbiddenVectorSize() const;
@@ -568,6 +573,24 @@ namespace vISA
         void relaxNeighborDegreeARF(LiveRange* lr);
         bool assignColors(ColorHeuristic heuristicGRF, bool doBankConflict, bool highInternalConflict, bool honorHints = true);
 
+        // Live range state written by one coloring attempt: temporary
+        // assignments, alloc hints and forbidden registers. Used by
+        // speculative coloring to run alternatives from the same starting
+        // point on the same interference graph.
+        struct ColoringSnapshot
+        {
+            std::vector<std::pair<G4_VarBase*, unsigned>> regs;
+            std::vector<unsigned> hints;
+            std::vector<bool> spilled;
+            std::vector<std::vector<bool>> forbidden;
+            LIVERANGE_LIST spilledLRs;
+            RA_Type raType = RA_Type::UNKNOWN_RA;
+        };
+        void saveColoring(ColoringSnapshot& snapshot) const;
+        void restoreColoring(const ColoringSnapshot& snapshot);
+        double getSpilledCost() const;
+        void speculativeColoring(const ColoringSnapshot& initial, bool highInternalConflict);
+
         void clearSpillAddrLocSignature()
         {
             memset(spAddrRegSig, 0, getNumAddrRegisters() * sizeof(unsigned));
@@ -918,6 +918,7 @@ int LinearScanRA::linearScanRA()
     int globalScratchOffset = kernel.getInt32KernelAttr(Attributes::ATTR_SpillMemOffset);
     bool useScratchMsgForSpill = !hasStackCall && (globalScratchOffset < (int)(SCRATCH_MSG_LIMIT * 0.6));
     bool enableSpillSpaceCompression = builder.getOption(vISA_SpillSpaceCompression);
+    int maxIterations = (int)builder.getOptions()->getuInt32Option(vISA_LinearScanMaxIter);
     do {
         spillLRs.clear();
         funcCnt = 0;
@@ -1094,10 +1095,26 @@ int LinearScanRA::linearScanRA()
         }
 
         iterator++;
-    } while (spillLRs.size() && iterator < MAXIMAL_ITERATIONS);
+    } while (spillLRs.size() && iterator < maxIterations);
 
     if (spillLRs.size())
     {
+        if (builder.getOption(vISA_FastCompileTier0))
+        {
+            // Out of spill iterations in tier0. Assignments of the last
+            // iteration have already been undone, so hand the kernel,
+            // including the spill code inserted so far, over to graph
+            // coloring. The caller must start its spill offsets at
+            // getSpillSize(). Graph coloring reports the error if the kernel
+            // cannot be allocated at all.
+            if (builder.getOption(vISA_RATrace))
+            {
+                std::cout << "\t--linear scan RA gave up after " << iterator << " iterations\n";
+            }
+            spillLRs.clear();
+            return VISA_FAILURE;
+        }
+
         std::stringstream spilledVars;
         for (auto dcl : kernel.Declares)
         {
@@ -31,7 +31,6 @@ class BankConflictPass;
 class GlobalRA;
 }
 
-#define MAXIMAL_ITERATIONS 10
 #define SCRATCH_MSG_LIMIT (128 * 1024)
 vISA::G4_Declare* GetTopDclFromRegRegion(vISA::G4_Operand* opnd);
 
@@ -11,6 +11,8 @@ SPDX-License-Identifier: MIT
 #include "BuildIR.h"
 #include "LocalDataflow.h"
 #include <algorithm>
+#include <set>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -549,6 +551,88 @@ void FlowGraph::resetLocalDataFlowData()
     }
 }
 
+// Check the def-use chains maintained by passes against a fresh
+// computation. Both the use and the def side of every edge are compared,
+// since passes update them separately. The recomputed chains are kept.
+bool FlowGraph::verifyLocalDataFlow(std::ostream& os)
+{
+    using Edge = std::tuple<G4_INST*, G4_INST*, Gen4_Operand_Number>;
+    std::set<Edge> useEdges, defEdges, freshEdges;
+    std::set<G4_INST*> liveInsts;
+
+    for (auto bb : BBs)
+    {
+        for (auto inst : *bb)
+        {
+            liveInsts.insert(inst);
+            for (auto I = inst->use_begin(), E = inst->use_end(); I != E; ++I)
+            {
+                useEdges.insert(Edge(inst, I->first, I->second));
+            }
+            for (auto I = inst->def_begin(), E = inst->def_end(); I != E; ++I)
+            {
+                defEdges.insert(Edge(I->first, inst, I->second));
+            }
+        }
+    }
+
+    resetLocalDataFlowData();
+    localDataFlowAnalysis();
+
+    for (auto bb : BBs)
+    {
+        for (auto inst : *bb)
+        {
+            for (auto I = inst->use_begin(), E = inst->use_end(); I != E; ++I)
+            {
+                freshEdges.insert(Edge(inst, I->first, I->second));
+            }
+        }
+    }
+
+    bool isValid = true;
+    auto printEdge = [&os](const char* msg, const Edge& edge)
+    {
+        os << msg << " (opnd " << std::get<2>(edge) << ")\n  def: ";
+        std::get<0>(edge)->emit(os);
+        os << "\n  use: ";
+        std::get<1>(edge)->emit(os);
+        os << "\n";
+    };
+    auto checkMaintained = [&](const std::set<Edge>& edges, const char* side)
+    {
+        for (auto& edge : edges)
+        {
+            if (!liveInsts.count(std::get<0>(edge)) ||
+                !liveInsts.count(std::get<1>(edge)))
+            {
+                os << side << ": ";
+                printEdge("edge to removed instruction", edge);
+                isValid = false;
+            }
+            else if (!freshEdges.count(edge))
+            {
+                os << side << ": ";
+                printEdge("stale edge", edge);
+                isValid = false;
+            }
+        }
+        for (auto& edge : freshEdges)
+        {
+            if (!edges.count(edge))
+            {
+                os << side << ": ";
+                printEdge("missing edge", edge);
+                isValid = false;
+            }
+        }
+    };
+    checkMaintained(useEdges, "use list");
+    checkMaintained(defEdges, "def list");
+
+    return isValid;
+}
+
 void DefEscapeBBAnalysis::analyzeBB(G4_BB* bb)
 {
     // active defines in this BB, organized by root declare
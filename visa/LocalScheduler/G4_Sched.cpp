@@ -299,8 +299,7 @@ private:
 // Track and recompute register pressure for a block.
 struct RegisterPressure
 {
-    PointsToAnalysis* p2a = nullptr;
-    GlobalRA* gra = nullptr;
+    StandaloneRPE* owned = nullptr;
     LivenessAnalysis* liveness = nullptr;
     RPE* rpe = nullptr;
     G4_Kernel& kernel;
@@ -322,13 +321,7 @@ struct RegisterPressure
 
     ~RegisterPressure()
     {
-        // Delete only if owns the following objects.
-        if (p2a) {
-            delete p2a;
-            delete gra;
-            delete liveness;
-            delete rpe;
-        }
+        delete owned;
     }
 
     RegisterPressure(const RegisterPressure& other) = delete;
@@ -336,14 +329,9 @@ struct RegisterPressure
 
     void init()
     {
-        p2a = new PointsToAnalysis(kernel.Declares, kernel.fg.getNumBB());
-        p2a->doPointsToAnalysis(kernel.fg);
-        gra = new GlobalRA(kernel, kernel.fg.builder->phyregpool, *p2a);
-        // To properly track liveness for partially-written local variables.
-        gra->markGraphBlockLocalVars();
-        liveness = new LivenessAnalysis(*gra, G4_GRF | G4_ADDRESS | G4_INPUT | G4_FLAG | G4_SCALAR);
-        liveness->computeLiveness();
-        rpe = new RPE(*gra, liveness);
+        owned = new StandaloneRPE(kernel, G4_GRF | G4_ADDRESS | G4_INPUT | G4_FLAG | G4_SCALAR);
+        liveness = owned->getLiveness();
+        rpe = owned->getRPE();
         rpe->run();
     }
 
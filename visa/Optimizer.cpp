@@ -52,6 +52,10 @@ void Optimizer::LVN()
         lvn.doLVN();
 
         numInstsRemoved += lvn.getNumInstsRemoved();
+        if (!lvn.isDefUseUpToDate())
+        {
+            ValidAnalyses &= ~AI_LocalDataflow;
+        }
 
         numInstsRemoved += ::LVN::removeRedundantSamplerMovs(kernel, bb);
     }
@@ -1334,18 +1338,63 @@ void Optimizer::runPass(PassIndex Index)
     if (PI.Option != vISA_EnableAlways && !builder.getOption(PI.Option))
         return;
 
+    if (PI.SkipInTier0 && builder.getOption(vISA_FastCompileTier0))
+        return;
+
     std::string Name = PI.Name;
 
-    if (PI.Timer != TimerID::NUM_TIMERS)
-        startTimer(PI.Timer);
+    auto countInsts = [this]()
+    {
+        size_t numInsts = 0;
+        for (auto bb : kernel.fg)
+        {
+            numInsts += bb->size();
+        }
+        return numInsts;
+    };
+
+    // When verifying, give passes that keep def-use up to date valid chains
+    // to start from, so their updates get checked even where the pipeline
+    // would reach them with stale chains.
+    bool verifyDefUse = (PI.Preserves & AI_LocalDataflow) &&
+        builder.getOption(vISA_VerifyDefUse);
+    if (verifyDefUse)
+    {
+        computeLocalDataflow();
+    }
 
     kernel.dumpToFile("before." + Name);
 
+    bool passStats = builder.getOption(vISA_PerPassStats);
+    size_t numInstsBefore = passStats ? countInsts() : 0;
+    int64_t startTicks = passStats ? getTimestamp() : 0;
+    if (PI.Timer != TimerID::NUM_TIMERS)
+        startTimer(PI.Timer);
+
     // Execute pass.
     (this->*(PI.Pass))();
 
     if (PI.Timer != TimerID::NUM_TIMERS)
         stopTimer(PI.Timer);
+    if (passStats)
+    {
+        recordPassStat(PI.Name, getTimestamp() - startTicks,
+            (int64_t)countInsts() - (int64_t)numInstsBefore);
+    }
+
+    ValidAnalyses &= PI.Preserves;
+
+    // Check the chains left by the pass against a fresh computation.
+    if (verifyDefUse && (ValidAnalyses & AI_LocalDataflow))
+    {
+        std::stringstream errors;
+        if (!kernel.fg.verifyLocalDataFlow(errors))
+        {
+            std::cerr << "def-use is out of sync after " << Name << ":\n"
+                << errors.str();
+            DefUseOutOfSync = true;
+        }
+    }
 
     kernel.dumpToFile("after." + Name);
 
@@ -1402,6 +1451,8 @@ void Optimizer::initOptimizations()
     INITIALIZE_PASS(mergeScalarInst,         vISA_MergeScalar,             TimerID::OPTIMIZER);
     INITIALIZE_PASS(lowerMadSequence,        vISA_EnableMACOpt,            TimerID::OPTIMIZER);
     INITIALIZE_PASS(LVN,                     vISA_LVN,                     TimerID::OPTIMIZER);
+    INITIALIZE_PASS(GVN,                     vISA_GVN,                     TimerID::OPTIMIZER);
+    INITIALIZE_PASS(hoistMessagePayload,     vISA_HoistMessagePayload,     TimerID::OPTIMIZER);
     INITIALIZE_PASS(ifCvt,                   vISA_ifCvt,                   TimerID::OPTIMIZER);
     INITIALIZE_PASS(dumpPayload,             vISA_dumpPayload,             TimerID::MISC_OPTS);
     INITIALIZE_PASS(normalizeRegion,         vISA_EnableAlways,            TimerID::MISC_OPTS);
@@ -1431,6 +1482,40 @@ void Optimizer::initOptimizations()
     INITIALIZE_PASS(addSWSBInfo,             vISA_addSWSBInfo,             TimerID::MISC_OPTS);
     INITIALIZE_PASS(expandMadwPostSchedule,  vISA_expandMadwPostSchedule,  TimerID::MISC_OPTS);
 
+    // Passes that don't modify the IR, or that keep the listed analyses up
+    // to date themselves.
+    for (PassIndex Index : {
+        PI_countBankConflicts, PI_reassignBlockIDs, PI_countGRFUsage,
+        PI_collectStats, PI_analyzeMove })
+    {
+        Passes[Index].Preserves = AI_All;
+    }
+    // Passes that update the def-use chains of the instructions they change.
+    for (PassIndex Index : {
+        PI_localCopyPropagation, PI_localInstCombine, PI_mergeScalarInst,
+        PI_LVN, PI_accSubBeforeRA, PI_accSubPostSchedule })
+    {
+        Passes[Index].Preserves = AI_LocalDataflow;
+    }
+
+    // Tier-0 fast compile keeps only the passes needed to produce correct
+    // code. The kernel is expected to be recompiled with the full pipeline
+    // later, so none of the pure optimizations below are worth their time.
+    for (PassIndex Index : {
+        PI_cleanMessageHeader, PI_sendFusion, PI_renameRegister,
+        PI_localDefHoisting, PI_localCopyPropagation, PI_localInstCombine,
+        PI_removePartialMovs, PI_cselPeepHoleOpt, PI_preRA_Schedule,
+        PI_countBankConflicts, PI_FoldAddrImmediate, PI_localSchedule,
+        PI_mergeScalarInst, PI_lowerMadSequence, PI_LVN, PI_GVN, PI_ifCvt,
+        PI_cleanupBindless, PI_changeMoveType, PI_reRAPostSchedule,
+        PI_accSubBeforeRA, PI_accSubPostSchedule, PI_dce, PI_reassociateConst,
+        PI_hoistMessagePayload })
+    {
+        Passes[Index].SkipInTier0 = true;
+    }
+
+    static_assert(PI_NUM_PASSES <= MAX_PASS_STATS, "passStats can't hold every pass");
+
     // Verify all passes are initialized.
 #ifdef _DEBUG
     for (unsigned i = 0; i < PI_NUM_PASSES; ++i)
@@ -1440,6 +1525,17 @@ void Optimizer::initOptimizations()
 #endif
 }
 
+void Optimizer::computeLocalDataflow()
+{
+    if (ValidAnalyses & AI_LocalDataflow)
+    {
+        return;
+    }
+    kernel.fg.resetLocalDataFlowData();
+    kernel.fg.localDataFlowAnalysis();
+    ValidAnalyses |= AI_LocalDataflow;
+}
+
 void replaceAllSpilledRegions(G4_Kernel& kernel, G4_Declare* oldDcl, G4_Declare* newDcl)
 {
     // Iterate fg and replace all references to oldDcl with newDcl.
@@ -1813,8 +1909,7 @@ void Optimizer::accSubPostSchedule()
         return;
     }
 
-    kernel.fg.resetLocalDataFlowData();
-    kernel.fg.localDataFlowAnalysis();
+    computeLocalDataflow();
 
     if (builder.getOption(vISA_localizationForAccSub))
     {
@@ -1824,8 +1919,8 @@ void Optimizer::accSubPostSchedule()
             hwConf.localizeForAcc(bb);
         }
 
-        kernel.fg.resetLocalDataFlowData();
-        kernel.fg.localDataFlowAnalysis();
+        ValidAnalyses &= ~AI_LocalDataflow;
+        computeLocalDataflow();
     }
 
     AccSubPass accSub(builder, kernel);
@@ -1840,8 +1935,7 @@ void Optimizer::accSubBeforeRA()
         return;
     }
 
-    kernel.fg.resetLocalDataFlowData();
-    kernel.fg.localDataFlowAnalysis();
+    computeLocalDataflow();
 
     if (builder.getOption(vISA_localizationForAccSub))
     {
@@ -1851,8 +1945,8 @@ void Optimizer::accSubBeforeRA()
             hwConf.localizeForAcc(bb);
         }
 
-        kernel.fg.resetLocalDataFlowData();
-        kernel.fg.localDataFlowAnalysis();
+        ValidAnalyses &= ~AI_LocalDataflow;
+        computeLocalDataflow();
     }
 
     AccSubPass accSub(builder, kernel);
@@ -1878,6 +1972,9 @@ bool Optimizer::R0CopyNeeded()
 
 int Optimizer::optimization()
 {
+    // constructFlowGraph() builds def-use right before the optimizer runs.
+    ValidAnalyses = AI_LocalDataflow;
+
     // remove redundant message headers.
     runPass(PI_cleanMessageHeader);
 
@@ -1917,6 +2014,12 @@ int Optimizer::optimization()
     // Local Value Numbering
     runPass(PI_LVN);
 
+    // Global Value Numbering
+    runPass(PI_GVN);
+
+    // Move invariant send header and payload setup out of loops
+    runPass(PI_hoistMessagePayload);
+
     // this must be run after copy prop cleans up the moves
     runPass(PI_cleanupBindless);
 
@@ -2049,6 +2152,10 @@ int Optimizer::optimization()
     //-----------------------------------------------------------------------------------------------------------------
     runPass(PI_addSWSBInfo);
 
+    if (DefUseOutOfSync)
+    {
+        return VISA_FAILURE;
+    }
 
     return VISA_SUCCESS;
 }
@@ -6005,8 +6112,7 @@ bool Optimizer::foldPseudoAndOr(G4_BB* bb, INST_LIST_ITER& ii)
     //
     void Optimizer::cleanupBindless()
     {
-        kernel.fg.resetLocalDataFlowData();
-        kernel.fg.localDataFlowAnalysis();
+        computeLocalDataflow();
 
         // Perform send header cleanup for bindless sampler/surface
         for (auto bb : fg)
@@ -12080,8 +12186,7 @@ static bool isDeadInst(FlowGraph& fg, G4_INST* Inst)
 void Optimizer::dce()
 {
     // make sure dataflow is up to date
-    kernel.fg.resetLocalDataFlowData();
-    kernel.fg.localDataFlowAnalysis();
+    computeLocalDataflow();
 
     for (auto bb : fg) {
         for (auto I = bb->rbegin(), E = bb->rend(); I != E; ++I) {
@@ -198,6 +198,10 @@ class Optimizer
 
     void LVN();
 
+    void GVN();
+
+    void hoistMessagePayload();
+
     void ifCvt();
 
     void ifCvtFCCall();
@@ -313,6 +317,17 @@ private:
     /// This defines a pass type as a pointer to member function.
     typedef void (Optimizer::*PassType)();
 
+    /// Analyses whose validity runPass tracks across passes. Flow graph
+    /// analyses (dominators, loops, ...) are marked stale by the CFG edits
+    /// themselves through vISA::Analysis and are not listed here. Neither
+    /// is points-to: LVN is its only user in the optimizer and computes it
+    /// on the spot.
+    enum AnalysisID : unsigned {
+        AI_None          = 0,
+        AI_LocalDataflow = 1 << 0,  // def-use chains from localDataFlowAnalysis()
+        AI_All           = ~0u
+    };
+
     /// Data structure that collects information about passes.
     struct PassInfo {
         /// The pass to be executed for this kernel.
@@ -330,12 +345,21 @@ private:
         /// timer i.e. TIMER_NUM_TIMERS, then no time will be recorded.
         TimerID Timer;
 
+        /// The pass only improves code quality and is skipped in the tier-0
+        /// fast compile mode (vISA_FastCompileTier0).
+        bool SkipInTier0;
+
+        /// Mask of AnalysisID this pass keeps valid. Everything else is
+        /// invalidated once the pass has run.
+        unsigned Preserves;
+
         PassInfo(PassType P, const char *N, vISAOptions O,
                  TimerID T = TimerID::NUM_TIMERS)
-            : Pass(P), Name(N), Option(O), Timer(T) {}
+            : Pass(P), Name(N), Option(O), Timer(T), SkipInTier0(false),
+              Preserves(AI_None) {}
 
         PassInfo() : Pass(0), Name(0), Option(vISA_EnableAlways),
-            Timer(TimerID::NUM_TIMERS) {}
+            Timer(TimerID::NUM_TIMERS), SkipInTier0(false), Preserves(AI_None) {}
     };
 
     bool foldPseudoAndOr(G4_BB* bb, INST_LIST_ITER& iter);
@@ -373,6 +397,8 @@ public:
         PI_mergeScalarInst,
         PI_lowerMadSequence,
         PI_LVN,
+        PI_GVN,
+        PI_hoistMessagePayload,
         PI_ifCvt,
         PI_normalizeRegion,            // always
         PI_dumpPayload,
@@ -411,6 +437,17 @@ private:
     // indicates whether RA has failed
     bool RAFail;
 
+    /// Mask of AnalysisID currently valid.
+    unsigned ValidAnalyses = AI_None;
+
+    /// Set by -verifyDefUse when a pass marked as preserving def-use left
+    /// the chains out of sync; the compile then fails.
+    bool DefUseOutOfSync = false;
+
+    /// Make sure the def-use chains are valid, recomputing them unless the
+    /// passes since the last computation kept them up to date.
+    void computeLocalDataflow();
+
     /// Initialize all passes during the construction.
     void initOptimizations();
 
@@ -0,0 +1,366 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "GVN.hpp"
+#include "../Optimizer.h"
+
+#include <fstream>
+
+using namespace vISA;
+
+void Optimizer::GVN()
+{
+    GlobalValueNumbering gvn(builder, fg);
+    gvn.run();
+
+    if (kernel.getOption(vISA_OptReport))
+    {
+        std::ofstream optreport;
+        getOptReportStream(optreport, kernel.getOptions());
+        optreport << "===== GVN =====" << std::endl;
+        optreport << "Number of instructions removed: " << gvn.getNumInstsRemoved() << std::endl << std::endl;
+        closeOptReportStream(optreport);
+    }
+}
+
+static bool isGVNOpcode(G4_opcode op)
+{
+    switch (op)
+    {
+    case G4_mov:
+    case G4_add:
+    case G4_add3:
+    case G4_mul:
+    case G4_mad:
+    case G4_avg:
+    case G4_shl:
+    case G4_shr:
+    case G4_asr:
+    case G4_rol:
+    case G4_ror:
+    case G4_and:
+    case G4_or:
+    case G4_xor:
+    case G4_not:
+    case G4_bfe:
+    case G4_bfi1:
+    case G4_bfi2:
+    case G4_bfrev:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Only integer values are numbered; float results depend on the rounding
+// and denorm modes in cr0, which may change within a kernel.
+static bool isGVNType(G4_Type ty)
+{
+    return IS_TYPE_INT(ty) || ty == Type_V || ty == Type_UV;
+}
+
+void GlobalValueNumbering::collectDefs()
+{
+    for (auto dcl : fg.getKernel()->Declares)
+    {
+        if (dcl->getAliasDeclare())
+        {
+            excluded.insert(dcl);
+            excluded.insert(dcl->getRootDeclare());
+        }
+    }
+
+    for (auto bb : fg)
+    {
+        for (auto inst : *bb)
+        {
+            if (inst->isLifeTimeEnd())
+            {
+                // Extending the live range of a variable past its
+                // lifetime.end is not allowed.
+                for (unsigned i = 0; i < G4_MAX_SRCS; i++)
+                {
+                    auto src = inst->getSrc(i);
+                    if (src && src->getTopDcl())
+                    {
+                        excluded.insert(src->getTopDcl()->getRootDeclare());
+                    }
+                }
+            }
+
+            auto dst = inst->getDst();
+            if (!dst || dst->isNullReg() || !dst->getTopDcl())
+            {
+                continue;
+            }
+            // Indirect writes only reach address-taken variables, which are
+            // never treated as values.
+            if (dst->isIndirect())
+            {
+                continue;
+            }
+            const G4_Declare* dcl = dst->getTopDcl()->getRootDeclare();
+            ++numDefs[dcl];
+            singleDef[dcl] = std::make_pair(inst, bb);
+            if (inst->isLifeTimeEnd())
+            {
+                excluded.insert(dcl);
+            }
+        }
+    }
+}
+
+const G4_Declare* GlobalValueNumbering::getValueDcl(const G4_Declare* dcl) const
+{
+    auto it = replacement.find(dcl);
+    return it == replacement.end() ? dcl : it->second;
+}
+
+// Returns true if dcl holds the same value at every point dominated by its
+// definition, and that definition dominates useInst.
+bool GlobalValueNumbering::isValueDcl(
+    const G4_Declare* dcl, G4_INST* useInst, G4_BB* useBB)
+{
+    if (excluded.count(dcl) || dcl->getAddressed() || !dcl->useGRF() ||
+        dcl->isPreDefinedVar())
+    {
+        return false;
+    }
+
+    auto it = numDefs.find(dcl);
+    unsigned defCount = it == numDefs.end() ? 0 : it->second;
+    if (defCount == 0)
+    {
+        return dcl->isInput();
+    }
+    if (defCount != 1 || dcl->isInput() || !valueDcls.count(dcl))
+    {
+        return false;
+    }
+
+    auto& def = singleDef[dcl];
+    if (def.second == useBB)
+    {
+        return def.first->getLocalId() < useInst->getLocalId();
+    }
+    return def.second->dominates(useBB);
+}
+
+// Fill key with the value number of inst. Returns false if inst does not
+// compute a value that can be numbered.
+bool GlobalValueNumbering::computeKey(G4_INST* inst, G4_BB* bb, ValueKey& key)
+{
+    if (!isGVNOpcode(inst->opcode()) || inst->getPredicate() ||
+        inst->getCondMod() || inst->getImplAccSrc() || inst->getImplAccDst() ||
+        inst->isAccWrCtrlInst())
+    {
+        return false;
+    }
+
+    auto dst = inst->getDst();
+    if (!dst || dst->isNullReg() || dst->isIndirect() || !dst->getBase()->isRegVar() ||
+        !isGVNType(dst->getType()))
+    {
+        return false;
+    }
+    G4_Declare* dstDcl = dst->getTopDcl();
+    if (!dstDcl || dstDcl->getAliasDeclare() || dstDcl->getRegFile() != G4_GRF ||
+        excluded.count(dstDcl) || dstDcl->getAddressed() || dstDcl->isInput() ||
+        dstDcl->isOutput() || dstDcl->isPayloadLiveOut() || dstDcl->isBuiltin() ||
+        dstDcl->isPreDefinedVar() || dstDcl->isDoNotSpill() ||
+        dstDcl->getRegVar()->isPhyRegAssigned() || numDefs[dstDcl] != 1)
+    {
+        return false;
+    }
+
+    key.clear();
+    key.push_back(inst->opcode());
+    key.push_back(inst->getExecSize());
+    key.push_back(inst->getMaskOffset());
+    key.push_back(inst->getOption());
+    key.push_back(inst->getSaturate());
+    // The replacement must be interchangeable with dstDcl at every use, so
+    // the declares need the same shape as well as the same written region.
+    key.push_back(dstDcl->getElemType());
+    key.push_back(dstDcl->getTotalElems());
+    key.push_back(dstDcl->getSubRegAlign());
+    key.push_back(dstDcl->isEvenAlign());
+    key.push_back(dst->getType());
+    key.push_back(dst->getRegOff());
+    key.push_back(dst->getSubRegOff());
+    key.push_back(dst->getHorzStride());
+
+    for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; ++i)
+    {
+        auto src = inst->getSrc(i);
+        if (!src)
+        {
+            return false;
+        }
+        if (src->isImm())
+        {
+            if (!isGVNType(src->getType()))
+            {
+                return false;
+            }
+            key.push_back(0);
+            key.push_back(src->getType());
+            key.push_back(src->asImm()->getImm());
+            continue;
+        }
+        if (!src->isSrcRegRegion())
+        {
+            return false;
+        }
+        auto srcRgn = src->asSrcRegRegion();
+        if (srcRgn->isIndirect() || !srcRgn->getBase()->isRegVar() ||
+            !srcRgn->getTopDcl() || srcRgn->getTopDcl()->getAliasDeclare() ||
+            !isGVNType(srcRgn->getType()))
+        {
+            return false;
+        }
+        const G4_Declare* srcDcl = getValueDcl(srcRgn->getTopDcl());
+        if (!isValueDcl(srcDcl, inst, bb))
+        {
+            return false;
+        }
+        const RegionDesc* rd = srcRgn->getRegion();
+        key.push_back(1);
+        key.push_back(srcDcl->getDeclId());
+        key.push_back(srcRgn->getType());
+        key.push_back(srcRgn->getModifier());
+        key.push_back(srcRgn->getRegOff());
+        key.push_back(srcRgn->getSubRegOff());
+        key.push_back(rd->vertStride);
+        key.push_back(rd->width);
+        key.push_back(rd->horzStride);
+    }
+
+    return true;
+}
+
+void GlobalValueNumbering::processBlock(G4_BB* bb, std::vector<ValueKey>& addedKeys)
+{
+    bb->resetLocalIds();
+
+    ValueKey key;
+    for (auto it = bb->begin(), ie = bb->end(); it != ie;)
+    {
+        G4_INST* inst = *it;
+        if (!computeKey(inst, bb, key))
+        {
+            ++it;
+            continue;
+        }
+
+        G4_Declare* dstDcl = inst->getDst()->getTopDcl();
+        auto found = availValues.find(key);
+        if (found == availValues.end())
+        {
+            valueDcls.insert(dstDcl);
+            availValues.emplace(key, inst);
+            addedKeys.push_back(key);
+            ++it;
+            continue;
+        }
+
+        replacement[dstDcl] = found->second->getDst()->getTopDcl();
+        inst->removeAllDefs();
+        inst->removeAllUses();
+        it = bb->erase(it);
+        ++numInstsRemoved;
+    }
+}
+
+void GlobalValueNumbering::replaceUses()
+{
+    for (auto bb : fg)
+    {
+        for (auto inst : *bb)
+        {
+            for (unsigned i = 0; i < G4_MAX_SRCS; i++)
+            {
+                auto src = inst->getSrc(i);
+                if (!src || !src->isSrcRegRegion() || !src->getTopDcl())
+                {
+                    continue;
+                }
+                auto it = replacement.find(src->getTopDcl());
+                if (it == replacement.end())
+                {
+                    continue;
+                }
+                auto srcRgn = src->asSrcRegRegion();
+                G4_SrcRegRegion* newSrc = builder.createSrcRegRegion(
+                    srcRgn->getModifier(), srcRgn->getRegAccess(), it->second->getRegVar(),
+                    srcRgn->getRegOff(), srcRgn->getSubRegOff(), srcRgn->getRegion(),
+                    srcRgn->getType());
+                inst->setSrc(newSrc, i);
+            }
+        }
+    }
+}
+
+void GlobalValueNumbering::run()
+{
+    // Stack call ABI variables are defined implicitly by calls and returns.
+    if (fg.getHasStackCalls() || fg.getIsStackCallFunc())
+    {
+        return;
+    }
+
+    collectDefs();
+
+    // Build the dominator tree. Unreachable blocks have no immediate
+    // dominator and are left alone.
+    const std::vector<G4_BB*>& iDoms = fg.getImmDominator().getIDoms();
+    std::vector<std::vector<G4_BB*>> children(iDoms.size());
+    G4_BB* entryBB = fg.getEntryBB();
+    for (auto bb : fg)
+    {
+        G4_BB* iDom = iDoms[bb->getId()];
+        if (bb != entryBB && iDom && iDom != bb)
+        {
+            children[iDom->getId()].push_back(bb);
+        }
+    }
+
+    // Walk the dominator tree in preorder, keeping only the values defined
+    // by the blocks on the current path available.
+    struct DomNode
+    {
+        G4_BB* bb;
+        size_t nextChild;
+        std::vector<ValueKey> addedKeys;
+    };
+    std::vector<DomNode> stack;
+    stack.push_back(DomNode{ entryBB, 0, {} });
+    processBlock(entryBB, stack.back().addedKeys);
+    while (!stack.empty())
+    {
+        DomNode& node = stack.back();
+        auto& succs = children[node.bb->getId()];
+        if (node.nextChild < succs.size())
+        {
+            G4_BB* child = succs[node.nextChild++];
+            stack.push_back(DomNode{ child, 0, {} });
+            processBlock(child, stack.back().addedKeys);
+            continue;
+        }
+        for (auto& key : node.addedKeys)
+        {
+            availValues.erase(key);
+        }
+        stack.pop_back();
+    }
+
+    if (!replacement.empty())
+    {
+        replaceUses();
+    }
+}
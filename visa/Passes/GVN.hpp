@@ -0,0 +1,78 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef G4_PASSES_GVN_HPP
+#define G4_PASSES_GVN_HPP
+
+#include "../BuildIR.h"
+#include "../FlowGraph.h"
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace vISA
+{
+    // Dominator-tree based global value numbering.
+    //
+    // G4 IR is not in SSA form, so values are only numbered for variables
+    // that behave like SSA values: GRF declares with exactly one definition
+    // (or kernel inputs that are never written), no aliases and no address
+    // taken. An instruction is a candidate if it is unpredicated, has no
+    // conditional modifier or implicit acc operand, works on integer types,
+    // and all its register sources are such values whose definitions dominate
+    // it. The value number of a candidate is made of its opcode, execution
+    // mask, destination region and the exact source regions and immediates,
+    // so partial (sub-register) writes and reads are only matched when they
+    // cover identical bytes.
+    //
+    // A candidate that is dominated by an identical candidate is removed,
+    // and every use of its destination is redirected to the dominating
+    // instruction's destination.
+    class GlobalValueNumbering
+    {
+    public:
+        GlobalValueNumbering(IR_Builder& b, FlowGraph& g) : builder(b), fg(g) {}
+
+        void run();
+
+        unsigned getNumInstsRemoved() const { return numInstsRemoved; }
+
+    private:
+        using ValueKey = std::vector<int64_t>;
+
+        IR_Builder& builder;
+        FlowGraph& fg;
+        unsigned numInstsRemoved = 0;
+
+        // Number of definitions of each root declare, and the defining
+        // instruction and block if there is exactly one.
+        std::unordered_map<const G4_Declare*, unsigned> numDefs;
+        std::unordered_map<const G4_Declare*, std::pair<G4_INST*, G4_BB*>> singleDef;
+        // Declares that can't be treated as values: aliased, referenced by
+        // lifetime markers, etc.
+        std::unordered_set<const G4_Declare*> excluded;
+        // Single-def declares whose definition is a candidate.
+        std::unordered_set<const G4_Declare*> valueDcls;
+        // Removed destination -> dominating replacement.
+        std::unordered_map<const G4_Declare*, G4_Declare*> replacement;
+
+        // Values available at the current point of the dominator tree walk.
+        std::map<ValueKey, G4_INST*> availValues;
+
+        void collectDefs();
+        bool isValueDcl(const G4_Declare* dcl, G4_INST* useInst, G4_BB* useBB);
+        const G4_Declare* getValueDcl(const G4_Declare* dcl) const;
+        bool computeKey(G4_INST* inst, G4_BB* bb, ValueKey& key);
+        void processBlock(G4_BB* bb, std::vector<ValueKey>& addedKeys);
+        void replaceUses();
+    };
+}
+
+#endif // G4_PASSES_GVN_HPP
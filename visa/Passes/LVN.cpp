@@ -569,6 +569,18 @@ void LVN::replaceAllUses(G4_INST* defInst, bool negate, UseList& uses, G4_INST*
 
         unsigned int srcIndex = G4_INST::getSrcNum(use.second);
         useInst->setSrc(srcRgn, srcIndex);
+
+        // lvnInst is the only def of the new operand as long as it writes
+        // every channel. Otherwise earlier defs may reach the use as well.
+        if (bb->isAllLaneActive() || lvnInst->isWriteEnableInst())
+        {
+            useInst->removeDefUse(use.second);
+            lvnInst->addDefUse(useInst, use.second);
+        }
+        else
+        {
+            defUseUpToDate = false;
+        }
     }
 }
 
@@ -1654,7 +1666,7 @@ void LVN::removeAddrTaken(G4_AddrExp* opnd)
         )
     {
         auto prev_it = it;
-        (*prev_it).second.second->getInst()->removeAllUses();
+        defUse.erase((*prev_it).second.second->getInst());
         it++;
         activeDefs.erase(prev_it);
     }
@@ -1951,6 +1963,8 @@ void LVN::doLVN()
 
                         if (removeInst)
                         {
+                            inst->removeAllDefs();
+                            inst->removeAllUses();
                             INST_LIST_ITER prev_it = inst_it;
                             inst_it--;
                             bb->erase(prev_it);
@@ -1987,6 +2001,14 @@ unsigned int LVN::removeRedundantSamplerMovs(G4_Kernel& kernel, G4_BB* bb)
     G4_INST* lastSamplerDclDef = nullptr;
     unsigned int numInstsRemoved = 0;
 
+    // The uses of a removed mov are moved over to lastSamplerDclDef, which
+    // is exact only if both movs write the header in every channel.
+    auto writesAllChannels = [bb](G4_INST* inst)
+    {
+        return !inst->getPredicate() &&
+            (bb->isAllLaneActive() || inst->isWriteEnableInst());
+    };
+
     for (auto instIt = bb->begin(); instIt != bb->end();)
     {
         auto inst = (*instIt);
@@ -2007,9 +2029,13 @@ unsigned int LVN::removeRedundantSamplerMovs(G4_Kernel& kernel, G4_BB* bb)
                 lastSamplerDclDef->getDst()->getRightBound() == dst->getRightBound() &&
                 lastSamplerDclDef->getSrc(0)->isImm() &&
                 inst->getSrc(0)->isImm() &&
-                lastSamplerDclDef->getSrc(0)->asImm()->isEqualTo(inst->getSrc(0)->asImm()))
+                lastSamplerDclDef->getSrc(0)->asImm()->isEqualTo(inst->getSrc(0)->asImm()) &&
+                writesAllChannels(lastSamplerDclDef) &&
+                writesAllChannels(inst))
             {
                 // Redundant mov found, erase it
+                inst->transferUse(lastSamplerDclDef, true);
+                inst->removeAllDefs();
                 instIt = bb->erase(instIt);
                 numInstsRemoved++;
                 continue;
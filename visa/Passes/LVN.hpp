@@ -112,6 +112,7 @@ namespace vISA
         IR_Builder& builder;
         unsigned int numInstsRemoved;
         bool duTablePopulated;
+        bool defUseUpToDate;
         PointsToAnalysis& p2a;
         std::vector<LVNItemInfo*> toDtor;
         std::vector<std::pair<G4_Declare*, LVNItemInfo*>> perInstValueCache;
@@ -162,12 +163,16 @@ namespace vISA
             bb = curBB;
             numInstsRemoved = 0;
             duTablePopulated = false;
+            defUseUpToDate = true;
         }
 
         ~LVN();
 
         void doLVN();
         unsigned int getNumInstsRemoved() { return numInstsRemoved; }
+        // False if some replaced use could not be linked to its new def in
+        // the def-use chains of the instructions.
+        bool isDefUseUpToDate() { return defUseUpToDate; }
 
         static unsigned int removeRedundantSamplerMovs(G4_Kernel&, G4_BB*);
     };
@@ -0,0 +1,654 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "MessagePayloadHoisting.hpp"
+#include "../GraphColor.h"
+#include "../Optimizer.h"
+#include "../RPE.h"
+
+#include <algorithm>
+#include <fstream>
+
+using namespace vISA;
+
+void Optimizer::hoistMessagePayload()
+{
+    MessagePayloadHoisting hoisting(builder, kernel);
+    hoisting.run();
+    builder.getcompilerStats().SetI64(CompilerStats::numPayloadHoistStr(),
+        hoisting.getNumInstsHoisted(), kernel.getSimdSize());
+
+    if (kernel.getOption(vISA_OptReport))
+    {
+        std::ofstream optreport;
+        getOptReportStream(optreport, kernel.getOptions());
+        optreport << "===== Message payload hoisting =====" << std::endl;
+        optreport << "Number of loops changed: " << hoisting.getNumLoopsChanged() << std::endl;
+        optreport << "Number of instructions hoisted: " << hoisting.getNumInstsHoisted() << std::endl << std::endl;
+        closeOptReportStream(optreport);
+    }
+}
+
+// GRFs kept free on top of the estimated pressure of a loop, in the same
+// spirit as RA's high pressure check.
+static const unsigned PressureMargin = 16;
+
+static bool isHoistOpcode(G4_opcode op)
+{
+    switch (op)
+    {
+    case G4_mov:
+    case G4_add:
+    case G4_add3:
+    case G4_mul:
+    case G4_shl:
+    case G4_shr:
+    case G4_asr:
+    case G4_and:
+    case G4_or:
+    case G4_xor:
+    case G4_not:
+    case G4_bfi1:
+    case G4_bfi2:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static const G4_Declare* getRootDcl(G4_Operand* opnd)
+{
+    G4_Declare* dcl = opnd ? opnd->getTopDcl() : nullptr;
+    return dcl ? dcl->getRootDeclare() : nullptr;
+}
+
+// Pseudo kills inserted by the liveness RPE is built on. They are removed
+// again when the liveness is destroyed, and are not counted as references.
+static bool isLivenessKill(G4_INST* inst)
+{
+    G4_Operand* src0 = inst->isPseudoKill() ? inst->getSrc(0) : nullptr;
+    return src0 && src0->isImm() &&
+        src0->asImm()->getImm() == PseudoKillType::FromLiveness;
+}
+
+static bool overlaps(G4_INST* inst1, G4_INST* inst2)
+{
+    G4_DstRegRegion* dst1 = inst1->getDst();
+    G4_DstRegRegion* dst2 = inst2->getDst();
+    return dst1->getLeftBound() <= dst2->getRightBound() &&
+        dst2->getLeftBound() <= dst1->getRightBound();
+}
+
+MessagePayloadHoisting::MessagePayloadHoisting(IR_Builder& b, G4_Kernel& k)
+    : builder(b), kernel(k)
+{
+}
+
+MessagePayloadHoisting::~MessagePayloadHoisting()
+{
+    delete rpe;
+}
+
+void MessagePayloadHoisting::collectRefs()
+{
+    for (auto dcl : kernel.Declares)
+    {
+        if (dcl->getAliasDeclare())
+        {
+            excluded.insert(dcl);
+            excluded.insert(dcl->getRootDeclare());
+        }
+    }
+
+    for (auto bb : kernel.fg)
+    {
+        for (auto inst : *bb)
+        {
+            auto dst = inst->getDst();
+            if (dst && !dst->isNullReg() && !dst->isIndirect())
+            {
+                if (auto dcl = getRootDcl(dst))
+                {
+                    ++numRefs[dcl];
+                }
+            }
+            for (unsigned i = 0; i < G4_MAX_SRCS; i++)
+            {
+                if (auto dcl = getRootDcl(inst->getSrc(i)))
+                {
+                    ++numRefs[dcl];
+                    if (inst->isLifeTimeEnd())
+                    {
+                        excluded.insert(dcl);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Returns the preheader of loop if it already has one. New blocks are not
+// created here, as that would invalidate the CFG based analyses the rest of
+// the optimizer relies on.
+G4_BB* MessagePayloadHoisting::getPreheader(Loop* loop)
+{
+    if (loop->preHeader)
+    {
+        return loop->preHeader;
+    }
+
+    G4_BB* header = loop->getHeader();
+    G4_BB* enteringNode = nullptr;
+    for (auto pred : header->Preds)
+    {
+        if (loop->contains(pred))
+        {
+            continue;
+        }
+        if (enteringNode)
+        {
+            return nullptr;
+        }
+        enteringNode = pred;
+    }
+
+    if (!enteringNode || enteringNode->Succs.size() != 1 ||
+        !enteringNode->dominates(header))
+    {
+        return nullptr;
+    }
+    return enteringNode;
+}
+
+void MessagePayloadHoisting::collectLoopRefs(Loop* loop)
+{
+    loopRefs.clear();
+    loopDefs.clear();
+    loopUses.clear();
+    loopKills.clear();
+    instBB.clear();
+
+    for (auto bb : loop->getBBs())
+    {
+        bb->resetLocalIds();
+        for (auto inst : *bb)
+        {
+            if (isLivenessKill(inst))
+            {
+                continue;
+            }
+            instBB[inst] = bb;
+
+            auto dst = inst->getDst();
+            if (dst && !dst->isNullReg() && !dst->isIndirect())
+            {
+                if (auto dcl = getRootDcl(dst))
+                {
+                    ++loopRefs[dcl];
+                    if (inst->isPseudoKill())
+                    {
+                        loopKills[dcl].push_back(inst);
+                    }
+                    else
+                    {
+                        loopDefs[dcl].push_back(inst);
+                    }
+                }
+            }
+            for (unsigned i = 0; i < G4_MAX_SRCS; i++)
+            {
+                if (auto dcl = getRootDcl(inst->getSrc(i)))
+                {
+                    ++loopRefs[dcl];
+                    Refs& uses = loopUses[dcl];
+                    if (uses.empty() || uses.back() != inst)
+                    {
+                        uses.push_back(inst);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Returns true if inst computes the same value on every iteration of loop
+// regardless of the execution mask, so it may execute once before the loop.
+bool MessagePayloadHoisting::isHoistCandidate(G4_INST* inst)
+{
+    if (!isHoistOpcode(inst->opcode()) || inst->getPredicate() ||
+        inst->getCondMod() || inst->getImplAccSrc() || inst->getImplAccDst() ||
+        inst->isAccWrCtrlInst() || !inst->isWriteEnableInst())
+    {
+        return false;
+    }
+
+    auto dst = inst->getDst();
+    if (!dst || dst->isIndirect() || !getRootDcl(dst))
+    {
+        return false;
+    }
+
+    // Float results depend on the rounding and denorm modes in cr0, which
+    // may be changed in the loop. A float mov is only a copy if it does not
+    // convert.
+    G4_Type dstTy = dst->getType();
+    for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+    {
+        auto src = inst->getSrc(i);
+        if (!src)
+        {
+            return false;
+        }
+
+        G4_Type srcTy = src->getType();
+        bool isCopy = inst->opcode() == G4_mov && srcTy == dstTy &&
+            (!src->isSrcRegRegion() || src->asSrcRegRegion()->getModifier() == Mod_src_undef);
+        if (!isCopy && (!IS_TYPE_INT(dstTy) ||
+            !(IS_TYPE_INT(srcTy) || srcTy == Type_V || srcTy == Type_UV)))
+        {
+            return false;
+        }
+
+        if (src->isImm())
+        {
+            continue;
+        }
+        if (!src->isSrcRegRegion() || src->asSrcRegRegion()->isIndirect())
+        {
+            return false;
+        }
+        const G4_Declare* dcl = getRootDcl(src);
+        if (!dcl || !dcl->useGRF() || dcl->getAddressed() ||
+            loopDefs.count(dcl) || loopKills.count(dcl))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns true if all references of dcl are in one block of loop, after
+// its lifetime starts, and dcl has no other way of being observed.
+bool MessagePayloadHoisting::isHoistableDcl(const G4_Declare* dcl,
+    const std::unordered_set<const G4_Declare*>& payloadDcls)
+{
+    if (excluded.count(dcl) || !payloadDcls.count(dcl) || !dcl->useGRF() ||
+        dcl->getAddressed() || dcl->isInput() || dcl->isOutput() ||
+        dcl->isPayloadLiveOut() || dcl->isBuiltin() || dcl->isPreDefinedVar())
+    {
+        return false;
+    }
+    if (loopRefs[dcl] != numRefs[dcl])
+    {
+        return false;
+    }
+
+    const Refs& defs = loopDefs[dcl];
+    const Refs& uses = loopUses[dcl];
+    G4_BB* bb = instBB[defs.front()];
+    int firstRef = INT_MAX;
+    for (const Refs* refs : { &defs, &uses })
+    {
+        for (auto inst : *refs)
+        {
+            if (instBB[inst] != bb)
+            {
+                return false;
+            }
+            firstRef = std::min(firstRef, inst->getLocalId());
+        }
+    }
+    for (auto kill : loopKills[dcl])
+    {
+        if (instBB[kill] != bb || kill->getLocalId() > firstRef)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Collects the variables that make up the payload of the sends in loop:
+// send sources, and variables only used to compute them.
+void MessagePayloadHoisting::computePayloadDcls(
+    std::unordered_set<const G4_Declare*>& payloadDcls)
+{
+    for (auto& uses : loopUses)
+    {
+        for (auto inst : uses.second)
+        {
+            if (inst->isSend())
+            {
+                payloadDcls.insert(uses.first);
+                break;
+            }
+        }
+    }
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (auto& uses : loopUses)
+        {
+            if (payloadDcls.count(uses.first) || !loopDefs.count(uses.first))
+            {
+                continue;
+            }
+            bool feedsPayload = std::all_of(uses.second.begin(), uses.second.end(),
+                [&](G4_INST* inst)
+                {
+                    return !inst->isSend() && payloadDcls.count(getRootDcl(inst->getDst()));
+                });
+            if (feedsPayload)
+            {
+                payloadDcls.insert(uses.first);
+                changed = true;
+            }
+        }
+    }
+}
+
+// Selects the definitions of dcl that can be moved to the preheader of
+// loop. All references of dcl are in one block.
+void MessagePayloadHoisting::selectDefs(const G4_Declare* dcl, Refs& hoisted)
+{
+    Refs defs = loopDefs[dcl];
+    const Refs& uses = loopUses[dcl];
+    auto byId = [](G4_INST* a, G4_INST* b) { return a->getLocalId() < b->getLocalId(); };
+    std::sort(defs.begin(), defs.end(), byId);
+
+    std::vector<bool> hoist(defs.size());
+    for (size_t i = 0; i < defs.size(); i++)
+    {
+        hoist[i] = isHoistCandidate(defs[i]);
+    }
+
+    // A use in (def1, def2] of bytes written by both would see def2's value
+    // from the previous iteration once def1 is out of the loop.
+    auto isUsedBetween = [&](G4_INST* def1, G4_INST* def2)
+    {
+        return std::any_of(uses.begin(), uses.end(), [&](G4_INST* use)
+            {
+                return use->getLocalId() > def1->getLocalId() &&
+                    use->getLocalId() <= def2->getLocalId();
+            });
+    };
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = 0; i < defs.size(); i++)
+        {
+            if (!hoist[i])
+            {
+                continue;
+            }
+            bool legal = true;
+            for (size_t j = 0; j < defs.size() && legal; j++)
+            {
+                if (j == i || !overlaps(defs[i], defs[j]))
+                {
+                    continue;
+                }
+                if (j < i)
+                {
+                    // Once hoisted, defs[i] would no longer overwrite
+                    // defs[j] on each iteration.
+                    legal = hoist[j];
+                }
+                else
+                {
+                    // defs[j] keeps overwriting the bytes before they are
+                    // read; it has to write them on every iteration.
+                    legal = !isUsedBetween(defs[i], defs[j]) &&
+                        (hoist[j] ||
+                         (!defs[j]->getPredicate() && defs[j]->isWriteEnableInst()));
+                }
+            }
+            if (!legal)
+            {
+                hoist[i] = false;
+                changed = true;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < defs.size(); i++)
+    {
+        if (hoist[i])
+        {
+            hoisted.push_back(defs[i]);
+        }
+    }
+}
+
+unsigned MessagePayloadHoisting::getMaxPressure(G4_BB* bb)
+{
+    auto it = blockPressure.find(bb);
+    if (it != blockPressure.end())
+    {
+        return it->second;
+    }
+
+    unsigned maxRP = 0;
+    for (auto inst : *bb)
+    {
+        if (!inst->isPseudoKill())
+        {
+            maxRP = std::max(maxRP, rpe->getRPE()->getRegisterPressure(inst));
+        }
+    }
+    blockPressure[bb] = maxRP;
+    return maxRP;
+}
+
+// Returns true if dcl may be made live across the whole loop and at the end
+// of its preheader, on top of the pendingRows GRFs already selected for
+// hoisting out of loop.
+bool MessagePayloadHoisting::fitsPressure(const G4_Declare* dcl, Loop* loop,
+    G4_BB* preheader, unsigned pendingRows)
+{
+    if (!rpe)
+    {
+        // Only GRF variables count against the GRF budget, so flags and
+        // address registers are left out of the liveness.
+        rpe = new StandaloneRPE(kernel, G4_GRF | G4_INPUT);
+        rpe->getRPE()->run();
+    }
+
+    unsigned numGRF = kernel.getNumRegTotal() -
+        builder.getOptions()->getuInt32Option(vISA_ReservedGRFNum);
+    unsigned rows = pendingRows + dcl->getNumRows();
+    if (getMaxPressure(preheader) + rows + PressureMargin > numGRF)
+    {
+        return false;
+    }
+    for (auto bb : loop->getBBs())
+    {
+        if (getMaxPressure(bb) + rows + PressureMargin > numGRF)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Makes the hoisted variables live across loop and out of its preheader,
+// and recomputes the pressure of those blocks.
+void MessagePayloadHoisting::updatePressure(
+    const std::vector<const G4_Declare*>& hoistedDcls, Loop* loop, G4_BB* preheader)
+{
+    LivenessAnalysis* liveness = rpe->getLiveness();
+    if (liveness->getNumSelectedVar() == 0)
+    {
+        return;
+    }
+
+    for (auto dcl : hoistedDcls)
+    {
+        const G4_RegVar* var = dcl->getRegVar();
+        if (!var->isRegAllocPartaker() || var->getId() >= liveness->getNumSelectedVar())
+        {
+            continue;
+        }
+        unsigned id = var->getId();
+        for (auto bb : loop->getBBs())
+        {
+            liveness->def_in[bb->getId()].set(id, true);
+            liveness->use_in[bb->getId()].set(id, true);
+            liveness->def_out[bb->getId()].set(id, true);
+            liveness->use_out[bb->getId()].set(id, true);
+        }
+        liveness->def_out[preheader->getId()].set(id, true);
+        liveness->use_out[preheader->getId()].set(id, true);
+    }
+
+    rpe->getRPE()->runBB(preheader);
+    blockPressure.erase(preheader);
+    for (auto bb : loop->getBBs())
+    {
+        rpe->getRPE()->runBB(bb);
+        blockPressure.erase(bb);
+    }
+}
+
+// Moves the invariant payload definitions of loop to the end of its
+// preheader. Returns true if anything was moved.
+bool MessagePayloadHoisting::hoistLoop(Loop* loop, G4_BB* preheader)
+{
+    collectLoopRefs(loop);
+
+    std::unordered_set<const G4_Declare*> payloadDcls;
+    computePayloadDcls(payloadDcls);
+
+    // Visit variables in program order so the result doesn't depend on
+    // hash table order when pressure is tight.
+    std::vector<const G4_Declare*> dcls;
+    for (auto bb : loop->getBBs())
+    {
+        for (auto inst : *bb)
+        {
+            auto dcl = getRootDcl(inst->getDst());
+            if (dcl && !inst->isPseudoKill() && loopDefs.count(dcl) &&
+                loopDefs[dcl].front() == inst)
+            {
+                dcls.push_back(dcl);
+            }
+        }
+    }
+
+    std::unordered_set<G4_INST*> toHoist;
+    std::vector<const G4_Declare*> hoistedDcls;
+    unsigned pendingRows = 0;
+    for (auto dcl : dcls)
+    {
+        if (!isHoistableDcl(dcl, payloadDcls))
+        {
+            continue;
+        }
+        Refs hoisted;
+        selectDefs(dcl, hoisted);
+        if (hoisted.empty() || !fitsPressure(dcl, loop, preheader, pendingRows))
+        {
+            continue;
+        }
+        pendingRows += dcl->getNumRows();
+        hoistedDcls.push_back(dcl);
+        // The lifetime of dcl now starts in the preheader.
+        toHoist.insert(loopKills[dcl].begin(), loopKills[dcl].end());
+        toHoist.insert(hoisted.begin(), hoisted.end());
+    }
+
+    if (toHoist.empty())
+    {
+        return false;
+    }
+
+    // Kills the liveness put in front of the first definition of a
+    // partially written variable move with it.
+    std::unordered_set<const G4_Declare*> hoistedSet(hoistedDcls.begin(), hoistedDcls.end());
+    auto isHoisted = [&](G4_INST* inst)
+    {
+        return toHoist.count(inst) ||
+            (isLivenessKill(inst) && hoistedSet.count(getRootDcl(inst->getDst())));
+    };
+
+    auto insertIt = preheader->end();
+    if (!preheader->empty() && preheader->back()->isFlowControl())
+    {
+        --insertIt;
+    }
+
+    for (auto bb : loop->getBBs())
+    {
+        for (auto it = bb->begin(); it != bb->end();)
+        {
+            G4_INST* inst = *it;
+            if (!isHoisted(inst))
+            {
+                ++it;
+                continue;
+            }
+            preheader->insertBefore(insertIt, inst);
+            it = bb->erase(it);
+            if (!inst->isPseudoKill())
+            {
+                ++numInstsHoisted;
+            }
+        }
+    }
+
+    updatePressure(hoistedDcls, loop, preheader);
+    return true;
+}
+
+void MessagePayloadHoisting::processLoop(Loop* loop)
+{
+    for (auto nested : loop->immNested)
+    {
+        processLoop(nested);
+    }
+
+    G4_BB* preheader = getPreheader(loop);
+    if (!preheader)
+    {
+        return;
+    }
+
+    // A callee may read or write any variable, so nothing is invariant in
+    // loops with calls.
+    for (auto bb : loop->getBBs())
+    {
+        if (bb->isEndWithCall() || bb->isEndWithFCall())
+        {
+            return;
+        }
+    }
+
+    bool changed = false;
+    while (hoistLoop(loop, preheader))
+    {
+        changed = true;
+    }
+    if (changed)
+    {
+        ++numLoopsChanged;
+    }
+}
+
+void MessagePayloadHoisting::run()
+{
+    collectRefs();
+
+    for (auto loop : kernel.fg.getLoops().getTopLoops())
+    {
+        processLoop(loop);
+    }
+}
@@ -0,0 +1,113 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef G4_PASSES_MESSAGE_PAYLOAD_HOISTING_HPP
+#define G4_PASSES_MESSAGE_PAYLOAD_HOISTING_HPP
+
+#include "../BuildIR.h"
+#include "../FlowGraph.h"
+#include "../LoopAnalysis.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace vISA
+{
+    class StandaloneRPE;
+
+    // Hoists loop invariant message header and payload setup out of loops.
+    //
+    // Message headers are rebuilt in front of every send, so a send in a
+    // loop body re-copies r0 (or the cached sampler header) and re-writes the
+    // surface state, sampler state and offset fields on each iteration, even
+    // though most of them never change. cleanMessageHeader only removes such
+    // copies within a block.
+    //
+    // A variable is considered if it feeds the payload of a send in the loop
+    // (directly or through temporaries), it is only referenced in the loop
+    // and only in one block of it, and it is a plain GRF variable (no
+    // aliases, not address taken, not input/output or builtin). A definition
+    // of such a variable is moved to the end of the loop preheader if it is
+    // an unpredicated NoMask ALU instruction whose sources are immediates or
+    // variables not written in the loop, and moving it can't change what the
+    // loop reads: no definition that stays in the loop writes the same bytes
+    // before it, and a definition that stays in the loop and overwrites some
+    // of them afterwards (the varying fields) does so on every iteration
+    // before the variable is read. The varying field updates therefore stay
+    // in the body, and only they are executed per iteration.
+    //
+    // Loops are processed from the innermost out, and each loop is revisited
+    // until nothing more can be hoisted, so invariant chains (e.g. a base
+    // offset computed into a temporary and then copied into the header) move
+    // together. A hoisted definition stays in the preheader: once moved, its
+    // variable is referenced in more than one block, so it is not considered
+    // again for an enclosing loop.
+    //
+    // The hoisted variable becomes live across the whole loop and at the end
+    // of the preheader; a variable is not hoisted if that would push the
+    // pressure of any of these blocks, as estimated by RPE, past the GRF
+    // budget. RPE is built the first time a variable is about to be hoisted,
+    // and the liveness and pressure of the blocks are updated after each
+    // hoist, so enclosing loops see the code moved out of inner loops.
+    class MessagePayloadHoisting
+    {
+    public:
+        MessagePayloadHoisting(IR_Builder& b, G4_Kernel& k);
+        ~MessagePayloadHoisting();
+
+        void run();
+
+        unsigned getNumInstsHoisted() const { return numInstsHoisted; }
+        unsigned getNumLoopsChanged() const { return numLoopsChanged; }
+
+    private:
+        using Refs = std::vector<G4_INST*>;
+
+        IR_Builder& builder;
+        G4_Kernel& kernel;
+        unsigned numInstsHoisted = 0;
+        unsigned numLoopsChanged = 0;
+
+        // Number of operands referencing each root declare in the kernel.
+        std::unordered_map<const G4_Declare*, unsigned> numRefs;
+        // Declares that are never hoisted: aliased, address taken, killed by
+        // lifetime.end, etc.
+        std::unordered_set<const G4_Declare*> excluded;
+
+        // References in the loop being processed, per root declare.
+        std::unordered_map<const G4_Declare*, unsigned> loopRefs;
+        std::unordered_map<const G4_Declare*, Refs> loopDefs;
+        std::unordered_map<const G4_Declare*, Refs> loopUses;
+        std::unordered_map<const G4_Declare*, Refs> loopKills;
+        std::unordered_map<const G4_INST*, G4_BB*> instBB;
+
+        // Register pressure, built on first use.
+        StandaloneRPE* rpe = nullptr;
+        // Max pressure of each block, kept up to date as code is hoisted.
+        std::unordered_map<const G4_BB*, unsigned> blockPressure;
+
+        void collectRefs();
+        G4_BB* getPreheader(Loop* loop);
+        void collectLoopRefs(Loop* loop);
+        bool isHoistCandidate(G4_INST* inst);
+        bool isHoistableDcl(const G4_Declare* dcl,
+            const std::unordered_set<const G4_Declare*>& payloadDcls);
+        void computePayloadDcls(std::unordered_set<const G4_Declare*>& payloadDcls);
+        void selectDefs(const G4_Declare* dcl, Refs& hoisted);
+        unsigned getMaxPressure(G4_BB* bb);
+        bool fitsPressure(const G4_Declare* dcl, Loop* loop, G4_BB* preheader,
+            unsigned pendingRows);
+        void updatePressure(const std::vector<const G4_Declare*>& hoistedDcls,
+            Loop* loop, G4_BB* preheader);
+        bool hoistLoop(Loop* loop, G4_BB* preheader);
+        void processLoop(Loop* loop);
+    };
+}
+
+#endif // G4_PASSES_MESSAGE_PAYLOAD_HOISTING_HPP
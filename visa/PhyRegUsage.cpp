@@ -1267,6 +1267,26 @@ void LiveRange::allocForbiddenVector(Mem_Manager& mem)
     }
 }
 
+std::vector<bool> LiveRange::saveForbidden() const
+{
+    if (forbidden == nullptr)
+    {
+        return std::vector<bool>();
+    }
+    return std::vector<bool>(forbidden, forbidden + getForbiddenVectorSize());
+}
+
+void LiveRange::restoreForbidden(const std::vector<bool>& saved)
+{
+    if (forbidden == nullptr)
+    {
+        return;
+    }
+    MUST_BE_TRUE(saved.size() == getForbiddenVectorSize(), "forbidden vector size mismatch");
+    std::copy(saved.begin(), saved.end(), forbidden);
+    numForbidden = -1;
+}
+
 void getForbiddenGRFs(
     std::vector<unsigned int>& regNum, G4_Kernel &kernel,
     unsigned stackCallRegSize, unsigned reserveSpillSize, unsigned rerservedRegNum)
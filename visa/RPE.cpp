@@ -20,6 +20,26 @@ namespace vISA
         options = g.kernel.getOptions();
     }
 
+    StandaloneRPE::StandaloneRPE(G4_Kernel& kernel, unsigned char kind)
+    {
+        p2a = new PointsToAnalysis(kernel.Declares, kernel.fg.getNumBB());
+        p2a->doPointsToAnalysis(kernel.fg);
+        gra = new GlobalRA(kernel, kernel.fg.builder->phyregpool, *p2a);
+        // To properly track liveness for partially-written local variables.
+        gra->markGraphBlockLocalVars();
+        liveness = new LivenessAnalysis(*gra, kind);
+        liveness->computeLiveness();
+        rpe = new RPE(*gra, liveness);
+    }
+
+    StandaloneRPE::~StandaloneRPE()
+    {
+        delete rpe;
+        delete liveness;
+        delete gra;
+        delete p2a;
+    }
+
     void RPE::run()
     {
         TIME_SCOPE(RPE);
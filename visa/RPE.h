@@ -61,5 +61,26 @@ namespace vISA
         void updateRegisterPressure(unsigned int, unsigned int, unsigned int);
         void updateLiveness(SparseBitSet&, uint32_t, bool);
     };
+
+    // Builds the points-to analysis, GlobalRA and liveness that RPE needs
+    // when it is used outside of RA, and owns them.
+    class StandaloneRPE
+    {
+    public:
+        StandaloneRPE(G4_Kernel& kernel, unsigned char kind);
+        ~StandaloneRPE();
+
+        StandaloneRPE(const StandaloneRPE&) = delete;
+        StandaloneRPE& operator=(const StandaloneRPE&) = delete;
+
+        RPE* getRPE() const { return rpe; }
+        LivenessAnalysis* getLiveness() const { return liveness; }
+
+    private:
+        PointsToAnalysis* p2a = nullptr;
+        GlobalRA* gra = nullptr;
+        LivenessAnalysis* liveness = nullptr;
+        RPE* rpe = nullptr;
+    };
 }
 #endif
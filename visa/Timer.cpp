@@ -12,6 +12,7 @@ SPDX-License-Identifier: MIT
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <cstring>
 #ifdef _WIN32
 #include "Windows.h"
 #endif
@@ -24,8 +25,8 @@ static const char* timerNames[static_cast<int>(TimerID::NUM_TIMERS)] =
     #include "TimerDefs.h"
 };
 
-#ifdef MEASURE_COMPILATION_TIME
-
+// The counter is also used by the per-pass stats, which don't depend on
+// MEASURE_COMPILATION_TIME.
 #define CLOCK_TYPE CLOCK_MONOTONIC
 
 #if   !defined(_WIN32)
@@ -74,7 +75,6 @@ static const char* timerNames[static_cast<int>(TimerID::NUM_TIMERS)] =
     }
 
 #endif
-#endif // MEASURE_COMPILATION_TIME
 
 
 struct Timer {
@@ -90,8 +90,19 @@ static _THREAD Timer timers[static_cast<int>(TimerID::NUM_TIMERS)];
 static _THREAD LARGE_INTEGER proc_freq;
 static _THREAD int numTimers = static_cast<int>(TimerID::NUM_TIMERS);
 
+struct PassStat {
+    const char* name;
+    LONGLONG ticks;
+    unsigned int hits;
+    int64_t instDelta;
+};
+
+static _THREAD PassStat passStats[MAX_PASS_STATS];
+static _THREAD unsigned int numPassStats = 0;
+
 void initTimer() {
 
+    numPassStats = 0;
 #ifdef MEASURE_COMPILATION_TIME
     numTimers = 0;
     for (int i = 0; i < static_cast<int>(TimerID::NUM_TIMERS); i++)
@@ -128,6 +139,7 @@ void resetPerKernel()
         timers[i].started = false;
         timers[i].hits = 0;
     }
+    numPassStats = 0;
 }
 
 int createNewTimer(const char* name)
@@ -193,6 +205,57 @@ void stopTimer(TimerID timerId)
 #endif
 }
 
+int64_t getTimestamp()
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+void recordPassStat(const char* passName, int64_t ticks, int64_t instDelta)
+{
+    for (unsigned int i = 0; i < numPassStats; i++)
+    {
+        if (strcmp(passStats[i].name, passName) == 0)
+        {
+            passStats[i].ticks += ticks;
+            passStats[i].hits++;
+            passStats[i].instDelta += instDelta;
+            return;
+        }
+    }
+    assert(numPassStats < MAX_PASS_STATS && "too many passes for passStats");
+    if (numPassStats < MAX_PASS_STATS)
+    {
+        passStats[numPassStats++] = { passName, ticks, 1, instDelta };
+    }
+}
+
+extern "C" unsigned int getTotalPassStats()
+{
+    return numPassStats;
+}
+
+extern "C" const char* getPassStatName(unsigned int idx)
+{
+    return passStats[idx].name;
+}
+
+extern "C" int64_t getPassStatTicks(unsigned int idx)
+{
+    return passStats[idx].ticks;
+}
+
+extern "C" unsigned int getPassStatHits(unsigned int idx)
+{
+    return passStats[idx].hits;
+}
+
+extern "C" int64_t getPassStatInstDelta(unsigned int idx)
+{
+    return passStats[idx].instDelta;
+}
+
 extern "C" unsigned int getTotalTimers()
 {
     return numTimers;
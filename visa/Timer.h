@@ -46,6 +46,16 @@ void dumpEncoderStats(Options *opt, std::string &asmName);
 void resetPerKernel();
 // double getTimerUS(unsigned idx);
 
+// Per-pass statistics for the vISA optimizer, keyed by pass name and recorded
+// with -perPassStats.
+// getTimestamp() returns ticks in the same unit as the timers above. Unlike
+// the timers, it and the stats don't depend on MEASURE_COMPILATION_TIME, so
+// they also work in release builds. The stats are reset by initTimer() when
+// a builder is created, and read through getPassStat*().
+#define MAX_PASS_STATS 128
+int64_t getTimestamp();
+void recordPassStat(const char *passName, int64_t ticks, int64_t instDelta);
+
 
 struct TimerScope {
     const TimerID timerId;
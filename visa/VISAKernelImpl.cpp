@@ -606,6 +606,7 @@ void VISAKernelImpl::initCompilerStats()
     m_compilerStats.Init(CompilerStats::numGRFFillStr(), CompilerStats::type_int64);
     m_compilerStats.Init(CompilerStats::numSendStr(), CompilerStats::type_int64);
     m_compilerStats.Init(CompilerStats::numCyclesStr(), CompilerStats::type_int64);
+    m_compilerStats.Init(CompilerStats::numPayloadHoistStr(), CompilerStats::type_int64);
 #if COMPILER_STATS_ENABLE
     m_compilerStats.Init("PreRASchedulerForPressure", CompilerStats::type_bool);
     m_compilerStats.Init("PreRASchedulerForLatency", CompilerStats::type_bool);
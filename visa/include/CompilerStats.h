@@ -93,6 +93,7 @@ public:
     static constexpr const char* numGRFSpillStr() { return "NumGRFSpill"; };
     static constexpr const char* numGRFFillStr() { return "NumGRFFill"; };
     static constexpr const char* numCyclesStr() { return "NumCycles"; };
+    static constexpr const char* numPayloadHoistStr() { return "NumPayloadInstHoisted"; };
 
 
     // Statistic collection is disabled by default.
@@ -0,0 +1,101 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Test for global value numbering (-gvn). Each kernel computes in + 5
+// twice in different blocks; GVN may only remove the second computation
+// when the first one dominates it and reads the same values.
+
+#include "KernelBuilder.h"
+
+// x = in + 5; if (in[0] < 10) { y = in + 5; store(0, y) } store(0, x)
+// The entry block dominates the block computing y, so y is replaced by x.
+static void buildDominated(KernelBuilder& b)
+{
+    VISA_GenVar* in = b.input("in", 8, 32);
+    VISA_GenVar* zero = b.var("zero", 1, ALIGN_DWORD);
+    VISA_GenVar* x = b.var("x", 8, ALIGN_GRF);
+    VISA_GenVar* y = b.var("y", 8, ALIGN_GRF);
+    VISA_LabelOpnd* skip = b.label("skip");
+
+    b.mov(zero, 0, EXEC_SIZE_1);
+    b.arith(ISA_ADD, b.dst(x), b.vector(in), b.imm(5), EXEC_SIZE_8);
+    b.jmp(skip, b.cmpLess(in, 10, "p"));
+    b.arith(ISA_ADD, b.dst(y), b.vector(in), b.imm(5), EXEC_SIZE_8);
+    b.oword(ISA_OWORD_ST, zero, y);
+    b.place(skip);
+    b.oword(ISA_OWORD_ST, zero, x);
+    b.ret();
+}
+
+// if (in[0] < 10) { x = in + 5; store(0, x) } else { y = in + 5; store(0, y) }
+// Neither branch dominates the other, so both adds stay.
+static void buildSiblings(KernelBuilder& b)
+{
+    VISA_GenVar* in = b.input("in", 8, 32);
+    VISA_GenVar* zero = b.var("zero", 1, ALIGN_DWORD);
+    VISA_GenVar* x = b.var("x", 8, ALIGN_GRF);
+    VISA_GenVar* y = b.var("y", 8, ALIGN_GRF);
+    VISA_LabelOpnd* other = b.label("other");
+    VISA_LabelOpnd* end = b.label("end");
+
+    b.mov(zero, 0, EXEC_SIZE_1);
+    b.jmp(other, b.cmpLess(in, 10, "p"));
+    b.arith(ISA_ADD, b.dst(x), b.vector(in), b.imm(5), EXEC_SIZE_8);
+    b.oword(ISA_OWORD_ST, zero, x);
+    b.jmp(end);
+    b.place(other);
+    b.arith(ISA_ADD, b.dst(y), b.vector(in), b.imm(5), EXEC_SIZE_8);
+    b.oword(ISA_OWORD_ST, zero, y);
+    b.place(end);
+    b.ret();
+}
+
+// a = in + 1; x = a + 5; a = a * 3; if (in[0] < 10) { y = a + 5; store(0, y) }
+// store(0, x)
+// a is redefined between the two adds, so y is not the value of x.
+static void buildRedefined(KernelBuilder& b)
+{
+    VISA_GenVar* in = b.input("in", 8, 32);
+    VISA_GenVar* zero = b.var("zero", 1, ALIGN_DWORD);
+    VISA_GenVar* a = b.var("a", 8, ALIGN_GRF);
+    VISA_GenVar* x = b.var("x", 8, ALIGN_GRF);
+    VISA_GenVar* y = b.var("y", 8, ALIGN_GRF);
+    VISA_LabelOpnd* skip = b.label("skip");
+
+    b.mov(zero, 0, EXEC_SIZE_1);
+    b.arith(ISA_ADD, b.dst(a), b.vector(in), b.imm(1), EXEC_SIZE_8);
+    b.arith(ISA_ADD, b.dst(x), b.vector(a), b.imm(5), EXEC_SIZE_8);
+    b.arith(ISA_MUL, b.dst(a), b.vector(a), b.imm(3), EXEC_SIZE_8);
+    b.jmp(skip, b.cmpLess(in, 10, "p"));
+    b.arith(ISA_ADD, b.dst(y), b.vector(a), b.imm(5), EXEC_SIZE_8);
+    b.oword(ISA_OWORD_ST, zero, y);
+    b.place(skip);
+    b.oword(ISA_OWORD_ST, zero, x);
+    b.ret();
+}
+
+// Instruction count change of GVN on the kernel made by build.
+static int64_t gvnInstDelta(const char* name, void (*build)(KernelBuilder&))
+{
+    CHECK_VISA(compileKernel(GENX_SKL, { "-gvn", "-perPassStats" }, build));
+    int64_t delta = passInstDelta("GVN");
+    printf("%s: GVN instruction delta %lld\n", name, (long long)delta);
+    return delta;
+}
+
+int main()
+{
+    check(gvnInstDelta("dominated", buildDominated) == -1,
+        "dominated: the add in the dominated block is removed");
+    check(gvnInstDelta("siblings", buildSiblings) == 0,
+        "siblings: neither branch is replaced by the other");
+    check(gvnInstDelta("redefined", buildRedefined) == 0,
+        "redefined: a value read after a redefinition is kept");
+
+    return reportResult();
+}
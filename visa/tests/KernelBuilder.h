@@ -0,0 +1,300 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Helpers shared by the vISA tests: error checking, a thin wrapper around
+// the builder API to write kernels in a few lines, and a driver that
+// compiles a kernel and hands back its compiler stats.
+
+#ifndef VISA_TESTS_KERNELBUILDER_H
+#define VISA_TESTS_KERNELBUILDER_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "visaBuilder_interface.h"
+#include "CompilerStats.h"
+
+static unsigned g_numErrors = 0;
+
+#define CHECK_VISA(x)                                                   \
+    do {                                                                \
+        if ((x) != 0) {                                                 \
+            fprintf(stderr, "%s:%d: %s failed\n", __FILE__, __LINE__, #x); \
+            exit(1);                                                    \
+        }                                                               \
+    } while (0)
+
+static void check(bool cond, const char* what)
+{
+    if (!cond)
+    {
+        fprintf(stderr, "FAIL: %s\n", what);
+        ++g_numErrors;
+    }
+}
+
+static int reportResult()
+{
+    if (g_numErrors)
+    {
+        fprintf(stderr, "%u check(s) failed\n", g_numErrors);
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
+
+// A variable of numGRFs registers loaded at step def and stored at step
+// kill, for KernelBuilder::ranges.
+struct Range
+{
+    unsigned numGRFs;
+    unsigned def;
+    unsigned kill;
+};
+
+struct KernelBuilder
+{
+    VISAKernel* k;
+    VISA_SurfaceVar* surf = nullptr;
+    // Storage for generated variable names.
+    std::list<std::string> names;
+
+    explicit KernelBuilder(VISAKernel* kernel) : k(kernel)
+    {
+        CHECK_VISA(k->GetPredefinedSurface(surf, PREDEFINED_SURFACE_T255));
+    }
+
+    VISA_GenVar* var(const char* name, int numElts, VISA_Align align)
+    {
+        VISA_GenVar* v = nullptr;
+        CHECK_VISA(k->CreateVISAGenVar(v, name, numElts, ISA_TYPE_UD, align));
+        return v;
+    }
+
+    // An input of numElts dwords passed in the GRFs at byte offset.
+    VISA_GenVar* input(const char* name, int numElts, unsigned short offset)
+    {
+        VISA_GenVar* v = var(name, numElts, ALIGN_GRF);
+        CHECK_VISA(k->CreateVISAInputVar(v, offset, (unsigned short)(numElts * 4)));
+        return v;
+    }
+
+    VISA_LabelOpnd* label(const char* name)
+    {
+        VISA_LabelOpnd* l = nullptr;
+        CHECK_VISA(k->CreateVISALabelVar(l, name, LABEL_BLOCK));
+        return l;
+    }
+
+    VISA_PredOpnd* pred(VISA_PredVar* p)
+    {
+        VISA_PredOpnd* opnd = nullptr;
+        CHECK_VISA(k->CreateVISAPredicateOperand(opnd, p, PredState_NO_INVERSE, PRED_CTRL_NON));
+        return opnd;
+    }
+
+    // Operands on element elt of v, counted in dwords.
+    VISA_VectorOpnd* dst(VISA_GenVar* v, unsigned elt = 0)
+    {
+        VISA_VectorOpnd* opnd = nullptr;
+        CHECK_VISA(k->CreateVISADstOperand(opnd, v, 1, elt / 8, elt % 8));
+        return opnd;
+    }
+
+    VISA_VectorOpnd* scalar(VISA_GenVar* v, unsigned elt = 0)
+    {
+        VISA_VectorOpnd* opnd = nullptr;
+        CHECK_VISA(k->CreateVISASrcOperand(opnd, v, MODIFIER_NONE, 0, 1, 0, elt / 8, elt % 8));
+        return opnd;
+    }
+
+    VISA_VectorOpnd* vector(VISA_GenVar* v, unsigned elt = 0)
+    {
+        VISA_VectorOpnd* opnd = nullptr;
+        CHECK_VISA(k->CreateVISASrcOperand(opnd, v, MODIFIER_NONE, 8, 8, 1, elt / 8, elt % 8));
+        return opnd;
+    }
+
+    VISA_VectorOpnd* imm(unsigned val)
+    {
+        VISA_VectorOpnd* opnd = nullptr;
+        CHECK_VISA(k->CreateVISAImmediate(opnd, &val, ISA_TYPE_UD));
+        return opnd;
+    }
+
+    void mov(VISA_GenVar* d, unsigned val, VISA_Exec_Size size)
+    {
+        CHECK_VISA(k->AppendVISADataMovementInst(ISA_MOV, nullptr, false,
+            vISA_EMASK_M1_NM, size, dst(d), imm(val)));
+    }
+
+    void mov(VISA_VectorOpnd* d, VISA_VectorOpnd* s, VISA_Exec_Size size)
+    {
+        CHECK_VISA(k->AppendVISADataMovementInst(ISA_MOV, nullptr, false,
+            vISA_EMASK_M1_NM, size, d, s));
+    }
+
+    void arith(ISA_Opcode op, VISA_VectorOpnd* d, VISA_VectorOpnd* s0,
+        VISA_VectorOpnd* s1, VISA_Exec_Size size, VISA_PredOpnd* p = nullptr)
+    {
+        CHECK_VISA(k->AppendVISAArithmeticInst(op, p, false,
+            vISA_EMASK_M1_NM, size, d, s0, s1));
+    }
+
+    void arith(ISA_Opcode op, VISA_VectorOpnd* d, VISA_VectorOpnd* s0,
+        VISA_VectorOpnd* s1, VISA_VectorOpnd* s2, VISA_Exec_Size size)
+    {
+        CHECK_VISA(k->AppendVISAArithmeticInst(op, nullptr, false,
+            vISA_EMASK_M1_NM, size, d, s0, s1, s2));
+    }
+
+    void oword(ISA_Opcode op, VISA_GenVar* offset, VISA_GenVar* data)
+    {
+        VISA_StateOpndHandle* s = nullptr;
+        CHECK_VISA(k->CreateVISAStateOperandHandle(s, surf));
+        VISA_RawOpnd* raw = nullptr;
+        CHECK_VISA(k->CreateVISARawOperand(raw, data, 0));
+        CHECK_VISA(k->AppendVISASurfAccessOwordLoadStoreInst(op, vISA_EMASK_M1_NM,
+            s, OWORD_NUM_2, scalar(offset), raw));
+    }
+
+    // Straight-line code over numSteps steps that keeps each of ranges live
+    // from its def to its kill. At every step the ranges killed there are
+    // stored, then the ones defined there are loaded, one OWord block
+    // message each.
+    void ranges(const std::vector<Range>& ranges, unsigned numSteps)
+    {
+        VISA_GenVar* zero = var("zero", 1, ALIGN_DWORD);
+        mov(zero, 0, EXEC_SIZE_1);
+
+        std::vector<VISA_GenVar*> vars;
+        for (unsigned i = 0; i < ranges.size(); ++i)
+        {
+            names.push_back("v" + std::to_string(i));
+            vars.push_back(var(names.back().c_str(), 8 * ranges[i].numGRFs, ALIGN_GRF));
+        }
+
+        // 2 OWords per GRF
+        auto access = [&](ISA_Opcode op, unsigned i)
+        {
+            VISA_Oword_Num size = ranges[i].numGRFs == 1 ? OWORD_NUM_2 :
+                ranges[i].numGRFs == 2 ? OWORD_NUM_4 : OWORD_NUM_8;
+            VISA_StateOpndHandle* s = nullptr;
+            CHECK_VISA(k->CreateVISAStateOperandHandle(s, surf));
+            VISA_RawOpnd* raw = nullptr;
+            CHECK_VISA(k->CreateVISARawOperand(raw, vars[i], 0));
+            CHECK_VISA(k->AppendVISASurfAccessOwordLoadStoreInst(op, vISA_EMASK_M1_NM,
+                s, size, scalar(zero), raw));
+        };
+
+        for (unsigned step = 0; step <= numSteps; ++step)
+        {
+            for (unsigned i = 0; i < ranges.size(); ++i)
+            {
+                if (ranges[i].kill == step)
+                {
+                    access(ISA_OWORD_ST, i);
+                }
+            }
+            for (unsigned i = 0; i < ranges.size(); ++i)
+            {
+                if (ranges[i].def == step)
+                {
+                    access(ISA_OWORD_LD, i);
+                }
+            }
+        }
+    }
+
+    // sum += data
+    void accumulate(VISA_GenVar* sum, VISA_GenVar* data)
+    {
+        arith(ISA_ADD, dst(sum), vector(sum), vector(data), EXEC_SIZE_8);
+    }
+
+    // p = a < n
+    VISA_PredVar* cmpLess(VISA_GenVar* a, unsigned n, const char* predName)
+    {
+        VISA_PredVar* p = nullptr;
+        CHECK_VISA(k->CreateVISAPredVar(p, predName, 1));
+        CHECK_VISA(k->AppendVISAComparisonInst(ISA_CMP_L, vISA_EMASK_M1_NM,
+            EXEC_SIZE_1, p, scalar(a), imm(n)));
+        return p;
+    }
+
+    // i += 1; if (i < n) goto loop
+    void latch(VISA_GenVar* i, unsigned n, VISA_LabelOpnd* loop, const char* predName)
+    {
+        arith(ISA_ADD, dst(i), scalar(i), imm(1), EXEC_SIZE_1);
+        jmp(loop, cmpLess(i, n, predName));
+    }
+
+    void place(VISA_LabelOpnd* l)
+    {
+        CHECK_VISA(k->AppendVISACFLabelInst(l));
+    }
+
+    // goto l, if p is given only when it is set
+    void jmp(VISA_LabelOpnd* l, VISA_PredVar* p = nullptr)
+    {
+        CHECK_VISA(k->AppendVISACFJmpInst(p ? pred(p) : nullptr, l));
+    }
+
+    void ret()
+    {
+        CHECK_VISA(k->AppendVISACFRetInst(nullptr, vISA_EMASK_M1_NM, EXEC_SIZE_1));
+    }
+};
+
+// Compiles the kernel made by build for platform with the given options.
+// Returns what VISABuilder::Compile returns; when stats is not null, the
+// kernel's compiler stats are copied to it.
+static int compileKernel(TARGET_PLATFORM platform, std::vector<const char*> flags,
+    void (*build)(KernelBuilder&), CompilerStats* stats = nullptr)
+{
+    WA_TABLE waTable = {};
+    VISABuilder* builder = nullptr;
+    CHECK_VISA(CreateVISABuilder(builder, vISA_DEFAULT, VISA_BUILDER_GEN, platform,
+        (int)flags.size(), flags.data(), &waTable));
+    VISAKernel* kernel = nullptr;
+    CHECK_VISA(builder->AddKernel(kernel, "test"));
+    KernelBuilder b(kernel);
+    build(b);
+    int result = builder->Compile("");
+    if (stats)
+    {
+        CHECK_VISA(kernel->GetCompilerStats(*stats));
+    }
+    CHECK_VISA(DestroyVISABuilder(builder));
+    return result;
+}
+
+extern "C" unsigned int getTotalPassStats();
+extern "C" const char* getPassStatName(unsigned int idx);
+extern "C" int64_t getPassStatInstDelta(unsigned int idx);
+
+// Instruction count change of the given pass in the last compile with
+// -perPassStats; 0 if the pass did not run.
+static int64_t passInstDelta(const char* passName)
+{
+    for (unsigned i = 0; i < getTotalPassStats(); ++i)
+    {
+        if (strcmp(getPassStatName(i), passName) == 0)
+        {
+            return getPassStatInstDelta(i);
+        }
+    }
+    return 0;
+}
+
+#endif // VISA_TESTS_KERNELBUILDER_H
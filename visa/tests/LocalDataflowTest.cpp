@@ -0,0 +1,116 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Test for the passes that keep the def-use chains up to date instead of
+// having them recomputed: copy propagation, instruction combining, merge
+// scalars, LVN and acc substitution. The kernels give each pass something
+// to change, and -verifyDefUse fails the compile if the chains left by a
+// pass don't match a fresh computation.
+
+#include "KernelBuilder.h"
+
+// data = load(0); t = data; data = t + 1; store(0, data)
+// Copy propagation removes the copy to t.
+static void buildCopy(KernelBuilder& b)
+{
+    VISA_GenVar* zero = b.var("zero", 1, ALIGN_DWORD);
+    VISA_GenVar* data = b.var("data", 8, ALIGN_GRF);
+    VISA_GenVar* t = b.var("t", 8, ALIGN_GRF);
+
+    b.mov(zero, 0, EXEC_SIZE_1);
+    b.oword(ISA_OWORD_LD, zero, data);
+    b.mov(b.dst(t), b.vector(data), EXEC_SIZE_8);
+    b.arith(ISA_ADD, b.dst(data), b.vector(t), b.imm(1), EXEC_SIZE_8);
+    b.oword(ISA_OWORD_ST, zero, data);
+    b.ret();
+}
+
+// data = load(0); sum[i] = data[i] + 1 for i < 4, one scalar add each;
+// store(0, sum)
+// Merge scalars turns the four adds into one SIMD4 add.
+static void buildScalars(KernelBuilder& b)
+{
+    VISA_GenVar* zero = b.var("zero", 1, ALIGN_DWORD);
+    VISA_GenVar* data = b.var("data", 8, ALIGN_GRF);
+    VISA_GenVar* sum = b.var("sum", 8, ALIGN_GRF);
+
+    b.mov(zero, 0, EXEC_SIZE_1);
+    b.oword(ISA_OWORD_LD, zero, data);
+    b.mov(sum, 0, EXEC_SIZE_8);
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        b.arith(ISA_ADD, b.dst(sum, i), b.scalar(data, i), b.imm(1), EXEC_SIZE_1);
+    }
+    b.oword(ISA_OWORD_ST, zero, sum);
+    b.ret();
+}
+
+// data = load(0); x = data << 3; y = data << 3; store(0, x + y)
+// LVN removes the second shift and has the add read x twice.
+static void buildShifts(KernelBuilder& b)
+{
+    VISA_GenVar* zero = b.var("zero", 1, ALIGN_DWORD);
+    VISA_GenVar* data = b.var("data", 8, ALIGN_GRF);
+    VISA_GenVar* x = b.var("x", 8, ALIGN_GRF);
+    VISA_GenVar* y = b.var("y", 8, ALIGN_GRF);
+
+    b.mov(zero, 0, EXEC_SIZE_1);
+    b.oword(ISA_OWORD_LD, zero, data);
+    b.arith(ISA_SHL, b.dst(x), b.vector(data), b.imm(3), EXEC_SIZE_8);
+    b.arith(ISA_SHL, b.dst(y), b.vector(data), b.imm(3), EXEC_SIZE_8);
+    b.arith(ISA_ADD, b.dst(x), b.vector(x), b.vector(y), EXEC_SIZE_8);
+    b.oword(ISA_OWORD_ST, zero, x);
+    b.ret();
+}
+
+// data = load(0); t = data * data; u = t + data; v = u * t; store(0, v)
+// The short-lived temporaries are acc substitution candidates.
+static void buildTemporaries(KernelBuilder& b)
+{
+    VISA_GenVar* zero = b.var("zero", 1, ALIGN_DWORD);
+    VISA_GenVar* data = b.var("data", 8, ALIGN_GRF);
+    VISA_GenVar* t = b.var("t", 8, ALIGN_GRF);
+    VISA_GenVar* u = b.var("u", 8, ALIGN_GRF);
+    VISA_GenVar* v = b.var("v", 8, ALIGN_GRF);
+
+    b.mov(zero, 0, EXEC_SIZE_1);
+    b.oword(ISA_OWORD_LD, zero, data);
+    b.arith(ISA_MUL, b.dst(t), b.vector(data), b.vector(data), EXEC_SIZE_8);
+    b.arith(ISA_ADD, b.dst(u), b.vector(t), b.vector(data), EXEC_SIZE_8);
+    b.arith(ISA_MUL, b.dst(v), b.vector(u), b.vector(t), EXEC_SIZE_8);
+    b.oword(ISA_OWORD_ST, zero, v);
+    b.ret();
+}
+
+static bool compileVerified(TARGET_PLATFORM platform, void (*build)(KernelBuilder&))
+{
+    return compileKernel(platform, { "-verifyDefUse", "-perPassStats" }, build) == 0;
+}
+
+int main()
+{
+    check(compileVerified(GENX_SKL, buildCopy), "copy: def-use verified");
+    check(passInstDelta("localCopyPropagation") < 0, "copy: copy propagation removes the copy");
+
+    check(compileVerified(GENX_SKL, buildScalars), "scalars: def-use verified");
+    check(passInstDelta("mergeScalarInst") < 0, "scalars: merge scalars merges the adds");
+
+    check(compileVerified(GENX_SKL, buildShifts), "shifts: def-use verified");
+    check(passInstDelta("LVN") < 0, "shifts: LVN removes the repeated shift");
+
+    // Acc substitution needs Gen11 or later.
+    check(compileVerified(GENX_ICLLP, buildTemporaries), "temporaries: def-use verified");
+    check(compileVerified(GENX_TGLLP, buildTemporaries), "temporaries: def-use verified on TGL");
+
+    // Every kernel again on a platform with different HW conformity rules.
+    check(compileVerified(GENX_TGLLP, buildCopy), "copy: def-use verified on TGL");
+    check(compileVerified(GENX_TGLLP, buildScalars), "scalars: def-use verified on TGL");
+    check(compileVerified(GENX_TGLLP, buildShifts), "shifts: def-use verified on TGL");
+
+    return reportResult();
+}
@@ -0,0 +1,87 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Test for the message payload hoisting pass. Builds CM kernels that issue
+// oword block reads and writes in a loop, and checks through the compiler
+// stats that the invariant header setup is hoisted, and that nothing is
+// hoisted with -noPayloadHoist.
+
+#include "KernelBuilder.h"
+
+// for (i = 0; i < 64; i++) { data = load(i); sum += data; store(i, sum); }
+static void buildLoop(KernelBuilder& b)
+{
+    VISA_GenVar* i = b.var("i", 1, ALIGN_DWORD);
+    VISA_GenVar* data = b.var("data", 8, ALIGN_GRF);
+    VISA_GenVar* sum = b.var("sum", 8, ALIGN_GRF);
+    VISA_LabelOpnd* loop = b.label("LOOP");
+
+    b.mov(i, 0, EXEC_SIZE_1);
+    b.mov(sum, 0, EXEC_SIZE_8);
+    CHECK_VISA(b.k->AppendVISACFLabelInst(loop));
+    b.oword(ISA_OWORD_LD, i, data);
+    b.accumulate(sum, data);
+    b.oword(ISA_OWORD_ST, i, sum);
+    b.latch(i, 64, loop, "p");
+    b.ret();
+}
+
+// The same loop nested in an outer loop that stores the sum once per
+// iteration, so the inner preheader is part of the outer loop.
+static void buildNestedLoop(KernelBuilder& b)
+{
+    VISA_GenVar* i = b.var("i", 1, ALIGN_DWORD);
+    VISA_GenVar* j = b.var("j", 1, ALIGN_DWORD);
+    VISA_GenVar* data = b.var("data", 8, ALIGN_GRF);
+    VISA_GenVar* sum = b.var("sum", 8, ALIGN_GRF);
+    VISA_LabelOpnd* outer = b.label("OUTER");
+    VISA_LabelOpnd* inner = b.label("INNER");
+
+    b.mov(j, 0, EXEC_SIZE_1);
+    b.mov(sum, 0, EXEC_SIZE_8);
+    CHECK_VISA(b.k->AppendVISACFLabelInst(outer));
+    b.mov(i, 0, EXEC_SIZE_1);
+    CHECK_VISA(b.k->AppendVISACFLabelInst(inner));
+    b.oword(ISA_OWORD_LD, i, data);
+    b.accumulate(sum, data);
+    b.latch(i, 64, inner, "p");
+    b.oword(ISA_OWORD_ST, j, sum);
+    b.latch(j, 16, outer, "q");
+    b.ret();
+}
+
+// Compiles the kernel made by build and returns the number of instructions
+// the pass hoisted.
+static int64_t compile(void (*build)(KernelBuilder&), bool disableHoisting)
+{
+    std::vector<const char*> flags = { "-compilerStats" };
+    if (disableHoisting)
+    {
+        flags.push_back("-noPayloadHoist");
+    }
+
+    CompilerStats stats;
+    CHECK_VISA(compileKernel(GENX_SKL, flags, build, &stats));
+    // Stats are kept per SIMD size; these kernels are compiled as SIMD8.
+    return stats.GetI64(CompilerStats::numPayloadHoistStr(), 8);
+}
+
+int main()
+{
+    // The per-iteration header setup of both sends (the FFTID field copied
+    // from r0) leaves the loop; the offset field varies and stays.
+    check(compile(buildLoop, false) == 2, "loop: header setup of both sends is hoisted");
+    check(compile(buildLoop, true) == 0, "loop: -noPayloadHoist hoists nothing");
+
+    // The inner loop's header setup moves to its preheader, and the outer
+    // loop's send still gets its own hoisted.
+    check(compile(buildNestedLoop, false) == 2, "nested loop: header setup of both loops is hoisted");
+    check(compile(buildNestedLoop, true) == 0, "nested loop: -noPayloadHoist hoists nothing");
+
+    return reportResult();
+}
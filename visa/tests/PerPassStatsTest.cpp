@@ -0,0 +1,77 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Test for the per-pass stats of the vISA optimizer (-perPassStats). They
+// must be recorded in every build type, since compile telemetry reads them
+// in release drivers.
+
+#include <string>
+
+#include "KernelBuilder.h"
+
+extern "C" int64_t getPassStatTicks(unsigned int idx);
+extern "C" unsigned int getPassStatHits(unsigned int idx);
+
+// data = load(0); t = data; data = t + 1; store(0, data)
+// Copy propagation removes the copy to t.
+static void buildCopy(KernelBuilder& b)
+{
+    VISA_GenVar* zero = b.var("zero", 1, ALIGN_DWORD);
+    VISA_GenVar* data = b.var("data", 8, ALIGN_GRF);
+    VISA_GenVar* t = b.var("t", 8, ALIGN_GRF);
+
+    b.mov(zero, 0, EXEC_SIZE_1);
+    b.oword(ISA_OWORD_LD, zero, data);
+    b.mov(b.dst(t), b.vector(data), EXEC_SIZE_8);
+    b.arith(ISA_ADD, b.dst(data), b.vector(t), b.imm(1), EXEC_SIZE_8);
+    b.oword(ISA_OWORD_ST, zero, data);
+    b.ret();
+}
+
+static int findPassStat(const char* name)
+{
+    for (unsigned i = 0; i < getTotalPassStats(); ++i)
+    {
+        if (strcmp(getPassStatName(i), name) == 0)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+int main()
+{
+    CHECK_VISA(compileKernel(GENX_SKL, { "-perPassStats" }, buildCopy));
+
+    int64_t totalTicks = 0;
+    for (unsigned i = 0; i < getTotalPassStats(); ++i)
+    {
+        totalTicks += getPassStatTicks(i);
+    }
+    check(totalTicks > 0, "passes are timed");
+
+    int copyProp = findPassStat("localCopyPropagation");
+    check(copyProp >= 0 && getPassStatHits(copyProp) == 1, "copy propagation runs once");
+    check(copyProp >= 0 && getPassStatInstDelta(copyProp) == -1,
+        "copy propagation removes one instruction");
+    check(findPassStat("GVN") < 0, "passes that are off are not recorded");
+
+    // Stats are per builder, not accumulated over the thread's lifetime.
+    unsigned numStats = getTotalPassStats();
+    CHECK_VISA(compileKernel(GENX_SKL, { "-perPassStats" }, buildCopy));
+    check(getTotalPassStats() == numStats, "a new builder resets the stats");
+    copyProp = findPassStat("localCopyPropagation");
+    check(copyProp >= 0 && getPassStatHits(copyProp) == 1, "hits are not carried over");
+
+    // Nothing is recorded without the option.
+    CHECK_VISA(compileKernel(GENX_SKL, {}, buildCopy));
+    check(getTotalPassStats() == 0, "no stats without -perPassStats");
+
+    return reportResult();
+}
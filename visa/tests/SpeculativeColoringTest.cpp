@@ -0,0 +1,49 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Test for speculative graph coloring (-speculativeColoring). The kernel
+// keeps 1, 2 and 4 GRF ranges live in a 32 GRF file, which the default
+// first-fit order fragments so that one range spills. Coloring the largest
+// ranges first finds a spill-free assignment on the same interference
+// graph.
+
+#include "KernelBuilder.h"
+
+static void buildRanges(KernelBuilder& b)
+{
+    b.ranges({
+        { 2, 15, 16 }, { 2, 10, 15 }, { 4, 14, 16 }, { 2, 12, 16 },
+        { 2, 10, 12 }, { 2, 15, 16 }, { 1, 1, 4 }, { 2, 9, 16 },
+        { 4, 11, 14 }, { 4, 9, 16 }, { 4, 11, 16 }, { 4, 4, 12 },
+        { 4, 1, 5 }, { 2, 0, 6 }, { 2, 9, 14 }, { 2, 1, 2 },
+        { 2, 9, 15 }, { 2, 13, 16 }, { 4, 4, 7 }, { 1, 12, 14 },
+        { 2, 14, 16 }, { 2, 9, 12 },
+        }, 16);
+    b.ret();
+}
+
+// Number of GRFs spilled when compiling the kernel with the given options
+// on top of global RA only, on a 32 GRF file.
+static int64_t numSpills(std::vector<const char*> flags)
+{
+    std::vector<const char*> allFlags = { "-nolocalra", "-GRFNumToUse", "32", "-compilerStats" };
+    allFlags.insert(allFlags.end(), flags.begin(), flags.end());
+
+    CompilerStats stats;
+    CHECK_VISA(compileKernel(GENX_SKL, allFlags, buildRanges, &stats));
+    return stats.GetI64(CompilerStats::numGRFSpillStr(), 8);
+}
+
+int main()
+{
+    check(numSpills({}) > 0, "default coloring spills");
+    check(numSpills({ "-speculativeColoring" }) == 0,
+        "speculative coloring finds a spill-free assignment");
+
+    return reportResult();
+}
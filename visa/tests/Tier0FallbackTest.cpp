@@ -0,0 +1,118 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// Test for the tier-0 fast compile (-fastCompileTier0) falling back to
+// graph coloring when linear scan RA runs out of spill iterations. Linear
+// scan is given a single iteration on a 28 GRF file, so it spills one
+// range and gives up; graph coloring then spills another one. The spill
+// slots graph coloring hands out must start after the ones linear scan
+// already used, so no two spilled variables share scratch space.
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "KernelBuilder.h"
+
+namespace fs = std::filesystem;
+
+static void buildRanges(KernelBuilder& b)
+{
+    b.ranges({
+        { 4, 1, 9 }, { 4, 13, 16 }, { 1, 9, 16 }, { 4, 5, 9 },
+        { 2, 11, 15 }, { 4, 3, 10 }, { 4, 15, 16 }, { 2, 6, 7 },
+        { 4, 0, 3 }, { 4, 15, 16 }, { 1, 7, 14 }, { 2, 3, 8 },
+        { 4, 11, 14 }, { 1, 0, 2 }, { 1, 12, 13 }, { 4, 9, 14 },
+        { 4, 15, 16 }, { 2, 14, 16 }, { 4, 12, 16 }, { 2, 0, 4 },
+        { 2, 1, 7 }, { 4, 15, 16 },
+        }, 16);
+    b.ret();
+}
+
+// Scratch space of a spilled variable, in bytes.
+struct SpillSlot
+{
+    std::string name;
+    unsigned offset;
+    unsigned size;
+};
+
+// Reads the spill slots from the declares in the G4 dump taken after RA,
+//   //.declare v2 rf=r size=32 ... (spilled -> Scratch[2x32])
+static std::vector<SpillSlot> readSpillSlots(const fs::path& dir)
+{
+    std::vector<SpillSlot> slots;
+    for (auto& entry : fs::directory_iterator(dir))
+    {
+        std::string fileName = entry.path().filename().string();
+        if (fileName.find(".after.regAlloc.g4") == std::string::npos)
+        {
+            continue;
+        }
+        std::ifstream dump(entry.path());
+        std::string line;
+        while (std::getline(dump, line))
+        {
+            const std::string spilled = "(spilled -> Scratch[";
+            size_t pos = line.find(spilled);
+            if (line.rfind("//.declare ", 0) != 0 || pos == std::string::npos)
+            {
+                continue;
+            }
+            SpillSlot slot;
+            std::istringstream(line.substr(strlen("//.declare "))) >> slot.name;
+            slot.size = (unsigned)atoi(line.c_str() + line.find(" size=") + strlen(" size="));
+            unsigned numGRFs = 0, grfSize = 0;
+            sscanf(line.c_str() + pos + spilled.size(), "%ux%u", &numGRFs, &grfSize);
+            slot.offset = numGRFs * grfSize;
+            slots.push_back(slot);
+        }
+    }
+    return slots;
+}
+
+int main()
+{
+    // Compile in a scratch directory that takes the G4 dumps.
+    fs::path dumpDir = fs::temp_directory_path() / "visa_tier0_fallback_test";
+    fs::remove_all(dumpDir);
+    fs::create_directories(dumpDir);
+    fs::path cwd = fs::current_path();
+    fs::current_path(dumpDir);
+    int result = compileKernel(GENX_SKL, { "-nolocalra", "-GRFNumToUse", "28",
+        "-fastCompileTier0", "-linearScanMaxIter", "1", "-nospillcompression",
+        "-dumpPassesAll" }, buildRanges);
+    fs::current_path(cwd);
+    std::vector<SpillSlot> slots = readSpillSlots(dumpDir);
+    fs::remove_all(dumpDir);
+
+    check(result == 0, "the kernel compiles after linear scan gives up");
+    check(slots.size() >= 2, "both linear scan and graph coloring spill");
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        for (size_t j = i + 1; j < slots.size(); ++j)
+        {
+            if (slots[i].offset < slots[j].offset + slots[j].size &&
+                slots[j].offset < slots[i].offset + slots[i].size)
+            {
+                fprintf(stderr, "%s at [%u, %u) overlaps %s at [%u, %u)\n",
+                    slots[i].name.c_str(), slots[i].offset, slots[i].offset + slots[i].size,
+                    slots[j].name.c_str(), slots[j].offset, slots[j].offset + slots[j].size);
+                check(false, "spill slots do not overlap");
+            }
+        }
+    }
+
+    // With its default iteration limit linear scan allocates the kernel by
+    // itself.
+    check(compileKernel(GENX_SKL, { "-nolocalra", "-GRFNumToUse", "28",
+        "-fastCompileTier0" }, buildRanges) == 0, "tier0 compiles without the fallback");
+
+    return reportResult();
+}